@@ -0,0 +1,62 @@
+/**
+ * @file alloc_tracker.h
+ * @brief Heap allocation counting per pipeline stage, enabled with TVK_MEDIA_TRACK_ALLOCATIONS
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace tvk_media {
+
+enum class AllocStage {
+    Other,
+    Demux,
+    Codec,
+    Decode,
+    Upload,
+    Effects,
+    Audio,
+    Thumbnail,
+    Interface,
+    Count
+};
+
+struct AllocStats {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+
+class AllocTracker {
+public:
+#if defined(TVK_MEDIA_TRACK_ALLOCATIONS)
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    static AllocStage SetStage(AllocStage stage);
+    static AllocStage GetStage();
+
+    static AllocStats GetStats(AllocStage stage);
+    static AllocStats GetPlaybackStats();
+    static bool IsPlaybackStage(AllocStage stage);
+    static const char* GetStageName(AllocStage stage);
+};
+
+class ScopedAllocStage {
+public:
+    explicit ScopedAllocStage(AllocStage stage)
+        : _previous(AllocTracker::ENABLED ? AllocTracker::SetStage(stage) : AllocStage::Other) {}
+    ~ScopedAllocStage() {
+        if (AllocTracker::ENABLED) AllocTracker::SetStage(_previous);
+    }
+
+    ScopedAllocStage(const ScopedAllocStage&) = delete;
+    ScopedAllocStage& operator=(const ScopedAllocStage&) = delete;
+
+private:
+    AllocStage _previous;
+};
+
+} // namespace tvk_media
@@ -21,6 +21,12 @@ extern "C" {
 
 namespace tvk_media {
 
+class AudioCaptureSink {
+public:
+    virtual ~AudioCaptureSink() = default;
+    virtual void OnAudioBuffer(double startTime, const int16_t* samples, int frames, int channels, int sampleRate) = 0;
+};
+
 class AudioDecoder {
 public:
     AudioDecoder();
@@ -38,13 +44,26 @@ public:
     bool Seek(double timeSeconds);
     
     void Update();
+    void SyncToClock(double clockTime);
     
     void SetVolume(float volume);
+    void SetSpeed(double speed) { _speed = speed; }
+    double GetSpeed() const { return _speed; }
     float GetVolume() const { return _volume; }
+    void SetBufferScale(int scale) { _bufferScale = scale > 0 ? scale : 1; }
+    void SetCaptureSink(AudioCaptureSink* sink);
+    int GetBufferScale() const { return _bufferScale; }
     
     double GetCurrentTime() const { return _currentTime; }
+    double GetPlaybackTime();
+    uint64_t GetUnderrunCount() const { return _underruns; }
+    static int GetOpenALObjectCount();
     double GetDuration() const { return _duration; }
     int GetSampleRate() const { return _sampleRate; }
+    int GetSourceSampleRate() const { return _sourceRate; }
+    const char* GetResamplerName() const { return _resamplerName; }
+    double GetDrift() const { return _drift; }
+    double GetCorrection() const { return _correction; }
     int GetChannels() const { return _channels; }
     bool IsPlaying() const { return _isPlaying; }
     bool HasAudio() const { return _hasAudio; }
@@ -56,12 +75,20 @@ public:
 private:
     static constexpr int NUM_BUFFERS = 4;
     static constexpr int BUFFER_SIZE = 65536;
+    static constexpr double MAX_CORRECTION = 0.005;
+    static constexpr double DRIFT_TOLERANCE = 0.002;
+    static constexpr double DRIFT_SMOOTHING = 0.1;
 
     bool InitOpenAL();
+    bool InitResampler();
+    void ResetDrift();
     void CleanupOpenAL();
+    void ResetSource();
     bool DecodeAudioPacket(std::vector<uint8_t>& outData);
     bool FillBuffer(ALuint buffer);
     void QueueBuffers();
+    void QueueBuffer(ALuint buffer);
+    int GetBufferIndex(ALuint buffer) const;
 
     AVFormatContext* _formatContext;
     AVCodecContext* _codecContext;
@@ -74,15 +101,31 @@ private:
     std::vector<int> _availableAudioStreamIndices;
     std::vector<std::string> _availableAudioStreamNames;
     int _sampleRate;
+    int _sourceRate;
+    int _deviceRate;
+    const char* _resamplerName;
+    double _drift;
+    double _correction;
+    double _speed;
     int _channels;
     double _duration;
     std::atomic<double> _currentTime;
     float _volume;
+    int _bufferScale;
+    std::vector<uint8_t> _bufferData;
+    AudioCaptureSink* _captureSink;
 
     ALCdevice* _alDevice;
     ALCcontext* _alContext;
     ALuint _alSource;
     ALuint _alBuffers[NUM_BUFFERS];
+    double _bufferStart[NUM_BUFFERS];
+    double _bufferCorrection[NUM_BUFFERS];
+    double _bufferRate[NUM_BUFFERS];
+    int _queuedOrder[NUM_BUFFERS];
+    int _queuedHead;
+    int _queuedCount;
+    std::atomic<uint64_t> _underruns;
     
     std::atomic<bool> _isPlaying;
     std::atomic<bool> _hasAudio;
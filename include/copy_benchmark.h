@@ -0,0 +1,31 @@
+/**
+ * @file copy_benchmark.h
+ * @brief Frame copy throughput into cached and write-combined mapped memory
+ */
+
+#pragma once
+
+#include <tinyvk/tinyvk.h>
+#include <cstdint>
+
+namespace tvk_media {
+
+struct CopyBenchmarkResult {
+    const char* memory;
+    const char* method;
+    double gigabytesPerSecond;
+    double millisecondsPerFrame;
+};
+
+struct CopyBenchmarkReport {
+    static constexpr int MAX_RESULTS = 8;
+
+    CopyBenchmarkResult results[MAX_RESULTS];
+    int count = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+bool RunCopyBenchmark(tvk::VulkanContext* context, uint32_t width, uint32_t height, CopyBenchmarkReport& out);
+
+} // namespace tvk_media
@@ -0,0 +1,84 @@
+/**
+ * @file cpu_topology.h
+ * @brief CPU topology discovery from sysfs (hybrid core types, packages, NUMA nodes)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tvk_media {
+
+struct CpuSet {
+    static constexpr int MAX_CPUS = 512;
+
+    uint64_t bits[MAX_CPUS / 64] = {};
+
+    void Set(int cpu) {
+        if (cpu >= 0 && cpu < MAX_CPUS) bits[cpu / 64] |= 1ull << (cpu % 64);
+    }
+
+    void Reset(int cpu) {
+        if (cpu >= 0 && cpu < MAX_CPUS) bits[cpu / 64] &= ~(1ull << (cpu % 64));
+    }
+
+    bool Has(int cpu) const {
+        return cpu >= 0 && cpu < MAX_CPUS && (bits[cpu / 64] >> (cpu % 64)) & 1;
+    }
+
+    void Clear() {
+        for (uint64_t& word : bits) word = 0;
+    }
+
+    int Count() const;
+    bool IsEmpty() const { return Count() == 0; }
+    bool Parse(const char* list);
+    void Format(char* buffer, size_t size) const;
+};
+
+struct CpuInfo {
+    int cpu = -1;
+    int coreId = -1;
+    int package = 0;
+    int node = 0;
+    uint32_t capacity = 0;
+    bool efficiency = false;
+};
+
+class CpuTopology {
+public:
+    static constexpr int MAX_CPUS = CpuSet::MAX_CPUS;
+    static constexpr int MAX_NODES = 64;
+
+    CpuTopology();
+
+    bool Detect();
+
+    int GetCpuCount() const { return _count; }
+    const CpuInfo& GetCpu(int index) const { return _cpus[index]; }
+    const CpuInfo* FindCpu(int cpu) const;
+
+    int GetNodeCount() const { return _nodeCount; }
+    int GetPackageCount() const { return _packageCount; }
+    bool IsHybrid() const { return !_efficiencySet.IsEmpty() && !_performanceSet.IsEmpty(); }
+    bool IsDetected() const { return _detected; }
+
+    const CpuSet& GetOnlineSet() const { return _onlineSet; }
+    const CpuSet& GetPerformanceSet() const { return _performanceSet; }
+    const CpuSet& GetEfficiencySet() const { return _efficiencySet; }
+
+private:
+    void ClassifyCores();
+
+    CpuInfo _cpus[MAX_CPUS];
+    int _count;
+    int _nodeCount;
+    int _packageCount;
+    CpuSet _onlineSet;
+    CpuSet _performanceSet;
+    CpuSet _efficiencySet;
+    bool _detected;
+};
+
+} // namespace tvk_media
@@ -0,0 +1,78 @@
+/**
+ * @file decode_worker.h
+ * @brief Runs scrub decodes and seek refinement for the playback decoder off the UI thread
+ */
+
+#pragma once
+
+#include "video_decoder.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace tvk_media {
+
+class ThreadPlacement;
+
+enum class DecodeJob {
+    None,
+    Scrub,
+    Refine
+};
+
+enum class DecodeResult {
+    Pending,
+    Frame,
+    Unchanged,
+    Failed
+};
+
+class DecodeWorker {
+public:
+    DecodeWorker();
+    ~DecodeWorker();
+
+    DecodeWorker(const DecodeWorker&) = delete;
+    DecodeWorker& operator=(const DecodeWorker&) = delete;
+
+    void Init(VideoDecoder* decoder, const ThreadPlacement* placement);
+    void Stop();
+
+    bool Scrub(double timeSeconds);
+    bool Refine();
+    DecodeResult Poll(VideoFrame& outFrame);
+    void Wait();
+    void Cancel();
+
+    bool IsBusy() const { return _busy.load(std::memory_order_acquire); }
+    DecodeJob GetJob() const { return _job; }
+    double GetLastJobSeconds() const { return _lastJobSeconds; }
+
+private:
+    bool Submit(DecodeJob job, double timeSeconds);
+    void WorkerLoop();
+    DecodeResult RunScrub(double timeSeconds);
+    DecodeResult RunRefine();
+
+    VideoDecoder* _decoder;
+    const ThreadPlacement* _placement;
+    std::thread _worker;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+
+    DecodeJob _job;
+    double _target;
+    DecodeResult _result;
+    std::atomic<bool> _busy;
+    std::atomic<bool> _cancel;
+    bool _stopping;
+
+    VideoFrame _frame;
+    double _scrubKeyframe;
+    double _jobSeconds;
+    double _lastJobSeconds;
+};
+
+} // namespace tvk_media
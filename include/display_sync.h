@@ -0,0 +1,70 @@
+/**
+ * @file display_sync.h
+ * @brief Vsync-locked presentation: each frame held for a whole number of display refreshes
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace tvk_media {
+
+class DisplaySync {
+public:
+    static constexpr double MAX_SPEED_CHANGE = 0.01;
+    static constexpr int MAX_REPEATS = 16;
+    static constexpr int MAX_GAP = 4;
+    static constexpr int MIN_COUNT = 32;
+    static constexpr double SAMPLE_TOLERANCE = 0.15;
+    static constexpr double MAX_RATE_ERROR = 0.03;
+    static constexpr double MIN_SPAN = 2.0;
+    static constexpr double MAX_SPAN = 30.0;
+
+    DisplaySync();
+
+    void SetEnabled(bool enabled);
+    void SetNominalRate(double hz);
+    void OnFrame(double now);
+    void Configure(double fps);
+
+    void Restart(double now, double timestamp);
+    int GetDueFrames(double now) const;
+    void OnPresented(double now, double timestamp, int dropped);
+    double GetNextDue() const;
+    void ResetCounters();
+
+    bool IsEnabled() const { return _enabled; }
+    bool IsActive() const { return _active; }
+    bool IsMeasured() const { return _measured; }
+    double GetNominalRate() const { return _nominalRate; }
+    double GetRefreshRate() const;
+    double GetFrameRate() const { return _fps; }
+    int GetRepeats() const { return _repeats; }
+    double GetSpeed() const { return _speed; }
+    double GetLastTimestamp() const { return _lastTimestamp; }
+    uint64_t GetDroppedCount() const { return _dropped; }
+    uint64_t GetRepeatedCount() const { return _repeated; }
+
+private:
+    void RestartWindow(double now);
+
+    bool _enabled;
+    bool _active;
+    bool _measured;
+    double _nominalRate;
+    double _interval;
+    double _anchor;
+    double _lastFrame;
+    int _hits;
+    int _misses;
+
+    double _fps;
+    int _repeats;
+    double _speed;
+    double _lastPresent;
+    double _lastTimestamp;
+    uint64_t _dropped;
+    uint64_t _repeated;
+};
+
+} // namespace tvk_media
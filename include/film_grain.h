@@ -0,0 +1,94 @@
+/**
+ * @file film_grain.h
+ * @brief AV1 film grain synthesis applied on the GPU from decoder-exported parameters
+ */
+
+#pragma once
+
+#include "gpu_compute.h"
+#include "video_decoder.h"
+#include <tinyvk/tinyvk.h>
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <memory>
+
+namespace tvk_media {
+
+struct FilmGrainSettings {
+    bool enabled = true;
+
+    bool IsDefault() const {
+        return enabled;
+    }
+
+    void Reset() {
+        enabled = true;
+    }
+};
+
+struct FilmGrainPushConstants {
+    int width;
+    int height;
+    int pad0;
+    int pad1;
+};
+
+struct FilmGrainData {
+    static constexpr int TEMPLATE_WIDTH = 82;
+    static constexpr int TEMPLATE_HEIGHT = 73;
+    static constexpr int TEMPLATE_SIZE = TEMPLATE_WIDTH * TEMPLATE_HEIGHT;
+    static constexpr int HEADER_SIZE = 32;
+    static constexpr int MAX_BLOCKS = 256 * 136;
+
+    int32_t header[HEADER_SIZE];
+    int32_t lumaGrain[TEMPLATE_SIZE];
+    int32_t cbGrain[TEMPLATE_SIZE];
+    int32_t crGrain[TEMPLATE_SIZE];
+    int32_t scaling[3 * 256];
+    int32_t offsets[MAX_BLOCKS];
+};
+
+class FilmGrainSynthesizer {
+public:
+    FilmGrainSynthesizer();
+    ~FilmGrainSynthesizer();
+
+    FilmGrainSynthesizer(const FilmGrainSynthesizer&) = delete;
+    FilmGrainSynthesizer& operator=(const FilmGrainSynthesizer&) = delete;
+
+    bool Init(tvk::Renderer* renderer);
+    void Cleanup();
+
+    void Prepare(const FilmGrain& grain, int width, int height);
+    void Record(VkCommandBuffer cmd, tvk::Texture* texture);
+    bool IsActive() const { return _active; }
+
+    FilmGrainSettings& GetSettings() { return _settings; }
+    const FilmGrainSettings& GetSettings() const { return _settings; }
+
+private:
+    bool Generate(const AVFilmGrainParams& params, int subX, int subY, int width, int height);
+
+    tvk::Renderer* _renderer;
+    tvk::VulkanContext* _context;
+
+    ComputePipeline _pipeline;
+    VkDescriptorSet _descriptorSet;
+    HostBuffer _buffer;
+    VkImageView _lastView;
+
+    std::unique_ptr<FilmGrainData> _data;
+    AVFilmGrainParams _lastParams;
+    int _lastWidth;
+    int _lastHeight;
+    int _lastSubX;
+    int _lastSubY;
+    int _width;
+    int _height;
+
+    FilmGrainSettings _settings;
+    bool _active;
+    bool _initialized;
+};
+
+} // namespace tvk_media
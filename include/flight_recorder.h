@@ -0,0 +1,98 @@
+/**
+ * @file flight_recorder.h
+ * @brief Always-on ring of per-frame timing with hitch-triggered JSON dumps
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace tvk_media {
+
+struct FlightSample {
+    double time = 0.0;
+    float frameMs = 0.0f;
+    float lateMs = 0.0f;
+    float driftMs = 0.0f;
+    uint16_t queueDepth = 0;
+    uint16_t queueCapacity = 0;
+    uint32_t underruns = 0;
+    uint8_t flags = 0;
+};
+
+struct FlightRecorderSettings {
+    bool enabled = true;
+    float hitchThresholdMs = 50.0f;
+    bool dumpOnUnderrun = true;
+};
+
+class FlightRecorder {
+public:
+    static constexpr int CAPACITY = 1024;
+    static constexpr int PRE_SAMPLES = 240;
+    static constexpr int POST_SAMPLES = 60;
+    static constexpr double DUMP_COOLDOWN = 10.0;
+    static constexpr int MAX_DUMPS = 32;
+
+    static constexpr uint8_t FLAG_PRESENTED = 1 << 0;
+    static constexpr uint8_t FLAG_UNDERRUN = 1 << 1;
+    static constexpr uint8_t FLAG_SEEK = 1 << 2;
+    static constexpr uint8_t FLAG_PLAYING = 1 << 3;
+
+    FlightRecorder();
+    ~FlightRecorder();
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    void Init();
+    void Cleanup();
+
+    void Record(const FlightSample& sample);
+    void Trigger(const char* reason);
+
+    uint64_t GetHitchCount() const { return _hitches; }
+    int GetDumpCount() const { return _dumps; }
+    std::string GetLastDumpPath();
+    const std::string& GetDirectory() const { return _directory; }
+
+    FlightRecorderSettings& GetSettings() { return _settings; }
+    const FlightRecorderSettings& GetSettings() const { return _settings; }
+
+private:
+    static constexpr int WINDOW = PRE_SAMPLES + POST_SAMPLES;
+
+    void Capture();
+    void WriterLoop();
+    void WriteDump();
+
+    FlightRecorderSettings _settings;
+    FlightSample _ring[CAPACITY];
+    uint64_t _written;
+    uint64_t _hitches;
+    int _dumps;
+    int _postRemaining;
+    const char* _pendingReason;
+    double _pendingTime;
+    double _lastDumpTime;
+
+    FlightSample _window[WINDOW];
+    int _windowCount;
+    const char* _windowReason;
+    double _windowTime;
+    float _windowThreshold;
+
+    std::string _directory;
+    std::string _lastPath;
+    std::thread _writer;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    bool _dumpReady;
+    bool _stopping;
+};
+
+} // namespace tvk_media
@@ -0,0 +1,23 @@
+/**
+ * @file frame_copy.h
+ * @brief Write-only copy kernels for mapped, possibly write-combined, GPU memory
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tvk_media {
+
+static constexpr size_t COPY_LINE_SIZE = 64;
+
+inline size_t AlignCopyPitch(size_t rowBytes) {
+    return (rowBytes + COPY_LINE_SIZE - 1) & ~(COPY_LINE_SIZE - 1);
+}
+
+void StreamCopy(void* dst, const void* src, size_t size);
+void StreamCopyPlane(uint8_t* dst, size_t dstPitch, const uint8_t* src, size_t srcPitch,
+                     size_t rowBytes, size_t rows);
+
+} // namespace tvk_media
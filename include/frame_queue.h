@@ -0,0 +1,45 @@
+/**
+ * @file frame_queue.h
+ * @brief Fixed-capacity ring of decoded frames awaiting presentation
+ */
+
+#pragma once
+
+#include "video_decoder.h"
+
+namespace tvk_media {
+
+class FrameQueue {
+public:
+    static constexpr int MAX_FRAMES = 16;
+
+    FrameQueue();
+
+    FrameQueue(const FrameQueue&) = delete;
+    FrameQueue& operator=(const FrameQueue&) = delete;
+
+    void SetCapacity(int capacity);
+    int GetCapacity() const { return _capacity; }
+    int GetSize() const { return _size; }
+    bool IsEmpty() const { return _size == 0; }
+    bool IsFull() const { return _size >= _capacity; }
+
+    VideoFrame& Back();
+    void Push();
+    const VideoFrame& At(int index) const;
+    VideoFrame& GetSlot(int index) { return _frames[index]; }
+    void PopInto(VideoFrame& outFrame);
+    void Clear();
+    void ReleaseUnused();
+
+private:
+    void Compact();
+
+    VideoFrame _frames[MAX_FRAMES];
+    int _head;
+    int _size;
+    int _capacity;
+    int _length;
+};
+
+} // namespace tvk_media
@@ -0,0 +1,59 @@
+/**
+ * @file frame_uploader.h
+ * @brief Decoded frame upload through a persistent mapped staging buffer, with GPU unpacking of raw frames
+ */
+
+#pragma once
+
+#include "gpu_compute.h"
+#include "raw_video.h"
+#include <tinyvk/tinyvk.h>
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace tvk_media {
+
+struct RawUnpackPushConstants {
+    int width;
+    int height;
+    int format;
+    int bt709;
+    int pitch;
+    int chromaOffset;
+    int chromaPitch;
+    int crOffset;
+};
+
+class FrameUploader {
+public:
+    FrameUploader();
+    ~FrameUploader();
+
+    FrameUploader(const FrameUploader&) = delete;
+    FrameUploader& operator=(const FrameUploader&) = delete;
+
+    bool Init(tvk::Renderer* renderer);
+    void Cleanup();
+
+    bool Upload(tvk::Texture* texture, const uint8_t* data, uint32_t width, uint32_t height, size_t srcPitch);
+    uint8_t* MapUpload(tvk::Texture* texture, uint32_t width, uint32_t height, size_t& pitch);
+    bool SubmitUpload(tvk::Texture* texture, uint32_t width, uint32_t height, size_t pitch);
+    bool UploadRaw(tvk::Texture* texture, const RawFrame& frame, uint32_t width, uint32_t height);
+    bool SupportsRaw() const { return _rawSupported; }
+
+private:
+    tvk::Renderer* _renderer;
+    tvk::VulkanContext* _context;
+    HostBuffer _staging;
+
+    ComputePipeline _rawPipeline;
+    VkDescriptorSet _rawDescriptorSet;
+    HostBuffer _rawBuffer;
+    VkImageView _rawView;
+    bool _rawSupported;
+
+    bool _initialized;
+};
+
+} // namespace tvk_media
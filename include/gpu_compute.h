@@ -0,0 +1,74 @@
+/**
+ * @file gpu_compute.h
+ * @brief Shared helpers for compute passes, storage images and mapped host buffers
+ */
+
+#pragma once
+
+#include <tinyvk/tinyvk.h>
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+namespace tvk_media {
+
+struct StorageImage {
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+enum class HostMemory {
+    Coherent,
+    WriteCombined,
+    Cached
+};
+
+struct HostBuffer {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    void* mapped = nullptr;
+    VkDeviceSize size = 0;
+};
+
+struct GpuObjectCounts {
+    int64_t liveObjects = 0;
+    int64_t descriptorSets = 0;
+    uint64_t texturesCreated = 0;
+};
+
+struct ComputePipeline {
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkShaderModule shader = VK_NULL_HANDLE;
+};
+
+bool CreateComputePipeline(tvk::Renderer* renderer, const char* source, const char* name,
+                           uint32_t storageImageCount, uint32_t storageBufferCount,
+                           uint32_t pushConstantSize, ComputePipeline& out);
+void DestroyComputePipeline(VkDevice device, ComputePipeline& pipeline);
+
+bool AllocateDescriptorSet(tvk::VulkanContext* context, const ComputePipeline& pipeline, VkDescriptorSet& out);
+void WriteStorageImages(VkDevice device, VkDescriptorSet set, const VkImageView* views, uint32_t count);
+void WriteStorageBuffer(VkDevice device, VkDescriptorSet set, uint32_t binding, const HostBuffer& buffer);
+
+bool CreateStorageImage(tvk::VulkanContext* context, uint32_t width, uint32_t height,
+                        VkImageUsageFlags usage, StorageImage& out);
+void DestroyStorageImage(VkDevice device, StorageImage& image);
+
+uint32_t FindHostMemoryType(tvk::VulkanContext* context, uint32_t typeBits, HostMemory kind);
+bool CreateHostBuffer(tvk::VulkanContext* context, VkDeviceSize size, VkBufferUsageFlags usage,
+                      HostMemory kind, HostBuffer& out);
+void DestroyHostBuffer(VkDevice device, HostBuffer& buffer);
+
+GpuObjectCounts GetGpuObjectCounts();
+void CountTextureCreated();
+
+void TransitionImage(VkCommandBuffer cmd, VkImage image,
+                     VkImageLayout oldLayout, VkImageLayout newLayout,
+                     VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+                     VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage);
+
+} // namespace tvk_media
@@ -0,0 +1,97 @@
+/**
+ * @file image_sequence.h
+ * @brief Numbered image sequences played as a clip, decoded in parallel into a budgeted prefetch cache
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tvk_media {
+
+struct VideoFrame;
+
+class ImageSequence {
+public:
+    static constexpr double DEFAULT_FRAME_RATE = 24.0;
+    static constexpr int MIN_FRAMES = 2;
+    static constexpr int MIN_CACHED_FRAMES = 4;
+    static constexpr int MAX_CACHED_FRAMES = 256;
+
+    ImageSequence();
+    ~ImageSequence();
+
+    ImageSequence(const ImageSequence&) = delete;
+    ImageSequence& operator=(const ImageSequence&) = delete;
+
+    static bool IsSequencePath(const std::string& path);
+    static void SetFrameRate(double fps);
+    static double GetFrameRate();
+
+    bool Open(const std::string& path);
+    void Close();
+    void SetWorkerCount(int workers) { _workerCount = workers; }
+    void SetBudget(size_t bytes);
+
+    bool IsReady();
+    bool Read(VideoFrame& outFrame);
+    void Seek(int frame);
+    bool DecodeThumbnail(int frame, VideoFrame& outFrame, int maxWidth, int maxHeight);
+
+    bool IsOpen() const { return !_files.empty(); }
+    int GetFrameCount() const { return static_cast<int>(_files.size()); }
+    int GetPosition() const { return _cursor; }
+    int GetWidth() const { return _width; }
+    int GetHeight() const { return _height; }
+    double GetFPS() const { return _fps; }
+    const char* GetCodecName() const { return _codecName.c_str(); }
+    const std::string& GetPattern() const { return _pattern; }
+    int GetCapacity() const { return static_cast<int>(_slots.size()); }
+    int GetActiveWorkers() const { return static_cast<int>(_workers.size()); }
+    int GetReadyAhead() const;
+
+private:
+    enum class SlotState {
+        Empty,
+        Pending,
+        Ready,
+        Failed
+    };
+
+    struct Slot {
+        int frame = -1;
+        SlotState state = SlotState::Empty;
+        std::vector<uint8_t> data;
+    };
+
+    void StartWorkers();
+    void StopWorkers();
+    void WorkerLoop();
+    int PickFrame();
+    void ResizeSlots();
+
+    std::vector<std::string> _files;
+    std::string _pattern;
+    std::string _codecName;
+    int _width;
+    int _height;
+    double _fps;
+    int _workerCount;
+    size_t _budget;
+
+    std::vector<std::thread> _workers;
+    mutable std::mutex _mutex;
+    std::condition_variable _work;
+    std::condition_variable _ready;
+    std::vector<Slot> _slots;
+    int _cursor;
+    bool _stopping;
+};
+
+} // namespace tvk_media
@@ -0,0 +1,78 @@
+/**
+ * @file latency_tracker.h
+ * @brief Input-to-present latency for play, pause and seek actions
+ */
+
+#pragma once
+
+#include <chrono>
+
+namespace tvk_media {
+
+enum class UserAction {
+    Play,
+    Pause,
+    Seek,
+    Count
+};
+
+enum class LatencyStage {
+    Issued,
+    Decoded,
+    Uploaded,
+    Processed,
+    Presented,
+    Count
+};
+
+struct LatencySample {
+    float stages[static_cast<int>(LatencyStage::Count)];
+};
+
+struct LatencySummary {
+    int count = 0;
+    float p50 = 0.0f;
+    float p95 = 0.0f;
+    float max = 0.0f;
+};
+
+class LatencyTracker {
+public:
+    static constexpr int HISTORY = 128;
+
+    LatencyTracker();
+
+    void BeginFrame();
+    void Begin(UserAction action);
+    void Mark(LatencyStage stage);
+    void MarkFrameBuilt();
+    void MarkPresented();
+
+    bool IsPending() const { return _pending; }
+    bool HasSamples(UserAction action) const { return _history[static_cast<int>(action)].count > 0; }
+    const LatencySample& GetLast(UserAction action) const;
+    LatencySummary GetSummary(UserAction action) const;
+    void LogSummary() const;
+
+    static const char* GetActionName(UserAction action);
+    static const char* GetStageName(LatencyStage stage);
+
+private:
+    struct History {
+        LatencySample samples[HISTORY];
+        int next;
+        int count;
+    };
+
+    float Elapsed() const;
+
+    History _history[static_cast<int>(UserAction::Count)];
+    std::chrono::steady_clock::time_point _frameStart;
+    std::chrono::steady_clock::time_point _inputTime;
+    LatencySample _current;
+    UserAction _action;
+    bool _pending;
+    bool _frameBuilt;
+};
+
+} // namespace tvk_media
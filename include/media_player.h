@@ -9,6 +9,27 @@
 #include "video_decoder.h"
 #include "audio_decoder.h"
 #include "video_effects.h"
+#include "video_stabilizer.h"
+#include "video_upscaler.h"
+#include "frame_queue.h"
+#include "frame_uploader.h"
+#include "copy_benchmark.h"
+#include "sync_benchmark.h"
+#include "seek_stress.h"
+#include "soak_test.h"
+#include "thumbnail_pyramid.h"
+#include "thread_placement.h"
+#include "resource_limits.h"
+#include "memory_pressure.h"
+#include "power_profile.h"
+#include "alloc_tracker.h"
+#include "startup_profiler.h"
+#include "latency_tracker.h"
+#include "flight_recorder.h"
+#include "display_sync.h"
+#include "decode_worker.h"
+#include "thread_stats.h"
+#include <future>
 #include <memory>
 #include <string>
 
@@ -41,39 +62,145 @@ private:
     void DrawFiltersWindow();
     void DrawPostProcessWindow();
     void DrawEffectsWindow();
+    void DrawCopyBenchmarkWindow();
+    void DrawSyncBenchmarkWindow();
+    void DrawSeekStressWindow();
+    void DrawSoakTestWindow();
+    void DrawTimelineWindow();
+    void DrawStatsOverlay();
+    void DrawThreadPlacementMenu();
+    void DrawPowerProfileMenu();
+    void DrawSequenceFrameRateMenu();
+    void DrawFlightRecorderMenu();
     
     void OpenFile();
+    bool OpenMedia(const std::string& filepath);
+    bool SelectAudioTrack(int streamIndex);
+    bool SelectNextAudioTrack();
     void TogglePlayPause();
     void UpdateVideo();
-    void SeekTo(double timeSeconds);
+    void FillFrameQueue();
+    void PresentNextFrame();
+    void UploadCurrentFrame();
+    void ProcessCurrentFrame();
+    void StartThumbnailDecoder(const std::string& filepath);
+    bool IsThumbnailDecoderReady();
+    void RequestThumbnail(double previewTime);
+    void UploadThumbnail();
+    void UploadTimelineAtlas();
+    void CheckFrameAllocations();
+    void ResetFrameQueue();
+    void PrepareFramePool();
+    void ApplyMemoryPressure();
+    void ApplyPowerProfile();
+    int GetDecoderThreads() const;
+    void RecordFlightSample();
+    void WaitForNextFrame();
+    void UpdateDisplaySync();
+    GLFWmonitor* FindWindowMonitor();
+    double GetDisplayRefreshRate();
+    bool SeekTo(double timeSeconds);
+    void RefineSeek();
+    void FinishRefine();
+    void ScrubTo(double timeSeconds);
+    void UpdateScrub();
+    void EndScrub();
+    void StartSyncBenchmark();
+    void UpdateSyncBenchmark();
+    void StartSeekStress();
+    void UpdateSeekStress();
+    void StartSoakTest();
+    void UpdateSoakTest();
 
     // Video decoding
     std::unique_ptr<VideoDecoder> _decoder;
     std::unique_ptr<VideoDecoder> _thumbnailDecoder;
+    std::future<bool> _thumbnailOpen;
+    bool _thumbnailReady;
     VideoFrame _currentFrame;
+    FrameQueue _frameQueue;
+    bool _decoderEof;
     tvk::Ref<tvk::Texture> _videoTexture;
+    std::unique_ptr<FrameUploader> _uploader;
     
     // Audio decoding
     std::unique_ptr<AudioDecoder> _audioDecoder;
     
     // Video effects (GPU-based)
     std::unique_ptr<VideoEffects> _videoEffects;
+    std::unique_ptr<VideoStabilizer> _stabilizer;
+    bool _stabilizerActive;
+    std::unique_ptr<VideoUpscaler> _upscaler;
+    bool _videoFrameDirty;
     bool _showColorWindow;
     bool _showFiltersWindow;
     bool _showPostProcessWindow;
     bool _showEffectsWindow;
     
+    // Diagnostics
+    CopyBenchmarkReport _copyBenchmark;
+    bool _showCopyBenchmarkWindow;
+    SyncBenchmark _syncBenchmark;
+    bool _showSyncBenchmarkWindow;
+    SeekStress _seekStress;
+    bool _showSeekStressWindow;
+    SoakTest _soakTest;
+    bool _showSoakTestWindow;
+    bool _showStats;
+    AllocStats _frameAllocs;
+    int _allocWarmupFrames;
+    int _framePoolSlots;
+    bool _cacheBudgetPending;
+    bool _decoderRestartPending;
+    uint64_t _allocViolations;
+    StartupProfiler _coldStart;
+    StartupProfiler _firstFrame;
+    LatencyTracker _latency;
+    FlightRecorder _flightRecorder;
+    ThreadStats _threadStats;
+    double _lastLoopTime;
+    float _frameLateMs;
+    bool _framePresented;
+    bool _seekedThisFrame;
+    uint64_t _lastUnderruns;
+    
+    // Vsync-locked presentation
+    DisplaySync _displaySync;
+    double _nextDisplayRateCheck;
+    
+    // Scrub and refine decodes off the UI thread
+    DecodeWorker _decodeWorker;
+    
+    // CPU placement, container limits and power
+    ThreadPlacement _threadPlacement;
+    ResourceLimits _resourceLimits;
+    MemoryPressureMonitor _memoryPressure;
+    std::future<void> _memoryRelease;
+    PowerProfile _powerProfile;
+    
     // Thumbnail preview
     VideoFrame _thumbnailFrame;
     tvk::Ref<tvk::Texture> _thumbnailTexture;
     double _lastThumbnailTime;
     bool _showThumbnail;
     
+    // Zoomable timeline
+    ThumbnailPyramid _thumbnailPyramid;
+    tvk::Ref<tvk::Texture> _timelineAtlas;
+    bool _showTimelineWindow;
+    bool _timelineOpenPending;
+    double _timelineStart;
+    double _timelineSpan;
+    bool _timelineDragged;
+    
     // Playback state
     bool _isPlaying;
     bool _hasVideo;
     double _videoStartTime;
     double _pausedAtTime;
+    double _refineTarget;
+    double _refineStart;
+    float _refineMs;
     float _volume;
     
     // UI state
@@ -81,6 +208,8 @@ private:
     bool _showControls;
     float _seekBarValue;
     bool _isSeeking;
+    bool _scrubbing;
+    double _scrubTarget;
 
     // Window state for custom title bar
     bool _isDragging;
@@ -0,0 +1,60 @@
+/**
+ * @file memory_pressure.h
+ * @brief Memory pressure tracking from Linux PSI and cgroup memory events
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tvk_media {
+
+enum class PressureLevel {
+    None,
+    Moderate,
+    Severe
+};
+
+class MemoryPressureMonitor {
+public:
+    static constexpr int MAX_SHRINK_LEVEL = 3;
+    static constexpr double POLL_INTERVAL = 1.0;
+    static constexpr double RECOVERY_DELAY = 10.0;
+
+    MemoryPressureMonitor();
+
+    void Init(const char* cgroupDirectory);
+    bool Update(double now);
+
+    PressureLevel GetLevel() const { return _level; }
+    int GetShrinkLevel() const { return _shrinkLevel; }
+    float GetSomeAvg10() const { return _someAvg10; }
+    float GetFullAvg10() const { return _fullAvg10; }
+    bool IsAvailable() const { return _psiAvailable || _eventsAvailable; }
+
+    int ScaleCapacity(int capacity) const;
+    size_t ScaleBudget(size_t bytes) const;
+    static const char* GetLevelName(PressureLevel level);
+    static void ReleaseFreeMemory();
+
+private:
+    bool ReadPsi();
+    bool ReadEvents(uint64_t& high, uint64_t& max);
+
+    char _eventsPath[576];
+    bool _psiAvailable;
+    bool _eventsAvailable;
+
+    float _someAvg10;
+    float _fullAvg10;
+    uint64_t _lastHighEvents;
+    uint64_t _lastMaxEvents;
+
+    PressureLevel _level;
+    int _shrinkLevel;
+    double _lastPoll;
+    double _calmSince;
+};
+
+} // namespace tvk_media
@@ -0,0 +1,72 @@
+/**
+ * @file packet_cache.h
+ * @brief Bounded cache of demuxed video packets that serves seeks without touching I/O
+ */
+
+#pragma once
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace tvk_media {
+
+class PacketCache {
+public:
+    PacketCache();
+    ~PacketCache();
+
+    PacketCache(const PacketCache&) = delete;
+    PacketCache& operator=(const PacketCache&) = delete;
+
+    void SetTimeBase(AVRational timeBase) { _timeBase = timeBase; }
+    void SetBudget(size_t bytes);
+    void Trim(size_t bytes);
+    void Clear();
+    void Detach() { _detached = true; }
+
+    bool Read(AVPacket* out);
+    void Append(const AVPacket* packet);
+    void MarkEnd() { if (!_detached) _atEnd = true; }
+    bool Seek(int64_t timestamp);
+    bool FindKeyframe(int64_t timestamp, int64_t& out) const;
+
+    bool IsEnabled() const { return _budget > 0; }
+    bool IsDetached() const { return _detached; }
+    int64_t GetEndDts() const;
+    size_t GetBudget() const { return _budget; }
+    size_t GetBytes() const { return _bytes; }
+    size_t GetPacketCount() const { return _entries.size(); }
+    double GetBehindSeconds() const;
+    double GetAheadSeconds() const;
+    uint64_t GetHits() const { return _hits; }
+    uint64_t GetMisses() const { return _misses; }
+
+private:
+    struct Entry {
+        AVPacket* packet;
+        int64_t timestamp;
+        bool keyframe;
+    };
+
+    void EvictFront();
+    size_t FindKeyframeIndex(int64_t timestamp) const;
+
+    std::deque<Entry> _entries;
+    std::vector<AVPacket*> _spare;
+    AVRational _timeBase;
+    size_t _cursor;
+    size_t _bytes;
+    size_t _budget;
+    uint64_t _hits;
+    uint64_t _misses;
+    bool _atEnd;
+    bool _detached;
+};
+
+} // namespace tvk_media
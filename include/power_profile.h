@@ -0,0 +1,79 @@
+/**
+ * @file power_profile.h
+ * @brief Battery-aware power profile and process wakeup accounting
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace tvk_media {
+
+enum class PowerMode {
+    Auto,
+    Performance,
+    PowerSaver
+};
+
+enum class PowerSource {
+    Unknown,
+    Mains,
+    Battery
+};
+
+struct PowerProfileSettings {
+    PowerMode mode = PowerMode::Auto;
+    int maxDecoderThreads = 2;
+    float upscaleScale = 0.5f;
+    int effectsStep = 2;
+    int audioBufferScale = 4;
+};
+
+class PowerProfile {
+public:
+    static constexpr double SOURCE_POLL_INTERVAL = 5.0;
+    static constexpr double SAMPLE_INTERVAL = 1.0;
+    static constexpr double MAX_IDLE_WAIT = 0.25;
+
+    PowerProfile();
+
+    void Init();
+    bool Update(double now);
+
+    bool IsPowerSaving() const { return _powerSaving; }
+    PowerSource GetSource() const { return _source; }
+    int GetBatteryPercent() const { return _batteryPercent; }
+    double GetWakeupsPerSecond() const { return _wakeupsPerSecond; }
+    double GetRedrawsPerSecond() const { return _redrawsPerSecond; }
+    bool IsWakeupCountAvailable() const { return _wakeupsAvailable; }
+
+    int CapDecoderThreads(int threads) const;
+    uint32_t ScaleUpscaleSize(uint32_t size) const;
+    int GetEffectsStep() const { return _powerSaving ? _settings.effectsStep : 1; }
+    int GetAudioBufferScale() const { return _powerSaving ? _settings.audioBufferScale : 1; }
+
+    PowerProfileSettings& GetSettings() { return _settings; }
+    const PowerProfileSettings& GetSettings() const { return _settings; }
+
+    static const char* GetModeName(PowerMode mode);
+    static const char* GetSourceName(PowerSource source);
+
+private:
+    void ReadPowerSupply();
+    static bool ReadContextSwitches(uint64_t& switches);
+
+    PowerProfileSettings _settings;
+    PowerSource _source;
+    int _batteryPercent;
+    bool _powerSaving;
+
+    bool _wakeupsAvailable;
+    uint64_t _lastSwitches;
+    uint64_t _redraws;
+    double _wakeupsPerSecond;
+    double _redrawsPerSecond;
+    double _lastSourcePoll;
+    double _lastSample;
+};
+
+} // namespace tvk_media
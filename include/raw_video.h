@@ -0,0 +1,99 @@
+/**
+ * @file raw_video.h
+ * @brief Memory-mapped access to uncompressed video frames, bypassing demux and decode
+ */
+
+#pragma once
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavutil/pixfmt.h>
+}
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tvk_media {
+
+enum class RawFormat {
+    None,
+    V210,
+    UYVY,
+    YUYV,
+    YUV420P,
+    YUV420P10,
+    RGB24,
+    RGBA,
+    BGRA
+};
+
+struct RawFrame {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    RawFormat format = RawFormat::None;
+    int pitch = 0;
+    int chromaOffset = 0;
+    int chromaPitch = 0;
+    int crOffset = 0;
+    bool bt709 = false;
+};
+
+class RawVideoFile {
+public:
+    static constexpr int PREFETCH_FRAMES = 4;
+
+    RawVideoFile();
+    ~RawVideoFile();
+
+    RawVideoFile(const RawVideoFile&) = delete;
+    RawVideoFile& operator=(const RawVideoFile&) = delete;
+
+    static RawFormat GetFormat(const AVCodecParameters* params);
+    static const char* GetFormatName(RawFormat format);
+
+    bool Open(const std::string& path, AVFormatContext* formatContext, AVStream* stream, RawFormat format);
+    void Close();
+
+    bool GetFrame(int index, RawFrame& out);
+    bool GetPlanes(const RawFrame& frame, uint8_t* data[4], int linesize[4]);
+    int FindFrame(double timeSeconds) const;
+    double GetFrameTime(int index) const { return _times[index]; }
+
+    bool IsOpen() const { return _base != nullptr; }
+    int GetFrameCount() const { return static_cast<int>(_offsets.size()); }
+    RawFormat GetFormat() const { return _format; }
+    AVPixelFormat GetPlaneFormat() const;
+    size_t GetFrameSize() const { return _frameSize; }
+
+private:
+    bool Map(const std::string& path);
+    void Unmap();
+    bool IndexY4M();
+    bool IndexFixed();
+    bool IndexStream(AVStream* stream, size_t headerSize);
+    void Prefetch(int index);
+
+    const uint8_t* _base;
+    size_t _fileSize;
+#if defined(_WIN32)
+    void* _file;
+    void* _mapping;
+#else
+    int _file;
+#endif
+
+    RawFormat _format;
+    int _width;
+    int _height;
+    double _fps;
+    RawFrame _layout;
+    size_t _frameSize;
+    std::vector<size_t> _offsets;
+    std::vector<double> _times;
+    std::vector<uint16_t> _unpacked;
+    int _prefetched;
+};
+
+} // namespace tvk_media
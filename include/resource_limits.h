@@ -0,0 +1,55 @@
+/**
+ * @file resource_limits.h
+ * @brief Container-aware CPU and memory limits (cgroup v2, with v1 fallback)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tvk_media {
+
+class ResourceLimits {
+public:
+    static constexpr int MAX_DECODER_THREADS = 16;
+    static constexpr size_t MAX_CACHE_BUDGET = static_cast<size_t>(512) * 1024 * 1024;
+
+    ResourceLimits();
+
+    void Detect();
+
+    int GetHostCpus() const { return _hostCpus; }
+    int GetAffinityCpus() const { return _affinityCpus; }
+    double GetCpuQuota() const { return _cpuQuota; }
+    int GetEffectiveCpus() const { return _effectiveCpus; }
+
+    uint64_t GetHostMemory() const { return _hostMemory; }
+    uint64_t GetMemoryLimit() const { return _memoryLimit; }
+    uint64_t GetEffectiveMemory() const;
+    size_t GetFrameBudget() const;
+    size_t GetCacheBudget() const;
+
+    int GetDecoderThreads(int candidateCpus) const;
+    int GetFrameQueueCapacity(int requested, size_t frameBytes) const;
+
+    const char* GetCgroupVersion() const { return _cgroupVersion; }
+    const char* GetCgroupPath() const { return _cgroupPath; }
+    const char* GetCgroupDirectory() const { return _cgroupDirectory; }
+
+private:
+    void DetectCgroupV2(const char* mount, const char* path);
+    void DetectCgroupV1(const char* path);
+
+    int _hostCpus;
+    int _affinityCpus;
+    double _cpuQuota;
+    int _effectiveCpus;
+    uint64_t _hostMemory;
+    uint64_t _memoryLimit;
+    const char* _cgroupVersion;
+    char _cgroupPath[256];
+    char _cgroupDirectory[512];
+};
+
+} // namespace tvk_media
@@ -0,0 +1,105 @@
+/**
+ * @file seek_stress.h
+ * @brief Seek-storm stress run over a corpus with PTS checks and latency percentiles
+ */
+
+#pragma once
+
+#include "video_decoder.h"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace tvk_media {
+
+enum class SeekPattern {
+    Random,
+    Sequential,
+    BackAndForth,
+    NearEnd,
+    TrackSwitch,
+    Count
+};
+
+struct SeekStressSettings {
+    int seeksPerPattern = 200;
+    uint32_t seed = 1;
+    double audioTolerance = 0.1;
+    double frameBudget = 0.010;
+};
+
+struct SeekRequest {
+    double target = 0.0;
+    SeekPattern pattern = SeekPattern::Random;
+    bool switchTrack = false;
+};
+
+struct SeekStressResult {
+    std::string path;
+    std::string container;
+    std::string codec;
+    int seeks = 0;
+    int failures[static_cast<int>(SeekPattern::Count)] = {};
+    float p50Ms = 0.0f;
+    float p95Ms = 0.0f;
+    float p99Ms = 0.0f;
+    float maxMs = 0.0f;
+    bool opened = false;
+};
+
+class SeekStress {
+public:
+    static constexpr int MAX_LOGGED_FAILURES = 8;
+
+    SeekStress();
+
+    bool Start(const std::string& anyCorpusFile);
+    void Cancel();
+
+    bool NeedsOpen() const { return _running && !_fileOpen; }
+    const std::string& GetCurrentPath() const { return _corpus[_fileIndex]; }
+    void BeginFile(const VideoDecoder& decoder);
+    void SkipFile();
+
+    SeekRequest Next();
+    void Check(const SeekRequest& request, double latencySeconds, bool presented, double presentedPts,
+               bool hasAudio, double audioTime);
+
+    bool IsRunning() const { return _running; }
+    int GetFileIndex() const { return _fileIndex; }
+    int GetFileCount() const { return static_cast<int>(_corpus.size()); }
+    int GetSeekIndex() const { return _seekIndex; }
+    int GetSeeksPerFile() const { return _settings.seeksPerPattern * static_cast<int>(SeekPattern::Count); }
+    const std::vector<SeekStressResult>& GetResults() const { return _results; }
+
+    SeekStressSettings& GetSettings() { return _settings; }
+    const SeekStressSettings& GetSettings() const { return _settings; }
+
+    static const char* GetPatternName(SeekPattern pattern);
+
+private:
+    void FinishFile();
+    void Fail(const SeekRequest& request, const char* reason, double presentedPts, double expectedPts);
+    double DecodeReferenceExact(double target);
+
+    SeekStressSettings _settings;
+    std::vector<std::string> _corpus;
+    std::vector<SeekStressResult> _results;
+    std::vector<float> _latencies;
+    std::mt19937 _random;
+
+    VideoDecoder _reference;
+    VideoFrame _referenceFrame;
+
+    double _duration;
+    double _frameDuration;
+    double _cursor;
+    int _fileIndex;
+    int _seekIndex;
+    int _loggedFailures;
+    bool _fileOpen;
+    bool _running;
+};
+
+} // namespace tvk_media
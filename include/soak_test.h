@@ -0,0 +1,103 @@
+/**
+ * @file soak_test.h
+ * @brief Accelerated soak run that loops playback actions and fails on resource growth or A/V drift
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+namespace tvk_media {
+
+enum class SoakAction {
+    None,
+    Reopen,
+    Play,
+    Seek,
+    HoverThumbnail,
+    SwitchTrack,
+    EffectsOn,
+    EffectsOff,
+    Finish
+};
+
+struct SoakSettings {
+    float simulatedHours = 24.0f;
+    float minutesPerCycle = 10.0f;
+    float maxRssGrowthMb = 64.0f;
+    float maxDriftMs = 80.0f;
+    int maxTexturesPerCycle = 4;
+};
+
+struct SoakSample {
+    float hours = 0.0f;
+    float rssMb = 0.0f;
+    float driftMs = 0.0f;
+    int gpuObjects = 0;
+    int descriptorSets = 0;
+    int openALObjects = 0;
+    int texturesCreated = 0;
+    int heapAllocations = 0;
+};
+
+struct SoakReport {
+    static constexpr int MAX_SAMPLES = 512;
+
+    SoakSample samples[MAX_SAMPLES];
+    int count = 0;
+    float rssGrowthMb = 0.0f;
+    float driftGrowthMs = 0.0f;
+    float worstDriftMs = 0.0f;
+    bool finished = false;
+    bool passed = false;
+    const char* failure = "";
+};
+
+class SoakTest {
+public:
+    static constexpr int WARMUP_CYCLES = 6;
+    static constexpr int MIN_TREND_CYCLES = 4;
+    static constexpr double SETTLE_TIME = 0.2;
+
+    SoakTest();
+
+    void Start(const std::string& path, double now);
+    void Cancel();
+    SoakAction Update(double now, bool driftValid, float driftMs);
+
+    bool IsRunning() const { return _running; }
+    const std::string& GetPath() const { return _path; }
+    double GetTarget() const { return _target; }
+    int GetCycle() const { return _cycle; }
+    int GetCycleCount() const { return _cycleCount; }
+    const SoakReport& GetReport() const { return _report; }
+
+    SoakSettings& GetSettings() { return _settings; }
+    const SoakSettings& GetSettings() const { return _settings; }
+
+private:
+    void Sample();
+    void Finish();
+
+    SoakSettings _settings;
+    SoakReport _report;
+    std::string _path;
+    std::mt19937 _random;
+
+    uint64_t _lastTextures;
+    uint64_t _lastAllocations;
+    float _cycleDriftMs;
+
+    double _target;
+    double _stepStart;
+    double _stepEnd;
+    int _step;
+    int _repeat;
+    int _cycle;
+    int _cycleCount;
+    bool _running;
+};
+
+} // namespace tvk_media
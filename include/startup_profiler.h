@@ -0,0 +1,54 @@
+/**
+ * @file startup_profiler.h
+ * @brief Phase timing for time-to-window and time-to-first-frame
+ */
+
+#pragma once
+
+#include <chrono>
+
+namespace tvk_media {
+
+struct ProfilePhase {
+    const char* name;
+    double seconds;
+};
+
+class StartupProfiler {
+public:
+    static constexpr int MAX_PHASES = 16;
+    static constexpr double COLD_START_BUDGET = 1.5;
+    static constexpr double FIRST_FRAME_BUDGET = 0.5;
+
+    StartupProfiler(const char* label, double budgetSeconds);
+
+    void Start();
+    void Mark(const char* phase);
+    void MarkFrameBuilt(const char* phase);
+    void MarkPresented();
+    void Cancel();
+    void Finish();
+
+    bool IsRunning() const { return _running; }
+    bool IsFinished() const { return _finished; }
+    bool IsOverBudget() const { return _finished && _total > _budget; }
+    const char* GetLabel() const { return _label; }
+    double GetTotal() const { return _total; }
+    double GetBudget() const { return _budget; }
+    int GetPhaseCount() const { return _count; }
+    const ProfilePhase& GetPhase(int index) const { return _phases[index]; }
+
+private:
+    const char* _label;
+    double _budget;
+    std::chrono::steady_clock::time_point _origin;
+    std::chrono::steady_clock::time_point _last;
+    ProfilePhase _phases[MAX_PHASES];
+    int _count;
+    double _total;
+    bool _frameBuilt;
+    bool _running;
+    bool _finished;
+};
+
+} // namespace tvk_media
@@ -0,0 +1,131 @@
+/**
+ * @file sync_benchmark.h
+ * @brief Flash-and-beep A/V sync verification through the player's own clocks
+ */
+
+#pragma once
+
+#include "audio_decoder.h"
+#include <cstdint>
+#include <string>
+
+namespace tvk_media {
+
+struct VideoFrame;
+
+enum class SyncAction {
+    None,
+    Play,
+    Pause,
+    Seek,
+    SwitchTrack,
+    Finish
+};
+
+enum class SyncPhase {
+    Start,
+    AfterPause,
+    AfterSeek,
+    AfterTrackSwitch,
+    Count
+};
+
+struct SyncBenchmarkSettings {
+    float trackOffsetMs = 40.0f;
+    float maxOffsetMs = 45.0f;
+    float maxDriftMs = 20.0f;
+};
+
+struct SyncPhaseResult {
+    int count = 0;
+    float meanMs = 0.0f;
+    float minMs = 0.0f;
+    float maxMs = 0.0f;
+};
+
+struct SyncBenchmarkReport {
+    static constexpr int MAX_MEASUREMENTS = 64;
+
+    float errorsMs[MAX_MEASUREMENTS];
+    double mediaTimes[MAX_MEASUREMENTS];
+    int count = 0;
+    SyncPhaseResult phases[static_cast<int>(SyncPhase::Count)];
+    float meanMs = 0.0f;
+    float stddevMs = 0.0f;
+    float worstMs = 0.0f;
+    float driftMs = 0.0f;
+    bool finished = false;
+    bool passed = false;
+    const char* failure = "";
+};
+
+class SyncBenchmark : public AudioCaptureSink {
+public:
+    static constexpr int FPS = 25;
+    static constexpr int WIDTH = 320;
+    static constexpr int HEIGHT = 180;
+    static constexpr int SAMPLE_RATE = 48000;
+    static constexpr double MEDIA_DURATION = 24.0;
+    static constexpr double EVENT_INTERVAL = 1.0;
+    static constexpr double EVENT_LENGTH = 0.08;
+    static constexpr double SEEK_TARGET = 12.0;
+    static constexpr int TRACK_COUNT = 2;
+
+    SyncBenchmark();
+
+    static bool GenerateMedia(const std::string& path, float trackOffsetMs, bool compressed = false);
+    static std::string GetMediaPath();
+
+    void Start(double now);
+    void Cancel();
+    SyncAction Update(double now, double audioClock, bool audioPlaying);
+    void OnFramePresented(double now, const VideoFrame& frame);
+    void OnAudioBuffer(double startTime, const int16_t* samples, int frames, int channels, int sampleRate) override;
+
+    bool IsRunning() const { return _running; }
+    int GetTrack() const { return _track; }
+    const SyncBenchmarkReport& GetReport() const { return _report; }
+
+    SyncBenchmarkSettings& GetSettings() { return _settings; }
+    const SyncBenchmarkSettings& GetSettings() const { return _settings; }
+
+    static const char* GetPhaseName(SyncPhase phase);
+
+private:
+    static constexpr int MAX_EVENTS = 8;
+
+    struct SyncEvent {
+        int slot;
+        int segment;
+        double wall;
+    };
+
+    void AddFlash(int slot, double wall);
+    void AddBeep(int slot, double wall);
+    void Measure(int slot, double flashWall, double beepWall);
+    void Finish();
+    float GetTrackOffset() const;
+
+    SyncBenchmarkSettings _settings;
+    SyncBenchmarkReport _report;
+    SyncEvent _flashes[MAX_EVENTS];
+    SyncEvent _beeps[MAX_EVENTS];
+    int _flashCount;
+    int _beepCount;
+
+    double _pendingBeeps[MAX_EVENTS];
+    int _pendingCount;
+    double _lastLoudTime;
+    bool _lastFrameBright;
+
+    double _lastNow;
+    double _lastClock;
+    double _stepEnd;
+    int _step;
+    int _segment;
+    int _track;
+    SyncPhase _phase;
+    bool _running;
+};
+
+} // namespace tvk_media
@@ -0,0 +1,15 @@
+/**
+ * @file text_file.h
+ * @brief Reads short sysfs, procfs and cgroup attribute files into a fixed buffer
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace tvk_media {
+
+// Reads at most size - 1 bytes and strips trailing newlines and spaces; false when missing or empty
+bool ReadTextFile(const char* path, char* buffer, size_t size);
+
+} // namespace tvk_media
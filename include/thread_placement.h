@@ -0,0 +1,69 @@
+/**
+ * @file thread_placement.h
+ * @brief Per-thread-class CPU affinity and NUMA-local memory placement
+ */
+
+#pragma once
+
+#include "cpu_topology.h"
+#include <cstddef>
+
+namespace tvk_media {
+
+enum class ThreadClass {
+    Decode,
+    Audio,
+    Background,
+    Count
+};
+
+struct ThreadPlacementSettings {
+    bool enabled = true;
+    bool isolateAudio = true;
+    bool performanceDecode = true;
+    bool efficiencyBackground = true;
+    bool numaLocalFrames = true;
+};
+
+class ThreadPlacement {
+public:
+    ThreadPlacement();
+
+    void Init();
+    void Replan();
+
+    bool Apply(ThreadClass threadClass) const;
+    void BindMemory(void* data, size_t size, ThreadClass threadClass) const;
+
+    const CpuSet& GetSet(ThreadClass threadClass) const { return _sets[static_cast<int>(threadClass)]; }
+    int GetNode(ThreadClass threadClass) const { return _nodes[static_cast<int>(threadClass)]; }
+    const CpuTopology& GetTopology() const { return _topology; }
+
+    ThreadPlacementSettings& GetSettings() { return _settings; }
+    const ThreadPlacementSettings& GetSettings() const { return _settings; }
+
+    static const char* GetClassName(ThreadClass threadClass);
+
+private:
+    int PickDecodeNode() const;
+
+    CpuTopology _topology;
+    ThreadPlacementSettings _settings;
+    CpuSet _sets[static_cast<int>(ThreadClass::Count)];
+    int _nodes[static_cast<int>(ThreadClass::Count)];
+};
+
+class ScopedThreadPlacement {
+public:
+    ScopedThreadPlacement(const ThreadPlacement& placement, ThreadClass target, ThreadClass restore);
+    ~ScopedThreadPlacement();
+
+    ScopedThreadPlacement(const ScopedThreadPlacement&) = delete;
+    ScopedThreadPlacement& operator=(const ScopedThreadPlacement&) = delete;
+
+private:
+    const ThreadPlacement& _placement;
+    ThreadClass _restore;
+};
+
+} // namespace tvk_media
@@ -0,0 +1,68 @@
+/**
+ * @file thread_stats.h
+ * @brief Per-thread CPU time, context switches and run-queue delay grouped by role
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace tvk_media {
+
+enum class ThreadRole {
+    Main,
+    FFmpeg,
+    Audio,
+    Background,
+    Other,
+    Count
+};
+
+struct ThreadRoleStats {
+    int threads = 0;
+    double cpuPercent = 0.0;
+    double peakThreadPercent = 0.0;
+    double voluntaryPerSecond = 0.0;
+    double involuntaryPerSecond = 0.0;
+    double runDelayMsPerSecond = 0.0;
+};
+
+class ThreadStats {
+public:
+    static constexpr double SAMPLE_INTERVAL = 1.0;
+    static constexpr int MAX_THREADS = 128;
+
+    ThreadStats();
+
+    static void RegisterCurrentThread(ThreadRole role);
+
+    bool Update(double now);
+
+    bool IsAvailable() const { return _available; }
+    bool HasRunDelay() const { return _hasRunDelay; }
+    const ThreadRoleStats& GetRole(ThreadRole role) const { return _roles[static_cast<int>(role)]; }
+
+    static const char* GetRoleName(ThreadRole role);
+
+private:
+    struct ThreadEntry {
+        int tid;
+        ThreadRole role;
+        uint64_t cpuNs;
+        uint64_t waitNs;
+        uint64_t voluntary;
+        uint64_t involuntary;
+        bool seen;
+    };
+
+    ThreadEntry* FindEntry(int tid);
+
+    ThreadEntry _threads[MAX_THREADS];
+    int _threadCount;
+    ThreadRoleStats _roles[static_cast<int>(ThreadRole::Count)];
+    double _lastSample;
+    bool _available;
+    bool _hasRunDelay;
+};
+
+} // namespace tvk_media
@@ -0,0 +1,124 @@
+/**
+ * @file thumbnail_pyramid.h
+ * @brief Multi-level timeline thumbnails built in the background, cached on disk and packed into an atlas
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace tvk_media {
+
+class ThreadPlacement;
+
+struct PyramidTile {
+    float u0 = 0.0f;
+    float v0 = 0.0f;
+    float u1 = 0.0f;
+    float v1 = 0.0f;
+    double start = 0.0;
+    double end = 0.0;
+    int level = -1;
+};
+
+class ThumbnailPyramid {
+public:
+    static constexpr int TILE_WIDTH = 64;
+    static constexpr int TILE_HEIGHT = 36;
+    static constexpr int BASE_TILES = 64;
+    static constexpr int MAX_LEVELS = 12;
+    static constexpr int EAGER_LEVELS = 3;
+    static constexpr double MIN_TILE_SECONDS = 1.0;
+    static constexpr int ATLAS_SIZE = 1024;
+    static constexpr int ATLAS_COLUMNS = ATLAS_SIZE / TILE_WIDTH;
+    static constexpr int ATLAS_ROWS = ATLAS_SIZE / TILE_HEIGHT;
+    static constexpr int ATLAS_SLOTS = ATLAS_COLUMNS * ATLAS_ROWS;
+    static constexpr int MAX_TILES_PER_UPDATE = 32;
+    static constexpr uint64_t MAX_CACHE_BYTES = 512ull << 20;
+
+    ThumbnailPyramid();
+    ~ThumbnailPyramid();
+
+    ThumbnailPyramid(const ThumbnailPyramid&) = delete;
+    ThumbnailPyramid& operator=(const ThumbnailPyramid&) = delete;
+
+    bool Open(const std::string& mediaPath, double duration, const ThreadPlacement* placement);
+    void Close();
+
+    int ChooseLevel(double secondsPerTile) const;
+    void RequestRange(int level, double start, double end);
+    bool Update();
+    bool GetTile(int level, int index, PyramidTile& out);
+
+    bool IsOpen() const { return _levels > 0; }
+    int GetLevelCount() const { return _levels; }
+    int GetTileCount(int level) const { return BASE_TILES << level; }
+    double GetTileSeconds(int level) const { return _duration / GetTileCount(level); }
+    double GetDuration() const { return _duration; }
+    const std::vector<uint8_t>& GetAtlas() const { return _atlas; }
+    const std::string& GetCachePath() const { return _cachePath; }
+    int GetResidentCount() const { return static_cast<int>(_slotOfTile.size()); }
+    uint64_t GetDecodedCount() const { return _decoded; }
+    uint64_t GetDiskReadCount() const { return _diskReads; }
+
+private:
+    struct Slot {
+        int tile = -1;
+        uint64_t lastUsed = 0;
+    };
+
+    struct Completed {
+        int tile;
+        std::vector<uint8_t> pixels;
+    };
+
+    int GetTileId(int level, int index) const { return BASE_TILES * ((1 << level) - 1) + index; }
+    int GetTotalTiles() const { return GetTileId(_levels, 0); }
+    double GetTileTime(int tile) const;
+
+    void WorkerLoop(std::string mediaPath, const ThreadPlacement* placement);
+    int PickTile(bool& eager);
+    bool LoadCache();
+    void TrimCache();
+    bool ReadTile(uint32_t ordinal, std::vector<uint8_t>& packed);
+    bool WriteTile(int tile, const std::vector<uint8_t>& packed);
+    void PlaceTile(int tile, const std::vector<uint8_t>& pixels);
+
+    std::string _cachePath;
+    uint64_t _mediaSize;
+    int64_t _mediaTime;
+    double _duration;
+    int _levels;
+
+    std::thread _worker;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::vector<uint32_t> _index;
+    std::vector<uint8_t> _requested;
+    std::vector<int> _wanted;
+    std::deque<Completed> _completed;
+    uint32_t _stored;
+    int _eagerNext;
+    int _eagerEnd;
+    bool _stopping;
+    FILE* _file;
+    std::atomic<uint64_t> _decoded;
+    std::atomic<uint64_t> _diskReads;
+
+    std::vector<uint8_t> _atlas;
+    std::vector<Slot> _slots;
+    std::unordered_map<int, int> _slotOfTile;
+    std::vector<int> _candidates;
+    uint64_t _frame;
+};
+
+} // namespace tvk_media
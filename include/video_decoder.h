@@ -10,9 +10,15 @@ extern "C" {
 #include <libavformat/avformat.h>
 #include <libavutil/imgutils.h>
 #include <libavutil/hwcontext.h>
+#include <libavutil/film_grain_params.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 }
 
+#include "image_sequence.h"
+#include "packet_cache.h"
+#include "raw_video.h"
+#include <chrono>
 #include <string>
 #include <vector>
 
@@ -28,15 +34,28 @@ enum class HWAccelType {
     QSV
 };
 
+struct FilmGrain {
+    bool present = false;
+    int subsamplingX = 1;
+    int subsamplingY = 1;
+    AVFilmGrainParams params;
+};
+
 struct VideoFrame {
     std::vector<uint8_t> data;
     int width;
     int height;
     double timestamp;
+    FilmGrain grain;
+    RawFrame raw;
+    const AVFrame* source = nullptr;
 };
 
 class VideoDecoder {
 public:
+    // Decoded frames kept for direct conversion: a full frame queue plus the current and in-flight ones
+    static constexpr int MAX_SOURCE_FRAMES = 20;
+
     VideoDecoder();
     ~VideoDecoder();
 
@@ -45,32 +64,72 @@ public:
 
     bool Open(const std::string& filepath);
     void Close();
-    bool DecodeNextFrame(VideoFrame& outFrame);
+    bool DecodeNextFrame(VideoFrame& outFrame, double skipBudget = 0.0);
     bool Seek(double timeSeconds);
+    void SkipTo(double timeSeconds);
+    void SetScrubbing(bool enabled);
+    double GetKeyframeTime(double timeSeconds) const;
     bool GetThumbnailAt(double timeSeconds, VideoFrame& outFrame, int maxWidth, int maxHeight);
+    void SetThreadCount(int threads) { _threadCount = threads; }
+    bool RestartCodec();
+    void SetForwardSeek(bool enabled) { _forwardSeek = enabled; }
+    void SetRawPassthrough(bool enabled) { _rawPassthrough = enabled; }
+    void SetDirectConversion(bool enabled) { _directConversion = enabled; }
+    bool ConvertFrame(const VideoFrame& frame, uint8_t* dest, size_t pitch);
+    void ReleaseCaches();
+    void SetCacheBudget(size_t bytes);
+    bool HasFrameReady();
+    const PacketCache& GetPacketCache() const { return _packetCache; }
+    const ImageSequence& GetImageSequence() const { return _sequence; }
 
     double GetDuration() const { return _duration; }
     double GetCurrentTime() const { return _currentTime; }
     int GetWidth() const { return _width; }
     int GetHeight() const { return _height; }
     double GetFPS() const { return _fps; }
-    bool IsOpen() const { return _formatContext != nullptr; }
+    bool IsOpen() const { return _formatContext != nullptr || _sequence.IsOpen(); }
+    bool IsSequence() const { return _sequence.IsOpen(); }
+    bool IsRaw() const { return _raw.IsOpen(); }
+    bool IsRawPassthrough() const { return _raw.IsOpen() && _rawPassthrough; }
+    bool WritesFrameData() const { return _raw.IsOpen() ? !_rawPassthrough : !_directConversion; }
+    RawFormat GetRawFormat() const { return _raw.GetFormat(); }
+    bool IsSkipping() const { return _skipUntil >= 0.0; }
+    bool IsScrubbing() const { return _scrubbing; }
     bool IsHardwareAccelerated() const { return _hwAccelType != HWAccelType::None; }
     HWAccelType GetHWAccelType() const { return _hwAccelType; }
     const char* GetHWAccelName() const;
+    const char* GetContainerName() const;
+    const char* GetCodecName() const;
+    uint64_t GetForwardSeekCount() const { return _forwardSeeks; }
+    uint64_t GetKeyframeSeekCount() const { return _keyframeSeeks; }
+    double GetDecodeSeconds() const { return _decodeSeconds; }
+    double GetSeekSeconds() const { return _seekSeconds; }
 
 private:
     bool InitHardwareDecoder(const AVCodec* codec);
     bool TransferHWFrame(AVFrame* hwFrame, AVFrame* swFrame);
+    int ReadPacket();
+    int ResyncDemuxer();
+    bool PrepareScaler(const AVFrame* source);
+    bool FindKeyframe(int64_t timestamp, int64_t& out) const;
+    bool ShouldDecodeForward(double timeSeconds) const;
+    bool ReadRawFrame(VideoFrame& outFrame);
+    bool ConvertRawFrame(const RawFrame& raw, SwsContext*& sws, VideoFrame& outFrame, int width, int height);
     
     AVFormatContext* _formatContext;
     AVCodecContext* _codecContext;
     AVStream* _videoStream;
     SwsContext* _swsContext;
+    SwsContext* _thumbSwsContext;
     AVFrame* _frame;
     AVFrame* _swFrame;
+    AVFrame* _sources[MAX_SOURCE_FRAMES];
+    int _nextSource;
     AVPacket* _packet;
     AVBufferRef* _hwDeviceCtx;
+    PacketCache _packetCache;
+    ImageSequence _sequence;
+    RawVideoFile _raw;
 
     int _videoStreamIndex;
     int _width;
@@ -83,6 +142,21 @@ private:
     AVPixelFormat _swsSourceFormat;
     int _swsSourceWidth;
     int _swsSourceHeight;
+    int _threadCount;
+    bool _forwardSeek;
+    bool _hasPosition;
+    bool _scrubbing;
+    bool _resyncDemuxer;
+    bool _rawPassthrough;
+    bool _directConversion;
+    int _rawIndex;
+    double _skipUntil;
+    double _decodeSeconds;
+    double _seekSeconds;
+    bool _timingSeek;
+    std::chrono::steady_clock::time_point _seekStart;
+    uint64_t _forwardSeeks;
+    uint64_t _keyframeSeeks;
 
     void Cleanup();
 };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "gpu_compute.h"
+#include "film_grain.h"
 #include <tinyvk/tinyvk.h>
 #include <vulkan/vulkan.h>
 #include <cstdint>
@@ -99,6 +101,29 @@ struct PostProcessSettings {
     }
 };
 
+struct StabilizationSettings {
+    bool enabled = false;
+    int smoothingRadius = 8;
+    float maxCorrection = 0.06f;
+    
+    bool IsDefault() const {
+        return !enabled;
+    }
+    
+    void Reset() {
+        enabled = false;
+        smoothingRadius = 8;
+        maxCorrection = 0.06f;
+    }
+};
+
+struct StabilizationTransform {
+    float dx = 0.0f;
+    float dy = 0.0f;
+    float angle = 0.0f;
+    float zoom = 1.0f;
+};
+
 struct EffectsPushConstants {
     float brightness;
     float contrast;
@@ -125,7 +150,7 @@ struct EffectsPushConstants {
     float scanlines;
     float vintageStrength;
     
-    int vintageEnabled;
+    int step;
     int width;
     int height;
     int frameCounter;
@@ -133,7 +158,12 @@ struct EffectsPushConstants {
     float bloom;
     float bloomThreshold;
     float bloomRadius;
-    int pad0;
+    int stabilize;
+    
+    float stabDx;
+    float stabDy;
+    float stabAngle;
+    float stabZoom;
 };
 
 class VideoEffects {
@@ -149,36 +179,36 @@ public:
     ColorAdjustments& GetColorAdjustments() { return _colorAdjust; }
     FilterSettings& GetFilterSettings() { return _filter; }
     PostProcessSettings& GetPostProcess() { return _postProcess; }
+    StabilizationSettings& GetStabilization() { return _stabilization; }
     
     const ColorAdjustments& GetColorAdjustments() const { return _colorAdjust; }
     const FilterSettings& GetFilterSettings() const { return _filter; }
     const PostProcessSettings& GetPostProcess() const { return _postProcess; }
+    const StabilizationSettings& GetStabilization() const { return _stabilization; }
+    
+    void SetStabilizationTransform(const StabilizationTransform& transform) { _stabTransform = transform; }
+    
+    void SetFilmGrain(const FilmGrain& grain, int width, int height);
+    FilmGrainSettings& GetFilmGrainSettings() { return _filmGrain.GetSettings(); }
+    const FilmGrainSettings& GetFilmGrainSettings() const { return _filmGrain.GetSettings(); }
+    
+    void SetStep(int step) { _step = step > 0 ? step : 1; }
+    int GetStep() const { return _step; }
     
     bool HasActiveEffects() const;
     void ResetAll();
     
 private:
-    bool CreateComputePipeline();
-    bool CreateDescriptorSetLayout();
-    bool AllocateDescriptorSet();
     void UpdateDescriptorSet(VkImageView srcView, VkImageView dstView);
-    bool CreateStagingImage(uint32_t width, uint32_t height);
-    void DestroyStagingImage();
+    bool EnsurePipeline();
+    bool EnsureFilmGrain();
     
     tvk::Renderer* _renderer;
     tvk::VulkanContext* _context;
     
-    VkPipeline _computePipeline;
-    VkPipelineLayout _pipelineLayout;
-    VkDescriptorSetLayout _descriptorSetLayout;
+    ComputePipeline _pipeline;
     VkDescriptorSet _descriptorSet;
-    VkShaderModule _shaderModule;
-    
-    VkImage _stagingImage;
-    VkDeviceMemory _stagingMemory;
-    VkImageView _stagingImageView;
-    uint32_t _stagingWidth;
-    uint32_t _stagingHeight;
+    StorageImage _staging;
     
     VkImageView _lastSrcView;
     VkImageView _lastDstView;
@@ -186,8 +216,15 @@ private:
     ColorAdjustments _colorAdjust;
     FilterSettings _filter;
     PostProcessSettings _postProcess;
+    StabilizationSettings _stabilization;
+    StabilizationTransform _stabTransform;
+    FilmGrainSynthesizer _filmGrain;
     uint32_t _frameCounter;
+    int _step;
     
+    bool _pipelineReady;
+    bool _pipelineFailed;
+    bool _filmGrainFailed;
     bool _initialized;
 };
 
@@ -0,0 +1,69 @@
+/**
+ * @file video_stabilizer.h
+ * @brief Global motion estimation and trajectory smoothing for video stabilization
+ */
+
+#pragma once
+
+#include "video_decoder.h"
+#include "video_effects.h"
+#include "frame_queue.h"
+#include <cstdint>
+
+namespace tvk_media {
+
+class VideoStabilizer {
+public:
+    static constexpr int MAX_RADIUS = FrameQueue::MAX_FRAMES - 1;
+
+    VideoStabilizer();
+
+    VideoStabilizer(const VideoStabilizer&) = delete;
+    VideoStabilizer& operator=(const VideoStabilizer&) = delete;
+
+    void Reset();
+    void Analyze(const VideoFrame& frame);
+    StabilizationTransform Resolve(double timestamp, const StabilizationSettings& settings) const;
+
+    double GetAnalyzeSeconds() const { return _analyzeSeconds; }
+    double GetPeakAnalyzeSeconds() const { return _peakAnalyzeSeconds; }
+
+private:
+    static constexpr int LUMA_MAX_WIDTH = 320;
+    static constexpr int LUMA_MAX_HEIGHT = 192;
+    static constexpr int HISTORY = 64;
+    static constexpr int GRID_X = 6;
+    static constexpr int GRID_Y = 4;
+    static constexpr int BLOCK = 16;
+    static constexpr int SEARCH = 12;
+    static constexpr int SEARCH_SIZE = SEARCH * 2 + 1;
+
+    struct TrajectoryPoint {
+        double timestamp;
+        float x;
+        float y;
+        float angle;
+    };
+
+    void DownscaleLuma(const VideoFrame& frame, uint8_t* dst) const;
+    bool EstimateMotion(float& dx, float& dy, float& angle) const;
+    const TrajectoryPoint& PointAt(int index) const;
+
+    uint8_t _luma[2][LUMA_MAX_WIDTH * LUMA_MAX_HEIGHT];
+    int _current;
+    int _lumaWidth;
+    int _lumaHeight;
+    int _step;
+    int _sourceWidth;
+    int _sourceHeight;
+    bool _hasPrevious;
+
+    TrajectoryPoint _trajectory[HISTORY];
+    int _trajectoryHead;
+    int _trajectoryCount;
+
+    double _analyzeSeconds;
+    double _peakAnalyzeSeconds;
+};
+
+} // namespace tvk_media
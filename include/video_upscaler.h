@@ -0,0 +1,95 @@
+/**
+ * @file video_upscaler.h
+ * @brief Edge-adaptive upscaling and contrast-adaptive sharpening compute passes
+ */
+
+#pragma once
+
+#include "gpu_compute.h"
+#include <tinyvk/tinyvk.h>
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+namespace tvk_media {
+
+struct UpscaleSettings {
+    bool enabled = true;
+    float sharpness = 0.2f;
+
+    bool IsDefault() const {
+        return enabled && sharpness == 0.2f;
+    }
+
+    void Reset() {
+        enabled = true;
+        sharpness = 0.2f;
+    }
+};
+
+struct UpscalePushConstants {
+    int inputWidth;
+    int inputHeight;
+    int outputWidth;
+    int outputHeight;
+
+    float sharpness;
+    int pad0;
+    int pad1;
+    int pad2;
+};
+
+class VideoUpscaler {
+public:
+    static constexpr uint32_t MAX_OUTPUT_SIZE = 8192;
+    static constexpr int RETIRE_FRAMES = 3;
+
+    VideoUpscaler();
+    ~VideoUpscaler();
+
+    VideoUpscaler(const VideoUpscaler&) = delete;
+    VideoUpscaler& operator=(const VideoUpscaler&) = delete;
+
+    bool Init(tvk::Renderer* renderer);
+    void Cleanup();
+
+    bool Process(tvk::Texture* source, uint32_t outputWidth, uint32_t outputHeight, bool sourceChanged);
+    tvk::Texture* GetOutput() const { return _active ? _output.get() : nullptr; }
+    bool IsActive() const { return _active; }
+
+    UpscaleSettings& GetSettings() { return _settings; }
+    const UpscaleSettings& GetSettings() const { return _settings; }
+
+private:
+    struct RetiredOutput {
+        StorageImage intermediate;
+        tvk::Ref<tvk::Texture> output;
+        int frames = 0;
+    };
+
+    bool CreateOutput(uint32_t width, uint32_t height);
+    bool EnsurePipelines();
+    void ReleaseRetired(bool all);
+
+    tvk::Renderer* _renderer;
+    tvk::VulkanContext* _context;
+
+    ComputePipeline _easu;
+    ComputePipeline _rcas;
+    VkDescriptorSet _easuSet;
+    VkDescriptorSet _rcasSet;
+    StorageImage _intermediate;
+    tvk::Ref<tvk::Texture> _output;
+    std::vector<RetiredOutput> _retired;
+
+    VkImageView _lastSourceView;
+    float _lastSharpness;
+    UpscaleSettings _settings;
+
+    bool _active;
+    bool _pipelinesReady;
+    bool _pipelinesFailed;
+    bool _initialized;
+};
+
+} // namespace tvk_media
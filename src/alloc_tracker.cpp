@@ -0,0 +1,157 @@
+#include "alloc_tracker.h"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace tvk_media {
+
+static constexpr int STAGE_COUNT = static_cast<int>(AllocStage::Count);
+
+static std::atomic<uint64_t> g_allocCounts[STAGE_COUNT];
+static std::atomic<uint64_t> g_allocBytes[STAGE_COUNT];
+static thread_local AllocStage t_allocStage = AllocStage::Other;
+
+static inline void RecordAllocation(size_t size) {
+    int stage = static_cast<int>(t_allocStage);
+    g_allocCounts[stage].fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes[stage].fetch_add(size, std::memory_order_relaxed);
+}
+
+AllocStage AllocTracker::SetStage(AllocStage stage) {
+    AllocStage previous = t_allocStage;
+    t_allocStage = stage;
+    return previous;
+}
+
+AllocStage AllocTracker::GetStage() {
+    return t_allocStage;
+}
+
+AllocStats AllocTracker::GetStats(AllocStage stage) {
+    AllocStats stats;
+    int index = static_cast<int>(stage);
+    if (index < 0 || index >= STAGE_COUNT) return stats;
+    stats.count = g_allocCounts[index].load(std::memory_order_relaxed);
+    stats.bytes = g_allocBytes[index].load(std::memory_order_relaxed);
+    return stats;
+}
+
+AllocStats AllocTracker::GetPlaybackStats() {
+    AllocStats total;
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        if (!IsPlaybackStage(static_cast<AllocStage>(i))) continue;
+        AllocStats stats = GetStats(static_cast<AllocStage>(i));
+        total.count += stats.count;
+        total.bytes += stats.bytes;
+    }
+    return total;
+}
+
+bool AllocTracker::IsPlaybackStage(AllocStage stage) {
+    switch (stage) {
+        case AllocStage::Decode:
+        case AllocStage::Upload:
+        case AllocStage::Effects:
+        case AllocStage::Audio:
+            return true;
+        default:
+            return false;
+    }
+}
+
+const char* AllocTracker::GetStageName(AllocStage stage) {
+    switch (stage) {
+        case AllocStage::Other: return "other";
+        case AllocStage::Demux: return "demux";
+        case AllocStage::Codec: return "codec";
+        case AllocStage::Decode: return "decode";
+        case AllocStage::Upload: return "upload";
+        case AllocStage::Effects: return "effects";
+        case AllocStage::Audio: return "audio";
+        case AllocStage::Thumbnail: return "thumbnail";
+        case AllocStage::Interface: return "interface";
+        default: return "unknown";
+    }
+}
+
+} // namespace tvk_media
+
+#if defined(TVK_MEDIA_TRACK_ALLOCATIONS)
+#if defined(__GLIBC__)
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void* malloc(size_t size) {
+    tvk_media::RecordAllocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    tvk_media::RecordAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    tvk_media::RecordAllocation(size);
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    tvk_media::RecordAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    tvk_media::RecordAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) return EINVAL;
+    tvk_media::RecordAllocation(size);
+    void* result = __libc_memalign(alignment, size);
+    if (!result) return ENOMEM;
+    *ptr = result;
+    return 0;
+}
+
+} // extern "C"
+
+#else
+
+static void* TrackedNew(size_t size) {
+    tvk_media::RecordAllocation(size);
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(size_t size) { return TrackedNew(size); }
+void* operator new[](size_t size) { return TrackedNew(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    tvk_media::RecordAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    tvk_media::RecordAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+#endif
+#endif
@@ -1,9 +1,18 @@
 #include "audio_decoder.h"
+#include "alloc_tracker.h"
 #include <tinyvk/core/log.h>
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 
 namespace tvk_media {
 
+static std::atomic<int> g_openALObjects{0};
+
+int AudioDecoder::GetOpenALObjectCount() {
+    return g_openALObjects.load(std::memory_order_relaxed);
+}
+
 AudioDecoder::AudioDecoder()
     : _formatContext(nullptr)
     , _codecContext(nullptr)
@@ -13,23 +22,38 @@ AudioDecoder::AudioDecoder()
     , _packet(nullptr)
     , _audioStreamIndex(-1)
     , _sampleRate(0)
+    , _sourceRate(0)
+    , _deviceRate(0)
+    , _resamplerName("none")
+    , _drift(0.0)
+    , _correction(0.0)
+    , _speed(1.0)
     , _channels(0)
     , _duration(0.0)
     , _currentTime(0.0)
     , _volume(1.0f)
+    , _bufferScale(1)
+    , _captureSink(nullptr)
     , _alDevice(nullptr)
     , _alContext(nullptr)
     , _alSource(0)
+    , _queuedHead(0)
+    , _queuedCount(0)
+    , _underruns(0)
     , _isPlaying(false)
     , _hasAudio(false)
 {
     for (int i = 0; i < NUM_BUFFERS; i++) {
         _alBuffers[i] = 0;
+        _bufferStart[i] = -1.0;
+        _bufferCorrection[i] = 0.0;
+        _bufferRate[i] = 1.0;
     }
 }
 
 AudioDecoder::~AudioDecoder() {
     Close();
+    CleanupOpenAL();
 }
 
 bool AudioDecoder::InitOpenAL() {
@@ -49,36 +73,98 @@ bool AudioDecoder::InitOpenAL() {
         return false;
     }
 
+    ALCint frequency = 0;
+    alcGetIntegerv(_alDevice, ALC_FREQUENCY, 1, &frequency);
+    _deviceRate = frequency > 0 ? frequency : 0;
+
     alGenBuffers(NUM_BUFFERS, _alBuffers);
     alGenSources(1, &_alSource);
     alSourcef(_alSource, AL_GAIN, _volume);
+    g_openALObjects.fetch_add(NUM_BUFFERS + 3, std::memory_order_relaxed);
     return true;
 }
 
+void AudioDecoder::ResetSource() {
+    if (!_alSource) return;
+    alSourceStop(_alSource);
+    ALint queued = 0;
+    alGetSourcei(_alSource, AL_BUFFERS_QUEUED, &queued);
+    while (queued-- > 0) {
+        ALuint buf = 0;
+        alSourceUnqueueBuffers(_alSource, 1, &buf);
+    }
+    _queuedCount = 0;
+}
+
 void AudioDecoder::CleanupOpenAL() {
     if (_alSource) {
-        alSourceStop(_alSource);
-        ALint queued = 0;
-        alGetSourcei(_alSource, AL_BUFFERS_QUEUED, &queued);
-        while (queued-- > 0) {
-            ALuint buf = 0;
-            alSourceUnqueueBuffers(_alSource, 1, &buf);
-        }
+        ResetSource();
         alDeleteSources(1, &_alSource);
         _alSource = 0;
+        g_openALObjects.fetch_sub(1, std::memory_order_relaxed);
     }
     if (_alBuffers[0]) {
         alDeleteBuffers(NUM_BUFFERS, _alBuffers);
         for (int i = 0; i < NUM_BUFFERS; i++) _alBuffers[i] = 0;
+        g_openALObjects.fetch_sub(NUM_BUFFERS, std::memory_order_relaxed);
     }
     if (_alContext) {
         alcMakeContextCurrent(nullptr);
         alcDestroyContext(_alContext);
         _alContext = nullptr;
+        g_openALObjects.fetch_sub(1, std::memory_order_relaxed);
     }
     if (_alDevice) {
         alcCloseDevice(_alDevice);
         _alDevice = nullptr;
+        g_openALObjects.fetch_sub(1, std::memory_order_relaxed);
+    }
+    _deviceRate = 0;
+}
+
+bool AudioDecoder::InitResampler() {
+    if (_swrContext) {
+        swr_free(&_swrContext);
+        _swrContext = nullptr;
+    }
+
+    _sourceRate = _codecContext->sample_rate;
+    _sampleRate = _deviceRate > 0 ? _deviceRate : _sourceRate;
+    _channels = _codecContext->ch_layout.nb_channels;
+
+    AVChannelLayout outLayout;
+    av_channel_layout_default(&outLayout, _channels > 2 ? 2 : _channels);
+
+    int ret = swr_alloc_set_opts2(&_swrContext,
+        &outLayout, AV_SAMPLE_FMT_S16, _sampleRate,
+        &_codecContext->ch_layout, _codecContext->sample_fmt, _sourceRate,
+        0, nullptr);
+    if (ret >= 0 && _swrContext) {
+        // Drift correction needs swr_set_compensation, which only the built-in engine implements (soxr does not)
+        av_opt_set_int(_swrContext, "resampler", SWR_ENGINE_SWR, 0);
+        if (swr_init(_swrContext) >= 0 && swr_set_compensation(_swrContext, 0, 0) >= 0) {
+            _resamplerName = "swr";
+            _channels = outLayout.nb_channels;
+            TVK_LOG_INFO("Audio resampler: {} Hz -> {} Hz ({})", _sourceRate, _sampleRate, _resamplerName);
+            return true;
+        }
+    }
+
+    swr_free(&_swrContext);
+    _swrContext = nullptr;
+    _resamplerName = "none";
+    return false;
+}
+
+void AudioDecoder::ResetDrift() {
+    _drift = 0.0;
+    _correction = 0.0;
+    for (int i = 0; i < NUM_BUFFERS; i++) {
+        _bufferCorrection[i] = 0.0;
+        _bufferRate[i] = 1.0;
+    }
+    if (_swrContext) {
+        swr_set_compensation(_swrContext, 0, 0);
     }
 }
 
@@ -143,25 +229,18 @@ bool AudioDecoder::Open(const std::string& filepath) {
         return false;
     }
 
-    _sampleRate = _codecContext->sample_rate;
-    _channels = _codecContext->ch_layout.nb_channels;
-
-    AVChannelLayout outLayout;
-    av_channel_layout_default(&outLayout, _channels > 2 ? 2 : _channels);
-
-    int ret = swr_alloc_set_opts2(&_swrContext,
-        &outLayout, AV_SAMPLE_FMT_S16, _sampleRate,
-        &_codecContext->ch_layout, _codecContext->sample_fmt, _codecContext->sample_rate,
-        0, nullptr);
+    if (!_alDevice && !InitOpenAL()) {
+        TVK_LOG_ERROR("Failed to initialize OpenAL");
+        Close();
+        return false;
+    }
 
-    if (ret < 0 || !_swrContext || swr_init(_swrContext) < 0) {
+    if (!InitResampler()) {
         TVK_LOG_ERROR("Failed to initialize audio resampler");
         Close();
         return false;
     }
 
-    _channels = outLayout.nb_channels;
-
     if (_formatContext->duration != AV_NOPTS_VALUE) {
         _duration = (double)_formatContext->duration / AV_TIME_BASE;
     } else if (_audioStream->duration != AV_NOPTS_VALUE) {
@@ -177,19 +256,14 @@ bool AudioDecoder::Open(const std::string& filepath) {
         return false;
     }
 
-    if (!InitOpenAL()) {
-        TVK_LOG_ERROR("Failed to initialize OpenAL");
-        Close();
-        return false;
-    }
-
     _currentTime = 0.0;
     _hasAudio = true;
+    ResetDrift();
 
     QueueBuffers();
 
     TVK_LOG_INFO("Audio opened successfully:");
-    TVK_LOG_INFO("  Sample Rate: {} Hz", _sampleRate);
+    TVK_LOG_INFO("  Sample Rate: {} Hz (output {} Hz)", _sourceRate, _sampleRate);
     TVK_LOG_INFO("  Channels: {}", _channels);
     TVK_LOG_INFO("  Duration: {} seconds", _duration);
 
@@ -227,6 +301,7 @@ bool AudioDecoder::SelectAudioStream(int stream_index, double sync_time) {
             ALuint buf = 0;
             alSourceUnqueueBuffers(_alSource, 1, &buf);
         }
+        _queuedCount = 0;
     }
 
     if (_swrContext) {
@@ -259,19 +334,7 @@ bool AudioDecoder::SelectAudioStream(int stream_index, double sync_time) {
     if (avcodec_parameters_to_context(_codecContext, codecParams) < 0) return false;
     if (avcodec_open2(_codecContext, codec, nullptr) < 0) return false;
 
-    _sampleRate = _codecContext->sample_rate;
-    _channels = _codecContext->ch_layout.nb_channels;
-
-    AVChannelLayout outLayout;
-    av_channel_layout_default(&outLayout, _channels > 2 ? 2 : _channels);
-    int ret = swr_alloc_set_opts2(&_swrContext,
-        &outLayout, AV_SAMPLE_FMT_S16, _sampleRate,
-        &_codecContext->ch_layout, _codecContext->sample_fmt, _codecContext->sample_rate,
-        0, nullptr);
-
-    if (ret < 0 || !_swrContext || swr_init(_swrContext) < 0) return false;
-
-    _channels = outLayout.nb_channels;
+    if (!InitResampler()) return false;
 
     _frame = av_frame_alloc();
     _packet = av_packet_alloc();
@@ -283,6 +346,7 @@ bool AudioDecoder::SelectAudioStream(int stream_index, double sync_time) {
         _currentTime = seek_time;
     }
 
+    ResetDrift();
     QueueBuffers();
 
     if (was_playing) {
@@ -300,7 +364,11 @@ void AudioDecoder::Close() {
 
 bool AudioDecoder::DecodeAudioPacket(std::vector<uint8_t>& outData) {
     while (true) {
-        int ret = av_read_frame(_formatContext, _packet);
+        int ret;
+        {
+            ScopedAllocStage demux(AllocStage::Demux);
+            ret = av_read_frame(_formatContext, _packet);
+        }
         if (ret < 0) {
             return false;
         }
@@ -310,14 +378,20 @@ bool AudioDecoder::DecodeAudioPacket(std::vector<uint8_t>& outData) {
             continue;
         }
 
-        ret = avcodec_send_packet(_codecContext, _packet);
-        av_packet_unref(_packet);
+        {
+            ScopedAllocStage codec(AllocStage::Codec);
+            ret = avcodec_send_packet(_codecContext, _packet);
+            av_packet_unref(_packet);
+        }
 
         if (ret < 0) {
             return false;
         }
 
-        ret = avcodec_receive_frame(_codecContext, _frame);
+        {
+            ScopedAllocStage codec(AllocStage::Codec);
+            ret = avcodec_receive_frame(_codecContext, _frame);
+        }
         if (ret == AVERROR(EAGAIN)) {
             continue;
         } else if (ret < 0) {
@@ -325,19 +399,20 @@ bool AudioDecoder::DecodeAudioPacket(std::vector<uint8_t>& outData) {
         }
 
         int outSamples = swr_get_out_samples(_swrContext, _frame->nb_samples);
-        int outSize = outSamples * _channels * sizeof(int16_t);
-        outData.resize(outSize);
+        size_t offset = outData.size();
+        outData.resize(offset + outSamples * _channels * sizeof(int16_t));
 
-        uint8_t* outPtr = outData.data();
+        uint8_t* outPtr = outData.data() + offset;
         int converted = swr_convert(_swrContext, &outPtr, outSamples,
                                     (const uint8_t**)_frame->data, _frame->nb_samples);
 
         if (converted < 0) {
+            outData.resize(offset);
             av_frame_unref(_frame);
             return false;
         }
 
-        outData.resize(converted * _channels * sizeof(int16_t));
+        outData.resize(offset + converted * _channels * sizeof(int16_t));
 
         if (_frame->pts != AV_NOPTS_VALUE) {
             _currentTime = _frame->pts * av_q2d(_audioStream->time_base);
@@ -349,38 +424,103 @@ bool AudioDecoder::DecodeAudioPacket(std::vector<uint8_t>& outData) {
 }
 
 bool AudioDecoder::FillBuffer(ALuint buffer) {
-    std::vector<uint8_t> audioData;
-    size_t totalSize = 0;
-    std::vector<uint8_t> combinedData;
-    combinedData.reserve(BUFFER_SIZE);
+    size_t targetSize = static_cast<size_t>(BUFFER_SIZE) * _bufferScale;
+    int distance = static_cast<int>(targetSize / (sizeof(int16_t) * _channels));
+    double pending = 0.0;
+    for (int i = 0; i < _queuedCount; i++) {
+        pending += _bufferCorrection[_queuedOrder[(_queuedHead + i) % NUM_BUFFERS]] * distance / _sampleRate;
+    }
+
+    int correction = 0;
+    double drift = _drift - pending;
+    if (std::fabs(drift) > DRIFT_TOLERANCE) {
+        double limit = distance * MAX_CORRECTION;
+        correction = static_cast<int>(std::lround(std::clamp(drift * _sampleRate, -limit, limit)));
+    }
+    int delta = static_cast<int>(std::lround(distance * (1.0 - _speed))) + correction;
+    swr_set_compensation(_swrContext, delta, delta ? distance : 0);
+    _correction = static_cast<double>(correction) / distance;
+
+    _bufferData.clear();
+    double start = -1.0;
 
-    while (totalSize < BUFFER_SIZE) {
-        if (!DecodeAudioPacket(audioData)) {
+    while (_bufferData.size() < targetSize) {
+        if (!DecodeAudioPacket(_bufferData)) {
             break;
         }
-        combinedData.insert(combinedData.end(), audioData.begin(), audioData.end());
-        totalSize += audioData.size();
+        if (start < 0.0) start = _currentTime;
     }
 
-    if (combinedData.empty()) {
+    if (_bufferData.empty()) {
         return false;
     }
 
     ALenum format = (_channels == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
-    alBufferData(buffer, format, combinedData.data(), (ALsizei)combinedData.size(), _sampleRate);
+    alBufferData(buffer, format, _bufferData.data(), (ALsizei)_bufferData.size(), _sampleRate);
+
+    int index = GetBufferIndex(buffer);
+    if (index >= 0) {
+        _bufferStart[index] = start;
+        _bufferCorrection[index] = _correction;
+        _bufferRate[index] = 1.0 - static_cast<double>(delta) / distance;
+    }
+
+    if (_captureSink && start >= 0.0) {
+        int frames = static_cast<int>(_bufferData.size() / (sizeof(int16_t) * _channels));
+        _captureSink->OnAudioBuffer(start, reinterpret_cast<const int16_t*>(_bufferData.data()), frames,
+                                    _channels, _sampleRate);
+    }
 
     return true;
 }
 
+void AudioDecoder::SetCaptureSink(AudioCaptureSink* sink) {
+    std::lock_guard<std::mutex> lock(_decodeMutex);
+    _captureSink = sink;
+}
+
 void AudioDecoder::QueueBuffers() {
     for (int i = 0; i < NUM_BUFFERS; i++) {
         if (!FillBuffer(_alBuffers[i])) {
             break;
         }
-        alSourceQueueBuffers(_alSource, 1, &_alBuffers[i]);
+        QueueBuffer(_alBuffers[i]);
     }
 }
 
+void AudioDecoder::QueueBuffer(ALuint buffer) {
+    alSourceQueueBuffers(_alSource, 1, &buffer);
+    int index = GetBufferIndex(buffer);
+    if (index < 0 || _queuedCount >= NUM_BUFFERS) return;
+    _queuedOrder[(_queuedHead + _queuedCount) % NUM_BUFFERS] = index;
+    _queuedCount++;
+}
+
+int AudioDecoder::GetBufferIndex(ALuint buffer) const {
+    for (int i = 0; i < NUM_BUFFERS; i++) {
+        if (_alBuffers[i] == buffer) return i;
+    }
+    return -1;
+}
+
+double AudioDecoder::GetPlaybackTime() {
+    std::lock_guard<std::mutex> lock(_decodeMutex);
+    if (!_hasAudio || _queuedCount == 0) return _currentTime;
+
+    double start = _bufferStart[_queuedOrder[_queuedHead]];
+    if (start < 0.0) return _currentTime;
+
+    ALfloat offset = 0.0f;
+    alGetSourcef(_alSource, AL_SEC_OFFSET, &offset);
+    return start + offset * _bufferRate[_queuedOrder[_queuedHead]];
+}
+
+void AudioDecoder::SyncToClock(double clockTime) {
+    if (!_hasAudio || !_isPlaying) return;
+    double drift = GetPlaybackTime() - clockTime;
+    _drift += (drift - _drift) * DRIFT_SMOOTHING;
+}
+
 void AudioDecoder::Play() {
     if (!_hasAudio) return;
     alSourcePlay(_alSource);
@@ -415,6 +555,7 @@ bool AudioDecoder::Seek(double timeSeconds) {
         ALuint buffer;
         alSourceUnqueueBuffers(_alSource, 1, &buffer);
     }
+    _queuedCount = 0;
 
     int64_t timestamp = (int64_t)(timeSeconds / av_q2d(_audioStream->time_base));
     if (av_seek_frame(_formatContext, _audioStreamIndex, timestamp, AVSEEK_FLAG_BACKWARD) < 0) {
@@ -424,6 +565,7 @@ bool AudioDecoder::Seek(double timeSeconds) {
     avcodec_flush_buffers(_codecContext);
     _currentTime = timeSeconds;
 
+    ResetDrift();
     QueueBuffers();
 
     if (was_playing) {
@@ -447,9 +589,13 @@ void AudioDecoder::Update() {
     while (processed-- > 0) {
         ALuint buffer;
         alSourceUnqueueBuffers(_alSource, 1, &buffer);
+        if (_queuedCount > 0) {
+            _queuedHead = (_queuedHead + 1) % NUM_BUFFERS;
+            _queuedCount--;
+        }
 
         if (FillBuffer(buffer)) {
-            alSourceQueueBuffers(_alSource, 1, &buffer);
+            QueueBuffer(buffer);
         }
     }
 
@@ -457,6 +603,7 @@ void AudioDecoder::Update() {
         ALint queued;
         alGetSourcei(_alSource, AL_BUFFERS_QUEUED, &queued);
         if (queued > 0) {
+            _underruns++;
             alSourcePlay(_alSource);
         } else {
             _isPlaying = false;
@@ -474,7 +621,7 @@ void AudioDecoder::SetVolume(float volume) {
 }
 
 void AudioDecoder::Cleanup() {
-    CleanupOpenAL();
+    ResetSource();
 
     if (_swrContext) {
         swr_free(&_swrContext);
@@ -504,6 +651,10 @@ void AudioDecoder::Cleanup() {
     _audioStream = nullptr;
     _audioStreamIndex = -1;
     _sampleRate = 0;
+    _sourceRate = 0;
+    _resamplerName = "none";
+    _drift = 0.0;
+    _correction = 0.0;
     _channels = 0;
     _duration = 0.0;
     _currentTime = 0.0;
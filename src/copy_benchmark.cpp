@@ -0,0 +1,107 @@
+#include "copy_benchmark.h"
+#include "frame_copy.h"
+#include "gpu_compute.h"
+#include <tinyvk/renderer/renderer.h>
+#include <tinyvk/core/log.h>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+namespace tvk_media {
+
+static constexpr int WARMUP_ITERATIONS = 2;
+static constexpr int TIMED_ITERATIONS = 16;
+
+enum class CopyMethod {
+    Memcpy,
+    RowMemcpy,
+    Stream
+};
+
+static void CopyFrame(CopyMethod method, uint8_t* dst, size_t dstPitch, const uint8_t* src, size_t srcPitch,
+                      size_t rowBytes, uint32_t rows) {
+    switch (method) {
+        case CopyMethod::Memcpy:
+            memcpy(dst, src, srcPitch * rows);
+            break;
+        case CopyMethod::RowMemcpy:
+            for (uint32_t y = 0; y < rows; y++) {
+                memcpy(dst + y * dstPitch, src + y * srcPitch, rowBytes);
+            }
+            break;
+        case CopyMethod::Stream:
+            StreamCopyPlane(dst, dstPitch, src, srcPitch, rowBytes, rows);
+            break;
+    }
+}
+
+static void MeasureCopy(CopyMethod method, const char* memoryName, const char* methodName,
+                        uint8_t* dst, size_t dstPitch, const std::vector<uint8_t>& source,
+                        size_t rowBytes, uint32_t rows, CopyBenchmarkReport& out) {
+    if (out.count >= CopyBenchmarkReport::MAX_RESULTS) return;
+
+    for (int i = 0; i < WARMUP_ITERATIONS; i++) {
+        CopyFrame(method, dst, dstPitch, source.data(), rowBytes, rowBytes, rows);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < TIMED_ITERATIONS; i++) {
+        CopyFrame(method, dst, dstPitch, source.data(), rowBytes, rowBytes, rows);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    CopyBenchmarkResult& result = out.results[out.count++];
+    result.memory = memoryName;
+    result.method = methodName;
+    result.millisecondsPerFrame = seconds * 1000.0 / TIMED_ITERATIONS;
+    result.gigabytesPerSecond = seconds > 0.0
+        ? static_cast<double>(rowBytes) * rows * TIMED_ITERATIONS / seconds / 1.0e9
+        : 0.0;
+
+    TVK_LOG_INFO("Copy benchmark {} / {}: {:.2f} GB/s, {:.3f} ms per frame",
+                 memoryName, methodName, result.gigabytesPerSecond, result.millisecondsPerFrame);
+}
+
+bool RunCopyBenchmark(tvk::VulkanContext* context, uint32_t width, uint32_t height, CopyBenchmarkReport& out) {
+    out.count = 0;
+    out.width = width;
+    out.height = height;
+
+    size_t rowBytes = static_cast<size_t>(width) * 4;
+    size_t pitch = AlignCopyPitch(rowBytes);
+
+    std::vector<uint8_t> source(rowBytes * height);
+    for (size_t i = 0; i < source.size(); i++) {
+        source[i] = static_cast<uint8_t>(i * 31 + (i >> 12));
+    }
+
+    struct MemoryCase {
+        HostMemory kind;
+        const char* name;
+    };
+    const MemoryCase cases[] = {
+        { HostMemory::Cached, "Cached" },
+        { HostMemory::WriteCombined, "Write-combined" }
+    };
+
+    VkDevice device = context->GetDevice();
+    for (const MemoryCase& memoryCase : cases) {
+        HostBuffer buffer;
+        if (!CreateHostBuffer(context, static_cast<VkDeviceSize>(pitch) * height,
+                              VK_BUFFER_USAGE_TRANSFER_SRC_BIT, memoryCase.kind, buffer)) {
+            TVK_LOG_INFO("Copy benchmark: no {} host memory type available", memoryCase.name);
+            continue;
+        }
+
+        uint8_t* mapped = static_cast<uint8_t*>(buffer.mapped);
+        MeasureCopy(CopyMethod::Memcpy, memoryCase.name, "memcpy", mapped, rowBytes, source, rowBytes, height, out);
+        MeasureCopy(CopyMethod::RowMemcpy, memoryCase.name, "row memcpy", mapped, pitch, source, rowBytes, height, out);
+        MeasureCopy(CopyMethod::Stream, memoryCase.name, "stream", mapped, pitch, source, rowBytes, height, out);
+
+        DestroyHostBuffer(device, buffer);
+    }
+
+    return out.count > 0;
+}
+
+} // namespace tvk_media
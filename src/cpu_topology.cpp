@@ -0,0 +1,192 @@
+#include "cpu_topology.h"
+#include "text_file.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace tvk_media {
+
+static bool ReadSysfsInt(const char* path, long& value) {
+    char buffer[64];
+    if (!ReadTextFile(path, buffer, sizeof(buffer))) return false;
+
+    char* end = nullptr;
+    value = strtol(buffer, &end, 10);
+    return end != buffer;
+}
+
+int CpuSet::Count() const {
+    int count = 0;
+    for (uint64_t word : bits) {
+        while (word) {
+            word &= word - 1;
+            count++;
+        }
+    }
+    return count;
+}
+
+bool CpuSet::Parse(const char* list) {
+    Clear();
+    const char* p = list;
+    while (*p) {
+        char* end = nullptr;
+        long first = strtol(p, &end, 10);
+        if (end == p) return false;
+
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            if (end == p + 1) return false;
+            p = end;
+        }
+
+        for (long cpu = first; cpu <= last && cpu < MAX_CPUS; cpu++) {
+            Set(static_cast<int>(cpu));
+        }
+
+        while (*p == ',' || *p == ' ' || *p == '\n') p++;
+    }
+    return true;
+}
+
+void CpuSet::Format(char* buffer, size_t size) const {
+    if (size == 0) return;
+    buffer[0] = '\0';
+
+    size_t used = 0;
+    int cpu = 0;
+    while (cpu < MAX_CPUS) {
+        if (!Has(cpu)) {
+            cpu++;
+            continue;
+        }
+
+        int last = cpu;
+        while (last + 1 < MAX_CPUS && Has(last + 1)) last++;
+
+        int written = last > cpu
+            ? snprintf(buffer + used, size - used, "%s%d-%d", used ? "," : "", cpu, last)
+            : snprintf(buffer + used, size - used, "%s%d", used ? "," : "", cpu);
+        if (written < 0 || used + static_cast<size_t>(written) >= size) return;
+
+        used += static_cast<size_t>(written);
+        cpu = last + 1;
+    }
+
+    if (used == 0) snprintf(buffer, size, "-");
+}
+
+CpuTopology::CpuTopology()
+    : _count(0)
+    , _nodeCount(1)
+    , _packageCount(1)
+    , _detected(false)
+{
+}
+
+const CpuInfo* CpuTopology::FindCpu(int cpu) const {
+    for (int i = 0; i < _count; i++) {
+        if (_cpus[i].cpu == cpu) return &_cpus[i];
+    }
+    return nullptr;
+}
+
+bool CpuTopology::Detect() {
+    _count = 0;
+    _nodeCount = 1;
+    _packageCount = 1;
+    _onlineSet.Clear();
+    _performanceSet.Clear();
+    _efficiencySet.Clear();
+    _detected = false;
+
+    char buffer[4096];
+    if (!ReadTextFile("/sys/devices/system/cpu/online", buffer, sizeof(buffer)) || !_onlineSet.Parse(buffer)) {
+        int fallback = static_cast<int>(std::thread::hardware_concurrency());
+        if (fallback <= 0) fallback = 1;
+        for (int cpu = 0; cpu < fallback && cpu < MAX_CPUS; cpu++) {
+            _onlineSet.Set(cpu);
+            _cpus[_count].cpu = cpu;
+            _cpus[_count].coreId = cpu;
+            _count++;
+        }
+        _performanceSet = _onlineSet;
+        return false;
+    }
+
+    char path[256];
+    int maxPackage = 0;
+    for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+        if (!_onlineSet.Has(cpu)) continue;
+
+        CpuInfo& info = _cpus[_count++];
+        info = CpuInfo();
+        info.cpu = cpu;
+
+        long value = 0;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+        info.coreId = ReadSysfsInt(path, value) ? static_cast<int>(value) : cpu;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+        info.package = ReadSysfsInt(path, value) && value >= 0 ? static_cast<int>(value) : 0;
+        if (info.package > maxPackage) maxPackage = info.package;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpu_capacity", cpu);
+        if (ReadSysfsInt(path, value)) {
+            info.capacity = static_cast<uint32_t>(value);
+        } else {
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+            if (ReadSysfsInt(path, value)) info.capacity = static_cast<uint32_t>(value);
+        }
+    }
+    _packageCount = maxPackage + 1;
+
+    for (int node = 0; node < MAX_NODES; node++) {
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        if (!ReadTextFile(path, buffer, sizeof(buffer))) continue;
+
+        CpuSet nodeSet;
+        if (!nodeSet.Parse(buffer)) continue;
+
+        for (int i = 0; i < _count; i++) {
+            if (nodeSet.Has(_cpus[i].cpu)) _cpus[i].node = node;
+        }
+        if (node + 1 > _nodeCount) _nodeCount = node + 1;
+    }
+
+    ClassifyCores();
+    _detected = true;
+    return true;
+}
+
+void CpuTopology::ClassifyCores() {
+    char buffer[4096];
+    CpuSet atomSet;
+    bool intelHybrid = ReadTextFile("/sys/devices/cpu_atom/cpus", buffer, sizeof(buffer)) && atomSet.Parse(buffer);
+
+    uint32_t maxCapacity = 0;
+    for (int i = 0; i < _count; i++) {
+        if (_cpus[i].capacity > maxCapacity) maxCapacity = _cpus[i].capacity;
+    }
+
+    for (int i = 0; i < _count; i++) {
+        CpuInfo& info = _cpus[i];
+        if (intelHybrid) {
+            info.efficiency = atomSet.Has(info.cpu);
+        } else {
+            info.efficiency = maxCapacity > 0 && info.capacity > 0 &&
+                              static_cast<uint64_t>(info.capacity) * 100 < static_cast<uint64_t>(maxCapacity) * 80;
+        }
+
+        if (info.efficiency) {
+            _efficiencySet.Set(info.cpu);
+        } else {
+            _performanceSet.Set(info.cpu);
+        }
+    }
+}
+
+} // namespace tvk_media
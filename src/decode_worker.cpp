@@ -0,0 +1,161 @@
+#include "decode_worker.h"
+#include "thread_placement.h"
+#include "thread_stats.h"
+#include <chrono>
+#include <utility>
+
+namespace tvk_media {
+
+// Refinement checks for cancellation between slices of this many seconds
+static constexpr double REFINE_SLICE = 0.004;
+
+DecodeWorker::DecodeWorker()
+    : _decoder(nullptr)
+    , _placement(nullptr)
+    , _job(DecodeJob::None)
+    , _target(0.0)
+    , _result(DecodeResult::Pending)
+    , _busy(false)
+    , _cancel(false)
+    , _stopping(false)
+    , _scrubKeyframe(-1.0)
+    , _jobSeconds(0.0)
+    , _lastJobSeconds(0.0)
+{
+}
+
+DecodeWorker::~DecodeWorker() {
+    Stop();
+}
+
+void DecodeWorker::Init(VideoDecoder* decoder, const ThreadPlacement* placement) {
+    _decoder = decoder;
+    _placement = placement;
+}
+
+void DecodeWorker::Stop() {
+    if (!_worker.joinable()) return;
+    _cancel = true;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _wake.notify_one();
+    _worker.join();
+    _stopping = false;
+    _cancel = false;
+    _busy = false;
+    _job = DecodeJob::None;
+    _result = DecodeResult::Pending;
+}
+
+bool DecodeWorker::Scrub(double timeSeconds) {
+    return Submit(DecodeJob::Scrub, timeSeconds);
+}
+
+bool DecodeWorker::Refine() {
+    return Submit(DecodeJob::Refine, 0.0);
+}
+
+bool DecodeWorker::Submit(DecodeJob job, double timeSeconds) {
+    if (!_decoder || IsBusy()) return false;
+    if (!_worker.joinable()) {
+        _worker = std::thread(&DecodeWorker::WorkerLoop, this);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _job = job;
+        _target = timeSeconds;
+        _result = DecodeResult::Pending;
+        _busy = true;
+    }
+    _wake.notify_one();
+    return true;
+}
+
+DecodeResult DecodeWorker::Poll(VideoFrame& outFrame) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_busy || _result == DecodeResult::Pending) return DecodeResult::Pending;
+
+    DecodeResult result = _result;
+    if (result == DecodeResult::Frame) {
+        std::swap(outFrame, _frame);
+    }
+    _lastJobSeconds = _jobSeconds;
+    _result = DecodeResult::Pending;
+    _job = DecodeJob::None;
+    return result;
+}
+
+void DecodeWorker::Wait() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this]() { return !_busy; });
+}
+
+void DecodeWorker::Cancel() {
+    _cancel = true;
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this]() { return !_busy; });
+    _result = DecodeResult::Pending;
+    _job = DecodeJob::None;
+    _scrubKeyframe = -1.0;
+    _cancel = false;
+}
+
+void DecodeWorker::WorkerLoop() {
+    if (_placement) {
+        _placement->Apply(ThreadClass::Decode);
+    }
+    ThreadStats::RegisterCurrentThread(ThreadRole::Background);
+
+    while (true) {
+        DecodeJob job;
+        double target;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this]() { return _stopping || _busy; });
+            if (_stopping) break;
+            job = _job;
+            target = _target;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        DecodeResult result = DecodeResult::Failed;
+        if (job == DecodeJob::Scrub) {
+            result = RunScrub(target);
+        } else if (job == DecodeJob::Refine) {
+            result = RunRefine();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _jobSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            _result = result;
+            _busy = false;
+        }
+        _done.notify_all();
+    }
+}
+
+DecodeResult DecodeWorker::RunScrub(double timeSeconds) {
+    double keyframe = _decoder->GetKeyframeTime(timeSeconds);
+    if (keyframe == _scrubKeyframe) return DecodeResult::Unchanged;
+    if (_cancel) return DecodeResult::Failed;
+
+    if (!_decoder->Seek(timeSeconds) || !_decoder->DecodeNextFrame(_frame)) {
+        return DecodeResult::Failed;
+    }
+    _scrubKeyframe = keyframe;
+    return DecodeResult::Frame;
+}
+
+DecodeResult DecodeWorker::RunRefine() {
+    _scrubKeyframe = -1.0;
+    while (!_cancel) {
+        if (_decoder->DecodeNextFrame(_frame, REFINE_SLICE)) return DecodeResult::Frame;
+        if (!_decoder->IsSkipping()) break;
+    }
+    return DecodeResult::Failed;
+}
+
+} // namespace tvk_media
@@ -0,0 +1,145 @@
+#include "display_sync.h"
+#include <tinyvk/core/log.h>
+#include <algorithm>
+#include <cmath>
+
+namespace tvk_media {
+
+DisplaySync::DisplaySync()
+    : _enabled(false)
+    , _active(false)
+    , _measured(false)
+    , _nominalRate(0.0)
+    , _interval(0.0)
+    , _anchor(0.0)
+    , _lastFrame(-1.0)
+    , _hits(0)
+    , _misses(0)
+    , _fps(0.0)
+    , _repeats(1)
+    , _speed(1.0)
+    , _lastPresent(0.0)
+    , _lastTimestamp(-1.0)
+    , _dropped(0)
+    , _repeated(0)
+{
+}
+
+void DisplaySync::SetEnabled(bool enabled) {
+    _enabled = enabled;
+    ResetCounters();
+}
+
+void DisplaySync::SetNominalRate(double hz) {
+    if (hz <= 0.0 || std::fabs(hz - _nominalRate) < 0.5) return;
+    TVK_LOG_INFO("Display refresh: {} Hz", hz);
+    _nominalRate = hz;
+    _interval = 1.0 / hz;
+    _measured = false;
+    _lastFrame = -1.0;
+}
+
+void DisplaySync::OnFrame(double now) {
+    if (_interval <= 0.0) return;
+    if (_lastFrame < 0.0 || now - _lastFrame > MAX_GAP * _interval) {
+        RestartWindow(now);
+        return;
+    }
+    _lastFrame = now;
+
+    double span = now - _anchor;
+    double count = std::round(span / _interval);
+    if (count < 1.0) return;
+    bool onGrid = std::fabs(span - count * _interval) <= _interval * SAMPLE_TOLERANCE;
+    if (count >= MIN_COUNT && std::fabs(count / span / _nominalRate - 1.0) > MAX_RATE_ERROR) {
+        onGrid = false;
+    }
+    if (!onGrid) {
+        _misses++;
+        return;
+    }
+    _hits++;
+
+    if (count >= MIN_COUNT && (!_measured || span >= MIN_SPAN)) {
+        _interval = span / count;
+    }
+    if (span >= MIN_SPAN && _hits > _misses) {
+        _measured = true;
+    }
+    if (span >= MAX_SPAN) {
+        if (_misses > _hits) {
+            _measured = false;
+        }
+        RestartWindow(now);
+    }
+}
+
+void DisplaySync::RestartWindow(double now) {
+    _anchor = now;
+    _lastFrame = now;
+    _hits = 0;
+    _misses = 0;
+}
+
+double DisplaySync::GetRefreshRate() const {
+    return _interval > 0.0 ? 1.0 / _interval : 0.0;
+}
+
+void DisplaySync::Configure(double fps) {
+    bool wasActive = _active;
+    int wasRepeats = _repeats;
+    _fps = fps;
+    _active = false;
+
+    if (_enabled && _measured && fps > 0.0) {
+        double refresh = GetRefreshRate();
+        int repeats = std::max(1, static_cast<int>(std::lround(refresh / fps)));
+        double speed = refresh / repeats / fps;
+        if (repeats <= MAX_REPEATS && std::fabs(speed - 1.0) <= MAX_SPEED_CHANGE) {
+            _repeats = repeats;
+            _speed = speed;
+            _active = true;
+        }
+    }
+    if (!_active) {
+        _speed = 1.0;
+    }
+
+    if (_active && (!wasActive || _repeats != wasRepeats)) {
+        TVK_LOG_INFO("Display sync: {:.3f} fps held for {} refreshes at {:.3f} Hz, speed {:+.3f}%",
+                     fps, _repeats, GetRefreshRate(), (_speed - 1.0) * 100.0);
+    } else if (wasActive && !_active) {
+        TVK_LOG_INFO("Display sync off: {:.3f} fps does not fit {:.3f} Hz", fps, GetRefreshRate());
+    }
+}
+
+void DisplaySync::Restart(double now, double timestamp) {
+    _lastPresent = now;
+    _lastTimestamp = timestamp;
+}
+
+int DisplaySync::GetDueFrames(double now) const {
+    long vsyncs = std::lround((now - _lastPresent) / _interval);
+    return static_cast<int>(vsyncs / _repeats);
+}
+
+void DisplaySync::OnPresented(double now, double timestamp, int dropped) {
+    long vsyncs = std::lround((now - _lastPresent) / _interval);
+    if (vsyncs > static_cast<long>(dropped + 1) * _repeats) {
+        _repeated++;
+    }
+    _dropped += static_cast<uint64_t>(dropped);
+    _lastPresent = now;
+    _lastTimestamp = timestamp;
+}
+
+double DisplaySync::GetNextDue() const {
+    return _lastPresent + (_repeats - 0.5) * _interval;
+}
+
+void DisplaySync::ResetCounters() {
+    _dropped = 0;
+    _repeated = 0;
+}
+
+} // namespace tvk_media
@@ -0,0 +1,609 @@
+#include "film_grain.h"
+#include "frame_copy.h"
+#include <tinyvk/renderer/renderer.h>
+#include <tinyvk/core/log.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace tvk_media {
+
+static const char* g_filmGrainComputeShader = R"(
+#version 450
+
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+layout(binding = 0, rgba8) uniform image2D frameImage;
+
+layout(std430, binding = 1) readonly buffer GrainData {
+    int header[32];
+    int lumaGrain[5986];
+    int cbGrain[5986];
+    int crGrain[5986];
+    int scaling[768];
+    int offsets[];
+} grain;
+
+layout(push_constant) uniform PushConstants {
+    int width;
+    int height;
+    int pad0;
+    int pad1;
+} pc;
+
+const int HEADER_SUB_X = 0;
+const int HEADER_SUB_Y = 1;
+const int HEADER_SCALING_SHIFT = 2;
+const int HEADER_OVERLAP = 3;
+const int HEADER_MIN_VALUE = 4;
+const int HEADER_MAX_LUMA = 5;
+const int HEADER_MAX_CHROMA = 6;
+const int HEADER_BLOCKS_X = 7;
+const int HEADER_CHROMA_STRIDE = 8;
+const int HEADER_LUMA_ACTIVE = 9;
+const int HEADER_CB_ACTIVE = 10;
+const int HEADER_CR_ACTIVE = 11;
+const int HEADER_CB_MULT = 12;
+const int HEADER_CB_LUMA_MULT = 13;
+const int HEADER_CB_OFFSET = 14;
+const int HEADER_CR_MULT = 15;
+const int HEADER_CR_LUMA_MULT = 16;
+const int HEADER_CR_OFFSET = 17;
+
+int round2(int x, int n) {
+    return n == 0 ? x : (x + (1 << (n - 1))) >> n;
+}
+
+int blend(int a, int b, int wa, int wb) {
+    return clamp(round2(a * wa + b * wb, 5), -128, 127);
+}
+
+int template_at(int plane, int row, int col) {
+    if (plane == 0) return grain.lumaGrain[row * 82 + col];
+    int index = row * grain.header[HEADER_CHROMA_STRIDE] + col;
+    return plane == 1 ? grain.cbGrain[index] : grain.crGrain[index];
+}
+
+ivec2 block_origin(int stripe, int block, int subX, int subY) {
+    int rnd = grain.offsets[stripe * grain.header[HEADER_BLOCKS_X] + block];
+    int offX = rnd >> 4;
+    int offY = rnd & 15;
+    return ivec2(subX != 0 ? 6 + offX : 9 + offX * 2,
+                 subY != 0 ? 6 + offY : 9 + offY * 2);
+}
+
+int stripe_noise(int plane, int subX, int subY, int stripe, int x, int row) {
+    int blockWidth = 32 >> subX;
+    int block = x / blockWidth;
+    int col = x - block * blockWidth;
+    ivec2 origin = block_origin(stripe, block, subX, subY);
+    int g = template_at(plane, origin.y + row, origin.x + col);
+    
+    if (grain.header[HEADER_OVERLAP] != 0 && block > 0 && col < 2 - subX) {
+        ivec2 prev = block_origin(stripe, block - 1, subX, subY);
+        int old = template_at(plane, prev.y + row, prev.x + col + blockWidth);
+        if (subX != 0) g = blend(old, g, 23, 22);
+        else g = col == 0 ? blend(old, g, 27, 17) : blend(old, g, 17, 27);
+    }
+    return g;
+}
+
+int noise_at(int plane, int subX, int subY, ivec2 p) {
+    int stripeHeight = 32 >> subY;
+    int stripe = p.y / stripeHeight;
+    int row = p.y - stripe * stripeHeight;
+    int g = stripe_noise(plane, subX, subY, stripe, p.x, row);
+    
+    if (grain.header[HEADER_OVERLAP] != 0 && stripe > 0 && row < 2 - subY) {
+        int old = stripe_noise(plane, subX, subY, stripe - 1, p.x, row + stripeHeight);
+        if (subY != 0) g = blend(old, g, 23, 22);
+        else g = row == 0 ? blend(old, g, 27, 17) : blend(old, g, 17, 27);
+    }
+    return g;
+}
+
+int apply_chroma(int plane, int value, int luma, ivec2 chromaCoord, int subX, int subY,
+                 int mult, int lumaMult, int offset, int shift) {
+    int merged = clamp(((luma * lumaMult + value * mult) >> 6) + offset, 0, 255);
+    int noise = noise_at(plane, subX, subY, chromaCoord);
+    int scaled = round2(grain.scaling[plane * 256 + merged] * noise, shift);
+    return clamp(value + scaled, grain.header[HEADER_MIN_VALUE], grain.header[HEADER_MAX_CHROMA]);
+}
+
+void main() {
+    ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+    if (coord.x >= pc.width || coord.y >= pc.height) return;
+    
+    vec4 pixel = imageLoad(frameImage, coord);
+    vec3 rgb = pixel.rgb * 255.0;
+    
+    int lumaValue = clamp(int(dot(rgb, vec3(0.256788, 0.504129, 0.097906)) + 16.5), 0, 255);
+    int cbValue = clamp(int(dot(rgb, vec3(-0.148223, -0.290993, 0.439216)) + 128.5), 0, 255);
+    int crValue = clamp(int(dot(rgb, vec3(0.439216, -0.367788, -0.071427)) + 128.5), 0, 255);
+    
+    int shift = grain.header[HEADER_SCALING_SHIFT];
+    int subX = grain.header[HEADER_SUB_X];
+    int subY = grain.header[HEADER_SUB_Y];
+    ivec2 chromaCoord = ivec2(coord.x >> subX, coord.y >> subY);
+    vec3 delta = vec3(0.0);
+    
+    if (grain.header[HEADER_LUMA_ACTIVE] != 0) {
+        int noise = noise_at(0, 0, 0, coord);
+        int scaled = round2(grain.scaling[lumaValue] * noise, shift);
+        int outY = clamp(lumaValue + scaled, grain.header[HEADER_MIN_VALUE], grain.header[HEADER_MAX_LUMA]);
+        delta.x = float(outY - lumaValue);
+    }
+    
+    if (grain.header[HEADER_CB_ACTIVE] != 0) {
+        int outCb = apply_chroma(1, cbValue, lumaValue, chromaCoord, subX, subY,
+                                 grain.header[HEADER_CB_MULT], grain.header[HEADER_CB_LUMA_MULT],
+                                 grain.header[HEADER_CB_OFFSET], shift);
+        delta.y = float(outCb - cbValue);
+    }
+    
+    if (grain.header[HEADER_CR_ACTIVE] != 0) {
+        int outCr = apply_chroma(2, crValue, lumaValue, chromaCoord, subX, subY,
+                                 grain.header[HEADER_CR_MULT], grain.header[HEADER_CR_LUMA_MULT],
+                                 grain.header[HEADER_CR_OFFSET], shift);
+        delta.z = float(outCr - crValue);
+    }
+    
+    vec3 change = vec3(
+        1.164383 * delta.x + 1.596027 * delta.z,
+        1.164383 * delta.x - 0.391762 * delta.y - 0.812968 * delta.z,
+        1.164383 * delta.x + 2.017232 * delta.y
+    );
+    
+    imageStore(frameImage, coord, vec4(clamp((rgb + change) / 255.0, 0.0, 1.0), pixel.a));
+}
+)";
+
+enum FilmGrainHeader {
+    HEADER_SUB_X = 0,
+    HEADER_SUB_Y = 1,
+    HEADER_SCALING_SHIFT = 2,
+    HEADER_OVERLAP = 3,
+    HEADER_MIN_VALUE = 4,
+    HEADER_MAX_LUMA = 5,
+    HEADER_MAX_CHROMA = 6,
+    HEADER_BLOCKS_X = 7,
+    HEADER_CHROMA_STRIDE = 8,
+    HEADER_LUMA_ACTIVE = 9,
+    HEADER_CB_ACTIVE = 10,
+    HEADER_CR_ACTIVE = 11,
+    HEADER_CB_MULT = 12,
+    HEADER_CB_LUMA_MULT = 13,
+    HEADER_CB_OFFSET = 14,
+    HEADER_CR_MULT = 15,
+    HEADER_CR_LUMA_MULT = 16,
+    HEADER_CR_OFFSET = 17
+};
+
+static const int16_t g_gaussianSequence[2048] = {
+    56, 568, -180, 172, 124, -84, 172, -64, -900, 24, 820, 224, 1248, 996, 272, -8,
+    -916, -388, -732, -104, -188, 800, 112, -652, -320, -376, 140, -252, 492, -168, 44, -788,
+    588, -584, 500, -228, 12, 680, 272, -476, 972, -100, 652, 368, 432, -196, -720, -192,
+    1000, -332, 652, -136, -552, -604, -4, 192, -220, -136, 1000, -52, 372, -96, -624, 124,
+    -24, 396, 540, -12, -104, 640, 464, 244, -208, -84, 368, -528, -740, 248, -968, -848,
+    608, 376, -60, -292, -40, -156, 252, -292, 248, 224, -280, 400, -244, 244, -60, 76,
+    -80, 212, 532, 340, 128, -36, 824, -352, -60, -264, -96, -612, 416, -704, 220, -204,
+    640, -160, 1220, -408, 900, 336, 20, -336, -96, -792, 304, 48, -28, -1232, -1172, -448,
+    104, -292, -520, 244, 60, -948, 0, -708, 268, 108, 356, -548, 488, -344, -136, 488,
+    -196, -224, 656, -236, -1128, 60, 4, 140, 276, -676, -376, 168, -108, 464, 8, 564,
+    64, 240, 308, -300, -400, -456, -136, 56, 120, -408, -116, 436, 504, -232, 328, 844,
+    -164, -84, 784, -168, 232, -224, 348, -376, 128, 568, 96, -1244, -288, 276, 848, 832,
+    -360, 656, 464, -384, -332, -356, 728, -388, 160, -192, 468, 296, 224, 140, -776, -100,
+    280, 4, 196, 44, -36, -648, 932, 16, 1428, 28, 528, 808, 772, 20, 268, 88,
+    -332, -284, 124, -384, -448, 208, -228, -1044, -328, 660, 380, -148, -300, 588, 240, 540,
+    28, 136, -88, -436, 256, 296, -1000, 1400, 0, -48, 1056, -136, 264, -528, -1108, 632,
+    -484, -592, -344, 796, 124, -668, -768, 388, 1296, -232, -188, -200, -288, -4, 308, 100,
+    -168, 256, -500, 204, -508, 648, -136, 372, -272, -120, -1004, -552, -548, -384, 548, -296,
+    428, -108, -8, -912, -324, -224, -88, -112, -220, -100, 996, -796, 548, 360, -216, 180,
+    428, -200, -212, 148, 96, 148, 284, 216, -412, -320, 120, -300, -384, -604, -572, -332,
+    -8, -180, -176, 696, 116, -88, 628, 76, 44, -516, 240, -208, -40, 100, -592, 344,
+    -308, -452, -228, 20, 916, -1752, -136, -340, -804, 140, 40, 512, 340, 248, 184, -492,
+    896, -156, 932, -628, 328, -688, -448, -616, -752, -100, 560, -1020, 180, -800, -64, 76,
+    576, 1068, 396, 660, 552, -108, -28, 320, -628, 312, -92, -92, -472, 268, 16, 560,
+    516, -672, -52, 492, -100, 260, 384, 284, 292, 304, -148, 88, -152, 1012, 1064, -228,
+    164, -376, -684, 592, -392, 156, 196, -524, -64, -884, 160, -176, 636, 648, 404, -396,
+    -436, 864, 424, -728, 988, -604, 904, -592, 296, -224, 536, -176, -920, 436, -48, 1176,
+    -884, 416, -776, -824, -884, 524, -548, -564, -68, -164, -96, 692, 364, -692, -1012, -68,
+    260, -480, 876, -1116, 452, -332, -352, 892, -1088, 1220, -676, 12, -292, 244, 496, 372,
+    -32, 280, 200, 112, -440, -96, 24, -644, -184, 56, -432, 224, -980, 272, -260, 144,
+    -436, 420, 356, 364, -528, 76, 172, -744, -368, 404, -752, -416, 684, -688, 72, 540,
+    416, 92, 444, 480, -72, -1416, 164, -1172, -68, 24, 424, 264, 1040, 128, -912, -524,
+    -356, 64, 876, -12, 4, -88, 532, 272, -524, 320, 276, -508, 940, 24, -400, -120,
+    756, 60, 236, -412, 100, 376, -484, 400, -100, -740, -108, -260, 328, -268, 224, -200,
+    -416, 184, -604, -564, -20, 296, 60, 892, -888, 60, 164, 68, -760, 216, -296, 904,
+    -336, -28, 404, -356, -568, -208, -1480, -512, 296, 328, -360, -164, -1560, -776, 1156, -428,
+    164, -504, -112, 120, -216, -148, -264, 308, 32, 64, -72, 72, 116, 176, -64, -272,
+    460, -536, -784, -280, 348, 108, -752, -132, 524, -540, -776, 116, -296, -1196, -288, -560,
+    1040, -472, 116, -848, -1116, 116, 636, 696, 284, -176, 1016, 204, -864, -648, -248, 356,
+    972, -584, -204, 264, 880, 528, -24, -184, 116, 448, -144, 828, 524, 212, -212, 52,
+    12, 200, 268, -488, -404, -880, 824, -672, -40, 908, -248, 500, 716, -576, 492, -576,
+    16, 720, -108, 384, 124, 344, 280, 576, -500, 252, 104, -308, 196, -188, -8, 1268,
+    296, 1032, -1196, 436, 316, 372, -432, -200, -660, 704, -224, 596, -132, 268, 32, -452,
+    884, 104, -1008, 424, -1348, -280, 4, -1168, 368, 476, 696, 300, -8, 24, 180, -592,
+    -196, 388, 304, 500, 724, -160, 244, -84, 272, -256, -420, 320, 208, -144, -156, 156,
+    364, 452, 28, 540, 316, 220, -644, -248, 464, 72, 360, 32, -388, 496, -680, -48,
+    208, -116, -408, 60, -604, -392, 548, -840, 784, -460, 656, -544, -388, -264, 908, -800,
+    -628, -612, -568, 572, -220, 164, 288, -16, -308, 308, -112, -636, -760, 280, -668, 432,
+    364, 240, -196, 604, 340, 384, 196, 592, -44, -500, 432, -580, -132, 636, -76, 392,
+    4, -412, 540, 508, 328, -356, -36, 16, -220, -64, -248, -60, 24, -192, 368, 1040,
+    92, -24, -1044, -32, 40, 104, 148, 192, -136, -520, 56, -816, -224, 732, 392, 356,
+    212, -80, -424, -1008, -324, 588, -1496, 576, 460, -816, -848, 56, -580, -92, -1372, -112,
+    -496, 200, 364, 52, -140, 48, -48, -60, 84, 72, 40, 132, -356, -268, -104, -284,
+    -404, 732, -520, 164, -304, -540, 120, 328, -76, -460, 756, 388, 588, 236, -436, -72,
+    -176, -404, -316, -148, 716, -604, 404, -72, -88, -888, -68, 944, 88, -220, -344, 960,
+    472, 460, -232, 704, 120, 832, -228, 692, -508, 132, -476, 844, -748, -364, -44, 1116,
+    -1104, -1056, 76, 428, 552, -692, 60, 356, 96, -384, -188, -612, -576, 736, 508, 892,
+    352, -1132, 504, -24, -352, 324, 332, -600, -312, 292, 508, -144, -8, 484, 48, 284,
+    -260, -240, 256, -100, -292, -204, -44, 472, -204, 908, -188, -1000, -256, 92, 1164, -392,
+    564, 356, 652, -28, -884, 256, 484, -192, 760, -176, 376, -524, -452, -436, 860, -736,
+    212, 124, 504, -476, 468, 76, -472, 552, -692, -944, -620, 740, -240, 400, 132, 20,
+    192, -196, 264, -668, -1012, -60, 296, -316, -828, 76, -156, 284, -768, -448, -832, 148,
+    248, 652, 616, 1236, 288, -328, -400, -124, 588, 220, 520, -696, 1032, 768, -740, -92,
+    -272, 296, 448, -464, 412, -200, 392, 440, -200, 264, -152, -260, 320, 1032, 216, 320,
+    -8, -64, 156, -1016, 1084, 1172, 536, 484, -432, 132, 372, -52, -256, 84, 116, -352,
+    48, 116, 304, -384, 412, 924, -300, 528, 628, 180, 648, 44, -980, -220, 1320, 48,
+    332, 748, 524, -268, -720, 540, -276, 564, -344, -208, -196, 436, 896, 88, -392, 132,
+    80, -964, -288, 568, 56, -48, -456, 888, 8, 552, -156, -292, 948, 288, 128, -716,
+    -292, 1192, -152, 876, 352, -600, -260, -812, -468, -28, -120, -32, -44, 1284, 496, 192,
+    464, 312, -76, -516, -380, -456, -1012, -48, 308, -156, 36, 492, -156, -808, 188, 1652,
+    68, -120, -116, 316, 160, -140, 352, 808, -416, 592, 316, -480, 56, 528, -204, -568,
+    372, -232, 752, -344, 744, -4, 324, -416, -600, 768, 268, -248, -88, -132, -420, -432,
+    80, -288, 404, -316, -1216, -588, 520, -108, 92, -320, 368, -480, -216, -92, 1688, -300,
+    180, 1020, -176, 820, -68, -228, -260, 436, -904, 20, 40, -508, 440, -736, 312, 332,
+    204, 760, -372, 728, 96, -20, -632, -520, -560, 336, 1076, -64, -532, 776, 584, 192,
+    396, -728, -520, 276, -188, 80, -52, -612, -252, -48, 648, 212, -688, 228, -52, -260,
+    428, -412, -272, -404, 180, 816, -796, 48, 152, 484, -88, -216, 988, 696, 188, -528,
+    648, -116, -180, 316, 476, 12, -564, 96, 476, -252, -364, -376, -392, 556, -256, -576,
+    260, -352, 120, -16, -136, -260, -492, 72, 556, 660, 580, 616, 772, 436, 424, -32,
+    -324, -1268, 416, -324, -80, 920, 160, 228, 724, 32, -516, 64, 384, 68, -128, 136,
+    240, 248, -204, -68, 252, -932, -120, -480, -628, -84, 192, 852, -404, -288, -132, 204,
+    100, 168, -68, -196, -868, 460, 1080, 380, -80, 244, 0, 484, -888, 64, 184, 352,
+    600, 460, 164, 604, -196, 320, -64, 588, -184, 228, 12, 372, 48, -848, -344, 224,
+    208, -200, 484, 128, -20, 272, -468, -840, 384, 256, -720, -520, -464, -580, 112, -120,
+    644, -356, -208, -608, -528, 704, 560, -424, 392, 828, 40, 84, 200, -152, 0, -144,
+    584, 280, -120, 80, -556, -972, -196, -472, 724, 80, 168, -32, 88, 160, -688, 0,
+    160, 356, 372, -776, 740, -128, 676, -248, -480, 4, -364, 96, 544, 232, -1032, 956,
+    236, 356, 20, -40, 300, 24, -676, -596, 132, 1120, -104, 532, -1096, 568, 648, 444,
+    508, 380, 188, -376, -604, 1488, 424, 24, 756, -220, -192, 716, 120, 920, 688, 168,
+    44, -460, 568, 284, 1144, 1160, 600, 424, 888, 656, -356, -320, 220, 316, -176, -724,
+    -188, -816, -628, -348, -228, -380, 1012, -452, -660, 736, 928, 404, -696, -72, -268, -892,
+    128, 184, -344, -780, 360, 336, 400, 344, 428, 548, -112, 136, -228, -216, -820, -516,
+    340, 92, -136, 116, -300, 376, -244, 100, -316, -520, -284, -12, 824, 164, -548, -180,
+    -128, 116, -924, -828, 268, -368, -580, 620, 192, 160, 0, -1676, 1068, 424, -56, -360,
+    468, -156, 720, 288, -528, 556, -364, 548, -148, 504, 316, 152, -648, -620, -684, -24,
+    -376, -384, -108, -920, -1032, 768, 180, -264, -508, -1268, -260, -60, 300, -240, 988, 724,
+    -376, -576, -212, -736, 556, 192, 1092, -620, -880, 376, -56, -4, -216, -32, 836, 268,
+    396, 1332, 864, -600, 100, 56, -412, -92, 356, 180, 884, -468, -436, 292, -388, -804,
+    -704, -840, 368, -348, 140, -724, 1536, 940, 372, 112, -372, 436, -480, 1136, 296, -32,
+    -228, 132, -48, -220, 868, -1016, -60, -1044, -464, 328, 916, 244, 12, -736, -296, 360,
+    468, -376, -108, -92, 788, 368, -56, 544, 400, -672, -420, 728, 16, 320, 44, -284,
+    -380, -796, 488, 132, 204, -596, -372, 88, -152, -908, -636, -572, -624, -116, -692, -200,
+    -56, 276, -88, 484, -324, 948, 864, 1000, -456, -184, -276, 292, -296, 156, 676, 320,
+    160, 908, -84, -1236, -288, -116, 260, -372, -644, 732, -756, -96, 84, 344, -520, 348,
+    -688, 240, -84, 216, -1044, -136, -676, -396, -1500, 960, -40, 176, 168, 1516, 420, -504,
+    -344, -364, -360, 1216, -940, -380, -212, 252, -660, -708, 484, -444, -152, 928, -120, 1112,
+    476, -260, 560, -148, -344, 108, -196, 228, -288, 504, 560, -328, -88, 288, -1008, 460,
+    -228, 468, -836, -196, 76, 388, 232, 412, -1168, -716, -644, 756, -172, -356, -504, 116,
+    432, 528, 48, 476, -168, -608, 448, 160, -532, -272, 28, -676, -12, 828, 980, 456,
+    520, 104, -104, 256, -344, -4, -28, -368, -52, -524, -572, -556, -200, 768, 1124, -208,
+    -512, 176, 232, 248, -148, -888, 604, -600, -304, 804, -156, -212, 488, -192, -804, -256,
+    368, -360, -916, -328, 228, -240, -448, -472, 856, -556, -364, 572, -12, -156, -368, -340,
+    432, 252, -752, -152, 288, 268, -580, -848, -592, 108, -76, 244, 312, -716, 592, -80,
+    436, 360, 4, -248, 160, 516, 584, 732, 44, -468, -280, -292, -156, -588, 28, 308,
+    912, 24, 124, 156, 180, -252, 944, -924, -772, -520, -428, -624, 300, -212, -1144, 32,
+    -724, 800, -1128, -212, -1288, -848, 180, -416, 440, 192, -576, -792, -76, -1080, 80, -532,
+    -352, -132, 380, -820, 148, 1112, 128, 164, 456, 700, -924, 144, -668, -384, 648, -832,
+    508, 552, -52, -100, -656, 208, -568, 748, -88, 680, 232, 300, 192, -408, -1012, -152,
+    -252, -268, 272, -876, -664, -648, -332, -136, 16, 12, 1152, -28, 332, -536, 320, -672,
+    -460, -316, 532, -260, 228, -40, 1052, -816, 180, 88, -496, -556, -672, -368, 428, 92,
+    356, 404, -408, 252, 196, -176, -556, 792, 268, 32, 372, 40, 96, -332, 328, 120,
+    372, -900, -40, 472, -264, -592, 952, 128, 656, 112, 664, -232, 420, 4, -344, -464,
+    556, 244, -416, -32, 252, 0, -412, 188, -696, 508, -476, 324, -1096, 656, -312, 560,
+    264, -136, 304, 160, -64, -580, 248, 336, -720, 560, -348, -288, -276, -196, -500, 852,
+    -544, -236, -1128, -992, -776, 116, 56, 52, 860, 884, 212, -12, 168, 1020, 512, -552,
+    924, -148, 716, 188, 164, -340, -520, -184, 880, -152, -680, -208, -1156, -300, -528, -472,
+    364, 100, -744, -1056, -32, 540, 280, 144, -676, -32, -232, -280, -224, 96, 568, -76,
+    172, 148, 148, 104, 32, -296, -32, 788, -80, 32, -16, 280, 288, 944, 428, -484
+};
+
+static constexpr int GRAIN_MIN = -128;
+static constexpr int GRAIN_MAX = 127;
+
+static inline int Round2(int x, int shift) {
+    return shift == 0 ? x : (x + (1 << (shift - 1))) >> shift;
+}
+
+static inline int Clamp(int x, int low, int high) {
+    return x < low ? low : (x > high ? high : x);
+}
+
+static inline int NextRandom(uint16_t& state, int bits) {
+    int bit = (state ^ (state >> 1) ^ (state >> 3) ^ (state >> 12)) & 1;
+    state = static_cast<uint16_t>((state >> 1) | (bit << 15));
+    return (state >> (16 - bits)) & ((1 << bits) - 1);
+}
+
+static void BuildScalingLut(const uint8_t (*points)[2], int count, int32_t* lut) {
+    if (count == 0) {
+        std::fill(lut, lut + 256, 0);
+        return;
+    }
+
+    for (int i = 0; i < points[0][0]; i++) {
+        lut[i] = points[0][1];
+    }
+
+    for (int p = 0; p < count - 1; p++) {
+        int x0 = points[p][0];
+        int y0 = points[p][1];
+        int dx = points[p + 1][0] - x0;
+        int dy = points[p + 1][1] - y0;
+        if (dx <= 0) continue;
+
+        int delta = dy * ((65536 + (dx >> 1)) / dx);
+        for (int x = 0; x < dx; x++) {
+            lut[x0 + x] = y0 + ((x * delta + 32768) >> 16);
+        }
+    }
+
+    for (int i = points[count - 1][0]; i < 256; i++) {
+        lut[i] = points[count - 1][1];
+    }
+}
+
+static void GenerateChromaTemplate(int32_t* out, const int32_t* luma, const int8_t* coeffs,
+                                   const AVFilmGrainAOMParams& aom, uint16_t seed,
+                                   int subX, int subY, int chromaWidth, int chromaHeight, bool active) {
+    int shift = 4 + aom.grain_scale_shift;
+    uint16_t state = seed;
+
+    for (int y = 0; y < chromaHeight; y++) {
+        for (int x = 0; x < chromaWidth; x++) {
+            int g = active ? g_gaussianSequence[NextRandom(state, 11)] : 0;
+            out[y * chromaWidth + x] = Round2(g, shift);
+        }
+    }
+
+    if (!active) return;
+
+    int lag = aom.ar_coeff_lag;
+    for (int y = 3; y < chromaHeight; y++) {
+        for (int x = 3; x < chromaWidth - 3; x++) {
+            int sum = 0;
+            int pos = 0;
+            for (int dy = -lag; dy <= 0; dy++) {
+                for (int dx = -lag; dx <= lag; dx++) {
+                    if (dy == 0 && dx == 0) {
+                        if (aom.num_y_points > 0) {
+                            int lumaX = ((x - 3) << subX) + 3;
+                            int lumaY = ((y - 3) << subY) + 3;
+                            int average = 0;
+                            for (int i = 0; i <= subY; i++) {
+                                for (int j = 0; j <= subX; j++) {
+                                    average += luma[(lumaY + i) * FilmGrainData::TEMPLATE_WIDTH + lumaX + j];
+                                }
+                            }
+                            sum += Round2(average, subX + subY) * coeffs[pos];
+                        }
+                        break;
+                    }
+                    sum += out[(y + dy) * chromaWidth + x + dx] * coeffs[pos];
+                    pos++;
+                }
+            }
+            int index = y * chromaWidth + x;
+            out[index] = Clamp(out[index] + Round2(sum, aom.ar_coeff_shift), GRAIN_MIN, GRAIN_MAX);
+        }
+    }
+}
+
+FilmGrainSynthesizer::FilmGrainSynthesizer()
+    : _renderer(nullptr)
+    , _context(nullptr)
+    , _descriptorSet(VK_NULL_HANDLE)
+    , _lastView(VK_NULL_HANDLE)
+    , _lastParams{}
+    , _lastWidth(0)
+    , _lastHeight(0)
+    , _lastSubX(-1)
+    , _lastSubY(-1)
+    , _active(false)
+    , _initialized(false)
+{
+}
+
+FilmGrainSynthesizer::~FilmGrainSynthesizer() {
+    Cleanup();
+}
+
+bool FilmGrainSynthesizer::Init(tvk::Renderer* renderer) {
+    if (_initialized) return true;
+
+    _renderer = renderer;
+    _context = &renderer->GetContext();
+
+    if (!CreateComputePipeline(_renderer, g_filmGrainComputeShader, "video_film_grain", 1, 1,
+                               sizeof(FilmGrainPushConstants), _pipeline)) {
+        TVK_LOG_ERROR("Failed to create compute pipeline for film grain");
+        return false;
+    }
+
+    if (!AllocateDescriptorSet(_context, _pipeline, _descriptorSet)) {
+        TVK_LOG_ERROR("Failed to allocate descriptor set for film grain");
+        return false;
+    }
+
+    if (!CreateHostBuffer(_context, sizeof(FilmGrainData), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                          HostMemory::Coherent, _buffer)) {
+        TVK_LOG_ERROR("Failed to create film grain parameter buffer");
+        return false;
+    }
+
+    WriteStorageBuffer(_context->GetDevice(), _descriptorSet, 1, _buffer);
+    _data = std::make_unique<FilmGrainData>();
+
+    _initialized = true;
+    return true;
+}
+
+void FilmGrainSynthesizer::Cleanup() {
+    if (!_context) return;
+
+    VkDevice device = _context->GetDevice();
+    if (!device) return;
+
+    vkDeviceWaitIdle(device);
+
+    DestroyHostBuffer(device, _buffer);
+    DestroyComputePipeline(device, _pipeline);
+    _data.reset();
+
+    _lastView = VK_NULL_HANDLE;
+    _lastWidth = 0;
+    _lastHeight = 0;
+    _active = false;
+    _initialized = false;
+}
+
+bool FilmGrainSynthesizer::Generate(const AVFilmGrainParams& params, int subX, int subY, int width, int height) {
+    const AVFilmGrainAOMParams& aom = params.codec.aom;
+    FilmGrainData& data = *_data;
+
+    int blocksX = ((width + 1) / 2 + 15) / 16;
+    int blocksY = ((height + 1) / 2 + 15) / 16;
+    if (blocksX * blocksY > FilmGrainData::MAX_BLOCKS) return false;
+
+    int chromaWidth = subX ? 44 : FilmGrainData::TEMPLATE_WIDTH;
+    int chromaHeight = subY ? 38 : FilmGrainData::TEMPLATE_HEIGHT;
+    bool lumaActive = aom.num_y_points > 0;
+    bool cbActive = aom.num_uv_points[0] > 0 || aom.chroma_scaling_from_luma;
+    bool crActive = aom.num_uv_points[1] > 0 || aom.chroma_scaling_from_luma;
+    uint16_t seed = static_cast<uint16_t>(params.seed);
+
+    int shift = 4 + aom.grain_scale_shift;
+    uint16_t state = seed;
+    for (int i = 0; i < FilmGrainData::TEMPLATE_SIZE; i++) {
+        int g = lumaActive ? g_gaussianSequence[NextRandom(state, 11)] : 0;
+        data.lumaGrain[i] = Round2(g, shift);
+    }
+
+    if (lumaActive) {
+        int lag = aom.ar_coeff_lag;
+        for (int y = 3; y < FilmGrainData::TEMPLATE_HEIGHT; y++) {
+            for (int x = 3; x < FilmGrainData::TEMPLATE_WIDTH - 3; x++) {
+                int sum = 0;
+                int pos = 0;
+                for (int dy = -lag; dy <= 0; dy++) {
+                    for (int dx = -lag; dx <= lag; dx++) {
+                        if (dy == 0 && dx == 0) break;
+                        sum += data.lumaGrain[(y + dy) * FilmGrainData::TEMPLATE_WIDTH + x + dx] * aom.ar_coeffs_y[pos];
+                        pos++;
+                    }
+                }
+                int index = y * FilmGrainData::TEMPLATE_WIDTH + x;
+                data.lumaGrain[index] = Clamp(data.lumaGrain[index] + Round2(sum, aom.ar_coeff_shift),
+                                              GRAIN_MIN, GRAIN_MAX);
+            }
+        }
+    }
+
+    GenerateChromaTemplate(data.cbGrain, data.lumaGrain, aom.ar_coeffs_uv[0], aom, seed ^ 0xb524,
+                           subX, subY, chromaWidth, chromaHeight, cbActive);
+    GenerateChromaTemplate(data.crGrain, data.lumaGrain, aom.ar_coeffs_uv[1], aom, seed ^ 0x49d8,
+                           subX, subY, chromaWidth, chromaHeight, crActive);
+
+    BuildScalingLut(aom.y_points, aom.num_y_points, data.scaling);
+    if (aom.chroma_scaling_from_luma) {
+        std::copy(data.scaling, data.scaling + 256, data.scaling + 256);
+        std::copy(data.scaling, data.scaling + 256, data.scaling + 512);
+    } else {
+        BuildScalingLut(aom.uv_points[0], aom.num_uv_points[0], data.scaling + 256);
+        BuildScalingLut(aom.uv_points[1], aom.num_uv_points[1], data.scaling + 512);
+    }
+
+    for (int stripe = 0; stripe < blocksY; stripe++) {
+        state = seed;
+        state ^= static_cast<uint16_t>(((stripe * 37 + 178) & 255) << 8);
+        state ^= static_cast<uint16_t>((stripe * 173 + 105) & 255);
+        for (int block = 0; block < blocksX; block++) {
+            data.offsets[stripe * blocksX + block] = NextRandom(state, 8);
+        }
+    }
+
+    std::fill(data.header, data.header + FilmGrainData::HEADER_SIZE, 0);
+    data.header[HEADER_SUB_X] = subX;
+    data.header[HEADER_SUB_Y] = subY;
+    data.header[HEADER_SCALING_SHIFT] = aom.scaling_shift;
+    data.header[HEADER_OVERLAP] = aom.overlap_flag;
+    data.header[HEADER_MIN_VALUE] = aom.limit_output_range ? 16 : 0;
+    data.header[HEADER_MAX_LUMA] = aom.limit_output_range ? 235 : 255;
+    data.header[HEADER_MAX_CHROMA] = aom.limit_output_range ? 240 : 255;
+    data.header[HEADER_BLOCKS_X] = blocksX;
+    data.header[HEADER_CHROMA_STRIDE] = chromaWidth;
+    data.header[HEADER_LUMA_ACTIVE] = lumaActive;
+    data.header[HEADER_CB_ACTIVE] = cbActive;
+    data.header[HEADER_CR_ACTIVE] = crActive;
+    if (aom.chroma_scaling_from_luma) {
+        data.header[HEADER_CB_LUMA_MULT] = 64;
+        data.header[HEADER_CR_LUMA_MULT] = 64;
+    } else {
+        data.header[HEADER_CB_MULT] = aom.uv_mult[0];
+        data.header[HEADER_CB_LUMA_MULT] = aom.uv_mult_luma[0];
+        data.header[HEADER_CB_OFFSET] = aom.uv_offset[0];
+        data.header[HEADER_CR_MULT] = aom.uv_mult[1];
+        data.header[HEADER_CR_LUMA_MULT] = aom.uv_mult_luma[1];
+        data.header[HEADER_CR_OFFSET] = aom.uv_offset[1];
+    }
+
+    size_t uploadSize = offsetof(FilmGrainData, offsets) + static_cast<size_t>(blocksX) * blocksY * sizeof(int32_t);
+    StreamCopy(_buffer.mapped, _data.get(), uploadSize);
+    return true;
+}
+
+void FilmGrainSynthesizer::Prepare(const FilmGrain& grain, int width, int height) {
+    _active = false;
+    if (!_initialized || !_settings.enabled || !grain.present) return;
+
+    bool changed = width != _lastWidth || height != _lastHeight ||
+                   grain.subsamplingX != _lastSubX || grain.subsamplingY != _lastSubY ||
+                   memcmp(&grain.params, &_lastParams, sizeof(AVFilmGrainParams)) != 0;
+
+    if (changed) {
+        if (!Generate(grain.params, grain.subsamplingX, grain.subsamplingY, width, height)) {
+            _lastWidth = 0;
+            return;
+        }
+        memcpy(&_lastParams, &grain.params, sizeof(AVFilmGrainParams));
+        _lastWidth = width;
+        _lastHeight = height;
+        _lastSubX = grain.subsamplingX;
+        _lastSubY = grain.subsamplingY;
+    }
+
+    _active = true;
+}
+
+void FilmGrainSynthesizer::Record(VkCommandBuffer cmd, tvk::Texture* texture) {
+    if (!_active || !texture) return;
+
+    VkImageView view = texture->GetImageView();
+    if (view != _lastView) {
+        WriteStorageImages(_context->GetDevice(), _descriptorSet, &view, 1);
+        _lastView = view;
+    }
+
+    FilmGrainPushConstants pc{};
+    pc.width = static_cast<int>(texture->GetWidth());
+    pc.height = static_cast<int>(texture->GetHeight());
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline.pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline.layout, 0, 1, &_descriptorSet, 0, nullptr);
+    vkCmdPushConstants(cmd, _pipeline.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(FilmGrainPushConstants), &pc);
+    vkCmdDispatch(cmd, (pc.width + 15) / 16, (pc.height + 15) / 16, 1);
+}
+
+} // namespace tvk_media
@@ -0,0 +1,181 @@
+#include "flight_recorder.h"
+#include "thread_stats.h"
+#include <tinyvk/core/log.h>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+
+namespace tvk_media {
+
+static std::string GetStateDirectory() {
+#if defined(_WIN32)
+    const char* local = std::getenv("LOCALAPPDATA");
+    if (local && *local) return std::string(local) + "/tvk-media-player/flight";
+#else
+    const char* state = std::getenv("XDG_STATE_HOME");
+    if (state && *state) return std::string(state) + "/tvk-media-player/flight";
+    const char* home = std::getenv("HOME");
+    if (home && *home) return std::string(home) + "/.local/state/tvk-media-player/flight";
+#endif
+    return "flight";
+}
+
+FlightRecorder::FlightRecorder()
+    : _written(0)
+    , _hitches(0)
+    , _dumps(0)
+    , _postRemaining(0)
+    , _pendingReason(nullptr)
+    , _pendingTime(0.0)
+    , _lastDumpTime(-DUMP_COOLDOWN)
+    , _windowCount(0)
+    , _windowReason(nullptr)
+    , _windowTime(0.0)
+    , _windowThreshold(0.0f)
+    , _dumpReady(false)
+    , _stopping(false)
+{
+}
+
+FlightRecorder::~FlightRecorder() {
+    Cleanup();
+}
+
+void FlightRecorder::Init() {
+    if (_writer.joinable()) return;
+    _directory = GetStateDirectory();
+    _stopping = false;
+    _writer = std::thread(&FlightRecorder::WriterLoop, this);
+    TVK_LOG_INFO("Flight recorder: {} samples, dumps to {}", CAPACITY, _directory);
+}
+
+void FlightRecorder::Cleanup() {
+    if (!_writer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _wake.notify_one();
+    _writer.join();
+}
+
+void FlightRecorder::Record(const FlightSample& sample) {
+    _ring[_written % CAPACITY] = sample;
+    _written++;
+    if (!_settings.enabled) return;
+
+    if (_pendingReason) {
+        if (--_postRemaining <= 0) Capture();
+        return;
+    }
+
+    const char* reason = nullptr;
+    if ((sample.flags & FLAG_PRESENTED) && sample.lateMs > _settings.hitchThresholdMs) {
+        reason = "late frame";
+    } else if ((sample.flags & FLAG_UNDERRUN) && _settings.dumpOnUnderrun) {
+        reason = "audio underrun";
+    }
+    if (!reason) return;
+
+    _hitches++;
+    if (_dumps >= MAX_DUMPS || sample.time - _lastDumpTime < DUMP_COOLDOWN) return;
+
+    _pendingReason = reason;
+    _pendingTime = sample.time;
+    _postRemaining = POST_SAMPLES;
+}
+
+void FlightRecorder::Trigger(const char* reason) {
+    if (_pendingReason || _written == 0) return;
+    _pendingReason = reason;
+    _pendingTime = _ring[(_written - 1) % CAPACITY].time;
+    Capture();
+}
+
+void FlightRecorder::Capture() {
+    const char* reason = _pendingReason;
+    _pendingReason = nullptr;
+    _lastDumpTime = _pendingTime;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_dumpReady || !_writer.joinable()) {
+            TVK_LOG_ERROR("Flight recorder busy, dropped {} dump at {:.3f}s", reason, _pendingTime);
+            return;
+        }
+
+        int count = _written < static_cast<uint64_t>(WINDOW) ? static_cast<int>(_written) : WINDOW;
+        for (int i = 0; i < count; i++) {
+            _window[i] = _ring[(_written - count + i) % CAPACITY];
+        }
+        _windowCount = count;
+        _windowReason = reason;
+        _windowTime = _pendingTime;
+        _windowThreshold = _settings.hitchThresholdMs;
+        _dumps++;
+        _dumpReady = true;
+    }
+    _wake.notify_one();
+}
+
+void FlightRecorder::WriterLoop() {
+    ThreadStats::RegisterCurrentThread(ThreadRole::Background);
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _wake.wait(lock, [this]() { return _dumpReady || _stopping; });
+        if (!_dumpReady) break;
+
+        lock.unlock();
+        WriteDump();
+        lock.lock();
+        _dumpReady = false;
+    }
+}
+
+void FlightRecorder::WriteDump() {
+    std::error_code error;
+    std::filesystem::create_directories(_directory, error);
+
+    char stamp[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+
+    char name[64];
+    snprintf(name, sizeof(name), "/flight-%s-%02d.json", stamp, _dumps);
+    std::string path = _directory + name;
+
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        TVK_LOG_ERROR("Flight recorder could not write {}", path);
+        return;
+    }
+
+    fprintf(file, "{\"reason\":\"%s\",\"time\":%.4f,\"threshold_ms\":%.1f,", _windowReason, _windowTime,
+            _windowThreshold);
+    fprintf(file, "\"flags\":{\"presented\":%d,\"underrun\":%d,\"seek\":%d,\"playing\":%d},",
+            FLAG_PRESENTED, FLAG_UNDERRUN, FLAG_SEEK, FLAG_PLAYING);
+    fprintf(file, "\"fields\":[\"time\",\"frame_ms\",\"late_ms\",\"drift_ms\",\"queue\",\"capacity\","
+                  "\"underruns\",\"flags\"],\n\"samples\":[");
+    for (int i = 0; i < _windowCount; i++) {
+        const FlightSample& sample = _window[i];
+        fprintf(file, "%s\n[%.4f,%.2f,%.2f,%.2f,%u,%u,%u,%u]", i ? "," : "", sample.time, sample.frameMs,
+                sample.lateMs, sample.driftMs, sample.queueDepth, sample.queueCapacity, sample.underruns,
+                sample.flags);
+    }
+    fprintf(file, "]}\n");
+    fclose(file);
+
+    TVK_LOG_INFO("Flight recorder: {} at {:.3f}s, {} samples written to {}", _windowReason, _windowTime,
+                 _windowCount, path);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _lastPath = path;
+}
+
+std::string FlightRecorder::GetLastDumpPath() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _lastPath;
+}
+
+} // namespace tvk_media
@@ -0,0 +1,115 @@
+#include "frame_copy.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TVK_MEDIA_COPY_SSE2 1
+#endif
+
+namespace tvk_media {
+
+#if defined(TVK_MEDIA_COPY_SSE2)
+
+static inline void StreamLine(uint8_t* dst, const uint8_t* src) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst), a);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), b);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), c);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), d);
+}
+
+static inline void StreamPartial(uint8_t* dst, const uint8_t* src, size_t size) {
+    while (size >= 16 && (reinterpret_cast<uintptr_t>(dst) & 15) == 0) {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst),
+                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+        dst += 16;
+        src += 16;
+        size -= 16;
+    }
+    while (size >= 4 && (reinterpret_cast<uintptr_t>(dst) & 3) == 0) {
+        int value;
+        memcpy(&value, src, 4);
+        _mm_stream_si32(reinterpret_cast<int*>(dst), value);
+        dst += 4;
+        src += 4;
+        size -= 4;
+    }
+    if (size > 0) {
+        memcpy(dst, src, size);
+    }
+}
+
+static void StreamRow(uint8_t* dst, const uint8_t* src, size_t size, size_t writable) {
+    size_t misalign = reinterpret_cast<uintptr_t>(dst) & (COPY_LINE_SIZE - 1);
+    if (misalign != 0) {
+        size_t head = COPY_LINE_SIZE - misalign;
+        if (head > size) head = size;
+        StreamPartial(dst, src, head);
+        dst += head;
+        src += head;
+        size -= head;
+        writable -= head;
+    }
+
+    size_t lines = size / COPY_LINE_SIZE;
+    for (size_t i = 0; i < lines; i++) {
+        StreamLine(dst, src);
+        dst += COPY_LINE_SIZE;
+        src += COPY_LINE_SIZE;
+    }
+
+    size_t tail = size - lines * COPY_LINE_SIZE;
+    if (tail == 0) return;
+
+    if (writable - lines * COPY_LINE_SIZE >= COPY_LINE_SIZE) {
+        alignas(16) uint8_t line[COPY_LINE_SIZE];
+        memcpy(line, src, tail);
+        memset(line + tail, 0, COPY_LINE_SIZE - tail);
+        StreamLine(dst, line);
+    } else {
+        StreamPartial(dst, src, tail);
+    }
+}
+
+void StreamCopy(void* dst, const void* src, size_t size) {
+    StreamRow(static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src), size, size);
+    _mm_sfence();
+}
+
+void StreamCopyPlane(uint8_t* dst, size_t dstPitch, const uint8_t* src, size_t srcPitch,
+                     size_t rowBytes, size_t rows) {
+    if (dstPitch == rowBytes && srcPitch == rowBytes) {
+        StreamCopy(dst, src, rowBytes * rows);
+        return;
+    }
+
+    for (size_t y = 0; y < rows; y++) {
+        StreamRow(dst + y * dstPitch, src + y * srcPitch, rowBytes, dstPitch);
+    }
+    _mm_sfence();
+}
+
+#else
+
+void StreamCopy(void* dst, const void* src, size_t size) {
+    memcpy(dst, src, size);
+}
+
+void StreamCopyPlane(uint8_t* dst, size_t dstPitch, const uint8_t* src, size_t srcPitch,
+                     size_t rowBytes, size_t rows) {
+    if (dstPitch == rowBytes && srcPitch == rowBytes) {
+        memcpy(dst, src, rowBytes * rows);
+        return;
+    }
+
+    for (size_t y = 0; y < rows; y++) {
+        memcpy(dst + y * dstPitch, src + y * srcPitch, rowBytes);
+    }
+}
+
+#endif
+
+} // namespace tvk_media
@@ -0,0 +1,75 @@
+#include "frame_queue.h"
+#include <algorithm>
+
+namespace tvk_media {
+
+FrameQueue::FrameQueue()
+    : _head(0)
+    , _size(0)
+    , _capacity(1)
+    , _length(1)
+{
+    for (int i = 0; i < MAX_FRAMES; i++) {
+        _frames[i].width = 0;
+        _frames[i].height = 0;
+        _frames[i].timestamp = 0.0;
+    }
+}
+
+void FrameQueue::SetCapacity(int capacity) {
+    if (capacity < 1) capacity = 1;
+    if (capacity > MAX_FRAMES) capacity = MAX_FRAMES;
+    if (capacity == _capacity) return;
+    _capacity = capacity;
+    Compact();
+}
+
+// The ring wraps at the capacity so only that many slots ever hold frame buffers.
+// Queued frames are rotated to the front when it changes; a shrink waits for them to drain.
+void FrameQueue::Compact() {
+    std::rotate(_frames, _frames + _head, _frames + _length);
+    _head = 0;
+    _length = std::max(_capacity, _size);
+}
+
+VideoFrame& FrameQueue::Back() {
+    return _frames[(_head + _size) % _length];
+}
+
+void FrameQueue::Push() {
+    if (_size < _length) _size++;
+}
+
+const VideoFrame& FrameQueue::At(int index) const {
+    return _frames[(_head + index) % _length];
+}
+
+void FrameQueue::PopInto(VideoFrame& outFrame) {
+    if (_size == 0) return;
+    VideoFrame& front = _frames[_head];
+    outFrame.data.swap(front.data);
+    outFrame.width = front.width;
+    outFrame.height = front.height;
+    outFrame.timestamp = front.timestamp;
+    outFrame.grain = front.grain;
+    outFrame.raw = front.raw;
+    outFrame.source = front.source;
+    _head = (_head + 1) % _length;
+    _size--;
+    if (_length > _capacity && _size <= _capacity) Compact();
+}
+
+void FrameQueue::ReleaseUnused() {
+    for (int i = 0; i < MAX_FRAMES; i++) {
+        bool queued = i < _length && (i - _head + _length) % _length < _size;
+        if (!queued) std::vector<uint8_t>().swap(_frames[i].data);
+    }
+}
+
+void FrameQueue::Clear() {
+    _head = 0;
+    _size = 0;
+    _length = _capacity;
+}
+
+} // namespace tvk_media
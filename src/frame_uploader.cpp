@@ -0,0 +1,265 @@
+#include "frame_uploader.h"
+#include "frame_copy.h"
+#include <tinyvk/renderer/renderer.h>
+#include <tinyvk/core/log.h>
+
+namespace tvk_media {
+
+static const char* g_rawUnpackComputeShader = R"(
+#version 450
+
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+layout(binding = 0, rgba8) uniform writeonly image2D frameImage;
+
+layout(std430, binding = 1) readonly buffer RawData {
+    uint words[];
+} raw;
+
+layout(push_constant) uniform PushConstants {
+    int width;
+    int height;
+    int format;
+    int bt709;
+    int pitch;
+    int chromaOffset;
+    int chromaPitch;
+    int crOffset;
+} pc;
+
+const int FORMAT_V210 = 1;
+const int FORMAT_UYVY = 2;
+const int FORMAT_YUYV = 3;
+const int FORMAT_YUV420P = 4;
+const int FORMAT_YUV420P10 = 5;
+const int FORMAT_RGB24 = 6;
+const int FORMAT_RGBA = 7;
+const int FORMAT_BGRA = 8;
+
+uint read8(int offset) {
+    return (raw.words[offset >> 2] >> ((offset & 3) * 8)) & 0xFFu;
+}
+
+uint read16(int offset) {
+    return (raw.words[offset >> 2] >> ((offset & 2) * 8)) & 0xFFFFu;
+}
+
+uint v210(int blockOffset, int index) {
+    return (raw.words[(blockOffset >> 2) + index / 3] >> ((index % 3) * 10)) & 0x3FFu;
+}
+
+vec3 yuv_to_rgb(uint y, uint cb, uint cr) {
+    float luma = (float(y) - 64.0) / 876.0;
+    float u = (float(cb) - 512.0) / 896.0;
+    float v = (float(cr) - 512.0) / 896.0;
+    if (pc.bt709 != 0) {
+        return vec3(luma + 1.5748 * v, luma - 0.1873 * u - 0.4681 * v, luma + 1.8556 * u);
+    }
+    return vec3(luma + 1.402 * v, luma - 0.3441 * u - 0.7141 * v, luma + 1.772 * u);
+}
+
+void main() {
+    ivec2 pos = ivec2(gl_GlobalInvocationID.xy);
+    if (pos.x >= pc.width || pos.y >= pc.height) return;
+
+    int row = pos.y * pc.pitch;
+    vec3 rgb;
+
+    if (pc.format == FORMAT_V210) {
+        int block = row + (pos.x / 6) * 16;
+        int i = pos.x % 6;
+        int k = i / 2;
+        rgb = yuv_to_rgb(v210(block, i * 2 + 1), v210(block, k * 4), v210(block, k * 4 + 2));
+    } else if (pc.format == FORMAT_UYVY || pc.format == FORMAT_YUYV) {
+        int pair = row + (pos.x / 2) * 4;
+        int lumaOffset = pc.format == FORMAT_UYVY ? 1 : 0;
+        int chromaOffset = 1 - lumaOffset;
+        uint y = read8(pair + lumaOffset + (pos.x & 1) * 2);
+        rgb = yuv_to_rgb(y * 4u, read8(pair + chromaOffset) * 4u, read8(pair + chromaOffset + 2) * 4u);
+    } else if (pc.format == FORMAT_YUV420P) {
+        int chroma = (pos.y / 2) * pc.chromaPitch + pos.x / 2;
+        rgb = yuv_to_rgb(read8(row + pos.x) * 4u, read8(pc.chromaOffset + chroma) * 4u,
+                         read8(pc.crOffset + chroma) * 4u);
+    } else if (pc.format == FORMAT_YUV420P10) {
+        int chroma = (pos.y / 2) * pc.chromaPitch + (pos.x / 2) * 2;
+        rgb = yuv_to_rgb(read16(row + pos.x * 2), read16(pc.chromaOffset + chroma), read16(pc.crOffset + chroma));
+    } else if (pc.format == FORMAT_RGB24) {
+        int pixel = row + pos.x * 3;
+        rgb = vec3(float(read8(pixel)), float(read8(pixel + 1)), float(read8(pixel + 2))) / 255.0;
+    } else {
+        vec4 color = unpackUnorm4x8(raw.words[(row >> 2) + pos.x]);
+        rgb = pc.format == FORMAT_BGRA ? color.bgr : color.rgb;
+    }
+
+    imageStore(frameImage, pos, vec4(clamp(rgb, 0.0, 1.0), 1.0));
+}
+)";
+
+FrameUploader::FrameUploader()
+    : _renderer(nullptr)
+    , _context(nullptr)
+    , _rawDescriptorSet(VK_NULL_HANDLE)
+    , _rawView(VK_NULL_HANDLE)
+    , _rawSupported(false)
+    , _initialized(false)
+{
+}
+
+FrameUploader::~FrameUploader() {
+    Cleanup();
+}
+
+bool FrameUploader::Init(tvk::Renderer* renderer) {
+    if (_initialized) return true;
+
+    _renderer = renderer;
+    _context = &renderer->GetContext();
+
+    if (CreateComputePipeline(_renderer, g_rawUnpackComputeShader, "raw_unpack", 1, 1,
+                              sizeof(RawUnpackPushConstants), _rawPipeline) &&
+        AllocateDescriptorSet(_context, _rawPipeline, _rawDescriptorSet)) {
+        _rawSupported = true;
+    } else {
+        TVK_LOG_ERROR("Failed to create raw unpack pipeline; raw video is converted on the CPU");
+    }
+
+    _initialized = true;
+    return true;
+}
+
+void FrameUploader::Cleanup() {
+    if (!_context) return;
+
+    VkDevice device = _context->GetDevice();
+    if (!device) return;
+
+    vkDeviceWaitIdle(device);
+    DestroyHostBuffer(device, _staging);
+    DestroyHostBuffer(device, _rawBuffer);
+    DestroyComputePipeline(device, _rawPipeline);
+    _rawView = VK_NULL_HANDLE;
+    _rawSupported = false;
+    _initialized = false;
+}
+
+bool FrameUploader::Upload(tvk::Texture* texture, const uint8_t* data, uint32_t width, uint32_t height,
+                           size_t srcPitch) {
+    if (!data) return false;
+
+    size_t pitch = 0;
+    uint8_t* staging = MapUpload(texture, width, height, pitch);
+    if (!staging) return false;
+
+    StreamCopyPlane(staging, pitch, data, srcPitch, static_cast<size_t>(width) * 4, height);
+    return SubmitUpload(texture, width, height, pitch);
+}
+
+uint8_t* FrameUploader::MapUpload(tvk::Texture* texture, uint32_t width, uint32_t height, size_t& pitch) {
+    if (!_initialized || !texture) return nullptr;
+    if (texture->GetWidth() != width || texture->GetHeight() != height) return nullptr;
+
+    pitch = AlignCopyPitch(static_cast<size_t>(width) * 4);
+    VkDeviceSize size = static_cast<VkDeviceSize>(pitch) * height;
+
+    if (_staging.size < size) {
+        vkDeviceWaitIdle(_context->GetDevice());
+        if (!CreateHostBuffer(_context, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, HostMemory::Coherent, _staging)) {
+            TVK_LOG_ERROR("Failed to create frame upload staging buffer");
+            return nullptr;
+        }
+    }
+    return static_cast<uint8_t*>(_staging.mapped);
+}
+
+bool FrameUploader::SubmitUpload(tvk::Texture* texture, uint32_t width, uint32_t height, size_t pitch) {
+    if (!_initialized || !texture || _staging.size < static_cast<VkDeviceSize>(pitch) * height) return false;
+
+    VkCommandBuffer cmd = _context->BeginSingleTimeCommands();
+
+    TransitionImage(cmd, texture->GetImage(),
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    VkBufferImageCopy region{};
+    region.bufferOffset = 0;
+    region.bufferRowLength = static_cast<uint32_t>(pitch / 4);
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = {0, 0, 0};
+    region.imageExtent = {width, height, 1};
+
+    vkCmdCopyBufferToImage(cmd, _staging.buffer, texture->GetImage(),
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    TransitionImage(cmd, texture->GetImage(),
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+    _context->EndSingleTimeCommands(cmd);
+    return true;
+}
+
+bool FrameUploader::UploadRaw(tvk::Texture* texture, const RawFrame& frame, uint32_t width, uint32_t height) {
+    if (!_initialized || !_rawSupported || !texture || !frame.data) return false;
+    if (texture->GetWidth() != width || texture->GetHeight() != height) return false;
+
+    VkDevice device = _context->GetDevice();
+    VkDeviceSize size = (static_cast<VkDeviceSize>(frame.size) + 3) & ~static_cast<VkDeviceSize>(3);
+    if (_rawBuffer.size < size) {
+        vkDeviceWaitIdle(device);
+        if (!CreateHostBuffer(_context, size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, HostMemory::Coherent, _rawBuffer)) {
+            TVK_LOG_ERROR("Failed to create raw frame buffer");
+            return false;
+        }
+        WriteStorageBuffer(device, _rawDescriptorSet, 1, _rawBuffer);
+    }
+
+    StreamCopy(_rawBuffer.mapped, frame.data, frame.size);
+
+    VkImageView view = texture->GetImageView();
+    if (view != _rawView) {
+        WriteStorageImages(device, _rawDescriptorSet, &view, 1);
+        _rawView = view;
+    }
+
+    RawUnpackPushConstants pc{};
+    pc.width = static_cast<int>(width);
+    pc.height = static_cast<int>(height);
+    pc.format = static_cast<int>(frame.format);
+    pc.bt709 = frame.bt709 ? 1 : 0;
+    pc.pitch = frame.pitch;
+    pc.chromaOffset = frame.chromaOffset;
+    pc.chromaPitch = frame.chromaPitch;
+    pc.crOffset = frame.crOffset;
+
+    VkCommandBuffer cmd = _context->BeginSingleTimeCommands();
+
+    TransitionImage(cmd, texture->GetImage(),
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL,
+        VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _rawPipeline.pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _rawPipeline.layout, 0, 1, &_rawDescriptorSet, 0, nullptr);
+    vkCmdPushConstants(cmd, _rawPipeline.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(RawUnpackPushConstants), &pc);
+    vkCmdDispatch(cmd, (width + 15) / 16, (height + 15) / 16, 1);
+
+    TransitionImage(cmd, texture->GetImage(),
+        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+    _context->EndSingleTimeCommands(cmd);
+    return true;
+}
+
+} // namespace tvk_media
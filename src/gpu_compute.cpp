@@ -0,0 +1,387 @@
+#include "gpu_compute.h"
+#include <tinyvk/renderer/shader_compiler.h>
+#include <tinyvk/renderer/renderer.h>
+#include <tinyvk/core/log.h>
+#include <atomic>
+
+namespace tvk_media {
+
+static constexpr uint32_t MAX_BINDINGS = 8;
+
+static std::atomic<int64_t> g_liveObjects{0};
+static std::atomic<int64_t> g_descriptorSets{0};
+static std::atomic<uint64_t> g_texturesCreated{0};
+
+static inline void CountCreated() {
+    g_liveObjects.fetch_add(1, std::memory_order_relaxed);
+}
+
+static inline void CountDestroyed() {
+    g_liveObjects.fetch_sub(1, std::memory_order_relaxed);
+}
+
+GpuObjectCounts GetGpuObjectCounts() {
+    GpuObjectCounts counts;
+    counts.liveObjects = g_liveObjects.load(std::memory_order_relaxed);
+    counts.descriptorSets = g_descriptorSets.load(std::memory_order_relaxed);
+    counts.texturesCreated = g_texturesCreated.load(std::memory_order_relaxed);
+    return counts;
+}
+
+void CountTextureCreated() {
+    g_texturesCreated.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool CreateComputePipeline(tvk::Renderer* renderer, const char* source, const char* name,
+                           uint32_t storageImageCount, uint32_t storageBufferCount,
+                           uint32_t pushConstantSize, ComputePipeline& out) {
+    VkDevice device = renderer->GetContext().GetDevice();
+    uint32_t bindingCount = storageImageCount + storageBufferCount;
+    if (bindingCount > MAX_BINDINGS) return false;
+
+    VkDescriptorSetLayoutBinding bindings[MAX_BINDINGS]{};
+    for (uint32_t i = 0; i < bindingCount; i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = i < storageImageCount
+            ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+            : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        bindings[i].pImmutableSamplers = nullptr;
+    }
+
+    VkDescriptorSetLayoutCreateInfo setLayoutInfo{};
+    setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    setLayoutInfo.bindingCount = bindingCount;
+    setLayoutInfo.pBindings = bindings;
+
+    if (vkCreateDescriptorSetLayout(device, &setLayoutInfo, nullptr, &out.setLayout) != VK_SUCCESS) {
+        return false;
+    }
+    CountCreated();
+
+    out.shader = tvk::ShaderCompiler::CreateShaderModuleFromGLSL(
+        renderer, source, tvk::ShaderStage::Compute, name
+    );
+
+    if (out.shader == VK_NULL_HANDLE) {
+        TVK_LOG_ERROR("Failed to compile {} compute shader", name);
+        return false;
+    }
+    CountCreated();
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = pushConstantSize;
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &out.setLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &out.layout) != VK_SUCCESS) {
+        return false;
+    }
+    CountCreated();
+
+    VkPipelineShaderStageCreateInfo stageInfo{};
+    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    stageInfo.module = out.shader;
+    stageInfo.pName = "main";
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage = stageInfo;
+    pipelineInfo.layout = out.layout;
+
+    if (vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &out.pipeline) != VK_SUCCESS) {
+        return false;
+    }
+    CountCreated();
+
+    return true;
+}
+
+void DestroyComputePipeline(VkDevice device, ComputePipeline& pipeline) {
+    if (pipeline.pipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device, pipeline.pipeline, nullptr);
+        CountDestroyed();
+        pipeline.pipeline = VK_NULL_HANDLE;
+    }
+
+    if (pipeline.layout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(device, pipeline.layout, nullptr);
+        CountDestroyed();
+        pipeline.layout = VK_NULL_HANDLE;
+    }
+
+    if (pipeline.shader != VK_NULL_HANDLE) {
+        vkDestroyShaderModule(device, pipeline.shader, nullptr);
+        CountDestroyed();
+        pipeline.shader = VK_NULL_HANDLE;
+    }
+
+    if (pipeline.setLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device, pipeline.setLayout, nullptr);
+        CountDestroyed();
+        pipeline.setLayout = VK_NULL_HANDLE;
+    }
+}
+
+bool AllocateDescriptorSet(tvk::VulkanContext* context, const ComputePipeline& pipeline, VkDescriptorSet& out) {
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = context->GetDescriptorPool();
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &pipeline.setLayout;
+
+    if (vkAllocateDescriptorSets(context->GetDevice(), &allocInfo, &out) != VK_SUCCESS) {
+        return false;
+    }
+    g_descriptorSets.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void WriteStorageImages(VkDevice device, VkDescriptorSet set, const VkImageView* views, uint32_t count) {
+    if (count > MAX_BINDINGS) return;
+
+    VkDescriptorImageInfo imageInfos[MAX_BINDINGS]{};
+    VkWriteDescriptorSet writes[MAX_BINDINGS]{};
+    for (uint32_t i = 0; i < count; i++) {
+        imageInfos[i].imageView = views[i];
+        imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = set;
+        writes[i].dstBinding = i;
+        writes[i].dstArrayElement = 0;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        writes[i].descriptorCount = 1;
+        writes[i].pImageInfo = &imageInfos[i];
+    }
+
+    vkUpdateDescriptorSets(device, count, writes, 0, nullptr);
+}
+
+void WriteStorageBuffer(VkDevice device, VkDescriptorSet set, uint32_t binding, const HostBuffer& buffer) {
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = buffer.buffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = buffer.size;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = set;
+    write.dstBinding = binding;
+    write.dstArrayElement = 0;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.descriptorCount = 1;
+    write.pBufferInfo = &bufferInfo;
+
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
+
+bool CreateStorageImage(tvk::VulkanContext* context, uint32_t width, uint32_t height,
+                        VkImageUsageFlags usage, StorageImage& out) {
+    if (out.image != VK_NULL_HANDLE && out.width == width && out.height == height) {
+        return true;
+    }
+
+    VkDevice device = context->GetDevice();
+    DestroyStorageImage(device, out);
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    imageInfo.extent.width = width;
+    imageInfo.extent.height = height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = usage;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    if (vkCreateImage(device, &imageInfo, nullptr, &out.image) != VK_SUCCESS) {
+        return false;
+    }
+    CountCreated();
+
+    VkMemoryRequirements memReqs;
+    vkGetImageMemoryRequirements(device, out.image, &memReqs);
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memReqs.size;
+    allocInfo.memoryTypeIndex = context->FindMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    if (vkAllocateMemory(device, &allocInfo, nullptr, &out.memory) != VK_SUCCESS) {
+        DestroyStorageImage(device, out);
+        return false;
+    }
+    CountCreated();
+
+    vkBindImageMemory(device, out.image, out.memory, 0);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = out.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(device, &viewInfo, nullptr, &out.view) != VK_SUCCESS) {
+        DestroyStorageImage(device, out);
+        return false;
+    }
+    CountCreated();
+
+    out.width = width;
+    out.height = height;
+    return true;
+}
+
+void DestroyStorageImage(VkDevice device, StorageImage& image) {
+    if (image.view != VK_NULL_HANDLE) {
+        vkDestroyImageView(device, image.view, nullptr);
+        CountDestroyed();
+        image.view = VK_NULL_HANDLE;
+    }
+
+    if (image.image != VK_NULL_HANDLE) {
+        vkDestroyImage(device, image.image, nullptr);
+        CountDestroyed();
+        image.image = VK_NULL_HANDLE;
+    }
+
+    if (image.memory != VK_NULL_HANDLE) {
+        vkFreeMemory(device, image.memory, nullptr);
+        CountDestroyed();
+        image.memory = VK_NULL_HANDLE;
+    }
+
+    image.width = 0;
+    image.height = 0;
+}
+
+uint32_t FindHostMemoryType(tvk::VulkanContext* context, uint32_t typeBits, HostMemory kind) {
+    if (kind == HostMemory::Coherent) {
+        return context->FindMemoryType(typeBits,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    }
+
+    VkPhysicalDeviceMemoryProperties memProps;
+    vkGetPhysicalDeviceMemoryProperties(context->GetPhysicalDevice(), &memProps);
+
+    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+        if (!(typeBits & (1u << i))) continue;
+
+        VkMemoryPropertyFlags flags = memProps.memoryTypes[i].propertyFlags;
+        if (!(flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) continue;
+
+        bool cached = (flags & VK_MEMORY_PROPERTY_HOST_CACHED_BIT) != 0;
+        if (cached == (kind == HostMemory::Cached)) {
+            return i;
+        }
+    }
+
+    return UINT32_MAX;
+}
+
+bool CreateHostBuffer(tvk::VulkanContext* context, VkDeviceSize size, VkBufferUsageFlags usage,
+                      HostMemory kind, HostBuffer& out) {
+    VkDevice device = context->GetDevice();
+    DestroyHostBuffer(device, out);
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(device, &bufferInfo, nullptr, &out.buffer) != VK_SUCCESS) {
+        return false;
+    }
+    CountCreated();
+
+    VkMemoryRequirements memReqs;
+    vkGetBufferMemoryRequirements(device, out.buffer, &memReqs);
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memReqs.size;
+    allocInfo.memoryTypeIndex = FindHostMemoryType(context, memReqs.memoryTypeBits, kind);
+
+    if (allocInfo.memoryTypeIndex == UINT32_MAX ||
+        vkAllocateMemory(device, &allocInfo, nullptr, &out.memory) != VK_SUCCESS) {
+        DestroyHostBuffer(device, out);
+        return false;
+    }
+    CountCreated();
+
+    vkBindBufferMemory(device, out.buffer, out.memory, 0);
+
+    if (vkMapMemory(device, out.memory, 0, size, 0, &out.mapped) != VK_SUCCESS) {
+        DestroyHostBuffer(device, out);
+        return false;
+    }
+
+    out.size = size;
+    return true;
+}
+
+void DestroyHostBuffer(VkDevice device, HostBuffer& buffer) {
+    if (buffer.mapped) {
+        vkUnmapMemory(device, buffer.memory);
+        buffer.mapped = nullptr;
+    }
+
+    if (buffer.buffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device, buffer.buffer, nullptr);
+        CountDestroyed();
+        buffer.buffer = VK_NULL_HANDLE;
+    }
+
+    if (buffer.memory != VK_NULL_HANDLE) {
+        vkFreeMemory(device, buffer.memory, nullptr);
+        CountDestroyed();
+        buffer.memory = VK_NULL_HANDLE;
+    }
+
+    buffer.size = 0;
+}
+
+void TransitionImage(VkCommandBuffer cmd, VkImage image,
+                     VkImageLayout oldLayout, VkImageLayout newLayout,
+                     VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+                     VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage) {
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+
+    vkCmdPipelineBarrier(cmd, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+} // namespace tvk_media
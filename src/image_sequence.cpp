@@ -0,0 +1,438 @@
+#include "image_sequence.h"
+#include "thread_stats.h"
+#include "video_decoder.h"
+#include <tinyvk/core/log.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <filesystem>
+#include <map>
+#include <utility>
+
+namespace tvk_media {
+
+static std::atomic<double> g_sequenceFrameRate{ ImageSequence::DEFAULT_FRAME_RATE };
+
+static const char* IMAGE_EXTENSIONS[] = { ".dpx", ".exr", ".png", ".tif", ".tiff", ".jpg", ".jpeg", ".bmp", ".tga" };
+
+struct ImageInfo {
+    int width = 0;
+    int height = 0;
+    std::string codec;
+};
+
+static bool IsImageFile(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (const char* candidate : IMAGE_EXTENSIONS) {
+        if (extension == candidate) return true;
+    }
+    return false;
+}
+
+static bool SplitFrameNumber(const std::string& name, std::string& prefix, std::string& suffix, long long& number) {
+    size_t dot = name.rfind('.');
+    if (dot == std::string::npos) return false;
+
+    size_t end = dot;
+    size_t start = end;
+    while (start > 0 && std::isdigit(static_cast<unsigned char>(name[start - 1]))) {
+        start--;
+    }
+    if (start == end || end - start > 18) return false;
+
+    prefix = name.substr(0, start);
+    suffix = name.substr(end);
+    number = std::stoll(name.substr(start, end - start));
+    return true;
+}
+
+static bool SplitPattern(const std::string& name, std::string& prefix, std::string& suffix) {
+    size_t percent = name.find('%');
+    if (percent != std::string::npos) {
+        size_t d = name.find('d', percent);
+        if (d == std::string::npos) return false;
+        for (size_t i = percent + 1; i < d; i++) {
+            if (!std::isdigit(static_cast<unsigned char>(name[i]))) return false;
+        }
+        prefix = name.substr(0, percent);
+        suffix = name.substr(d + 1);
+        return true;
+    }
+
+    size_t hash = name.find('#');
+    if (hash == std::string::npos) return false;
+    size_t end = name.find_first_not_of('#', hash);
+    prefix = name.substr(0, hash);
+    suffix = end == std::string::npos ? std::string() : name.substr(end);
+    return true;
+}
+
+static bool ScanSequence(const std::string& path, std::vector<std::string>& files, std::string& pattern) {
+    std::error_code error;
+    std::filesystem::path input(path);
+    std::filesystem::path directory;
+    std::string prefix;
+    std::string suffix;
+    bool anyName = false;
+
+    if (std::filesystem::is_directory(input, error)) {
+        directory = input;
+        anyName = true;
+    } else {
+        directory = input.parent_path();
+        std::string name = input.filename().string();
+        long long number = 0;
+        if (!SplitPattern(name, prefix, suffix) && !SplitFrameNumber(name, prefix, suffix, number)) return false;
+    }
+    if (directory.empty()) directory = ".";
+
+    std::map<std::pair<std::string, std::string>, std::vector<std::pair<long long, std::string>>> groups;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (!entry.is_regular_file(error) || !IsImageFile(entry.path())) continue;
+
+        std::string entryPrefix;
+        std::string entrySuffix;
+        long long number = 0;
+        if (!SplitFrameNumber(entry.path().filename().string(), entryPrefix, entrySuffix, number)) continue;
+        if (!anyName && (entryPrefix != prefix || entrySuffix != suffix)) continue;
+        groups[{ entryPrefix, entrySuffix }].push_back({ number, entry.path().string() });
+    }
+
+    auto best = groups.end();
+    for (auto it = groups.begin(); it != groups.end(); ++it) {
+        if (best == groups.end() || it->second.size() > best->second.size()) best = it;
+    }
+    if (best == groups.end()) return false;
+
+    std::sort(best->second.begin(), best->second.end());
+    size_t digits = std::filesystem::path(best->second.front().second).filename().string().size() -
+                    best->first.first.size() - best->first.second.size();
+    files.clear();
+    files.reserve(best->second.size());
+    for (auto& frame : best->second) {
+        files.push_back(std::move(frame.second));
+    }
+    pattern = (directory / (best->first.first + std::string(digits, '#') + best->first.second)).string();
+    return true;
+}
+
+static bool DecodeImage(const std::string& path, int width, int height, SwsContext*& sws,
+                        std::vector<uint8_t>* out, ImageInfo* info) {
+    AVFormatContext* format = nullptr;
+    if (avformat_open_input(&format, path.c_str(), nullptr, nullptr) < 0) return false;
+
+    AVCodecContext* codec = nullptr;
+    AVPacket* packet = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+    const AVCodec* decoder = nullptr;
+    bool decoded = false;
+
+    int stream = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, &decoder, 0);
+    if (stream >= 0 && decoder && packet && frame) {
+        codec = avcodec_alloc_context3(decoder);
+    }
+    if (codec && avcodec_parameters_to_context(codec, format->streams[stream]->codecpar) >= 0) {
+        codec->thread_count = 1;
+        AVDictionary* options = nullptr;
+        if (decoder->id == AV_CODEC_ID_EXR) {
+            av_dict_set(&options, "apply_trc", "iec61966_2_1", 0);
+        }
+        if (avcodec_open2(codec, decoder, &options) >= 0) {
+            while (!decoded && av_read_frame(format, packet) >= 0) {
+                if (packet->stream_index == stream && avcodec_send_packet(codec, packet) >= 0) {
+                    decoded = avcodec_receive_frame(codec, frame) >= 0;
+                }
+                av_packet_unref(packet);
+            }
+            if (!decoded && avcodec_send_packet(codec, nullptr) >= 0) {
+                decoded = avcodec_receive_frame(codec, frame) >= 0;
+            }
+        }
+        av_dict_free(&options);
+    }
+
+    if (decoded && info) {
+        info->width = frame->width;
+        info->height = frame->height;
+        info->codec = decoder->name;
+    }
+
+    if (decoded && out) {
+        sws = sws_getCachedContext(
+            sws,
+            frame->width, frame->height, (AVPixelFormat)frame->format,
+            width, height, AV_PIX_FMT_RGBA,
+            SWS_BILINEAR, nullptr, nullptr, nullptr
+        );
+        if (sws) {
+            out->resize(static_cast<size_t>(width) * height * 4);
+            uint8_t* dest[4] = { out->data(), nullptr, nullptr, nullptr };
+            int destLinesize[4] = { width * 4, 0, 0, 0 };
+            sws_scale(sws, frame->data, frame->linesize, 0, frame->height, dest, destLinesize);
+        } else {
+            decoded = false;
+        }
+    }
+
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+    avcodec_free_context(&codec);
+    avformat_close_input(&format);
+    return decoded;
+}
+
+ImageSequence::ImageSequence()
+    : _width(0)
+    , _height(0)
+    , _fps(DEFAULT_FRAME_RATE)
+    , _workerCount(0)
+    , _budget(0)
+    , _cursor(0)
+    , _stopping(false)
+{
+}
+
+ImageSequence::~ImageSequence() {
+    Close();
+}
+
+bool ImageSequence::IsSequencePath(const std::string& path) {
+    std::error_code error;
+    std::filesystem::path input(path);
+    if (std::filesystem::is_directory(input, error)) return true;
+
+    std::string name = input.filename().string();
+    std::string prefix;
+    std::string suffix;
+    long long number = 0;
+    return SplitPattern(name, prefix, suffix) || (IsImageFile(input) && SplitFrameNumber(name, prefix, suffix, number));
+}
+
+void ImageSequence::SetFrameRate(double fps) {
+    if (fps > 0.0) g_sequenceFrameRate = fps;
+}
+
+double ImageSequence::GetFrameRate() {
+    return g_sequenceFrameRate;
+}
+
+bool ImageSequence::Open(const std::string& path) {
+    Close();
+
+    std::vector<std::string> files;
+    std::string pattern;
+    if (!ScanSequence(path, files, pattern) || static_cast<int>(files.size()) < MIN_FRAMES) return false;
+
+    SwsContext* sws = nullptr;
+    ImageInfo info;
+    if (!DecodeImage(files[0], 0, 0, sws, nullptr, &info)) {
+        TVK_LOG_ERROR("Image sequence: could not decode {}", files[0]);
+        return false;
+    }
+
+    _files.swap(files);
+    _pattern = pattern;
+    _codecName = info.codec;
+    _width = info.width;
+    _height = info.height;
+    _fps = GetFrameRate();
+    _cursor = 0;
+    ResizeSlots();
+
+    TVK_LOG_INFO("Image sequence: {} ({} frames, {}x{} {}, {} fps)", _pattern, _files.size(), _width, _height,
+                 _codecName, _fps);
+    return true;
+}
+
+void ImageSequence::Close() {
+    StopWorkers();
+    _files.clear();
+    _slots.clear();
+    _pattern.clear();
+    _codecName.clear();
+    _width = 0;
+    _height = 0;
+    _cursor = 0;
+}
+
+void ImageSequence::SetBudget(size_t bytes) {
+    _budget = bytes;
+    if (IsOpen()) {
+        ResizeSlots();
+        _work.notify_all();
+    }
+}
+
+void ImageSequence::ResizeSlots() {
+    size_t frameBytes = std::max<size_t>(static_cast<size_t>(_width) * _height * 4, 1);
+    int capacity = static_cast<int>(std::min<size_t>(_budget / frameBytes, MAX_CACHED_FRAMES));
+    capacity = std::max(capacity, MIN_CACHED_FRAMES);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (static_cast<int>(_slots.size()) == capacity) return;
+    _slots.clear();
+    _slots.resize(capacity);
+}
+
+void ImageSequence::StartWorkers() {
+    if (!_workers.empty() || !IsOpen()) return;
+
+    int count = _workerCount > 0 ? _workerCount : static_cast<int>(std::thread::hardware_concurrency());
+    count = std::max(count, 1);
+    _stopping = false;
+    for (int i = 0; i < count; i++) {
+        _workers.emplace_back(&ImageSequence::WorkerLoop, this);
+    }
+    TVK_LOG_INFO("Image sequence: {} decode workers, {} frames prefetched", count, _slots.size());
+}
+
+void ImageSequence::StopWorkers() {
+    if (_workers.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _work.notify_all();
+    _ready.notify_all();
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+    _workers.clear();
+}
+
+int ImageSequence::PickFrame() {
+    int capacity = static_cast<int>(_slots.size());
+    int end = std::min(_cursor + capacity, GetFrameCount());
+    for (int frame = _cursor; frame < end; frame++) {
+        const Slot& slot = _slots[frame % capacity];
+        if (slot.frame == frame && slot.state != SlotState::Empty) continue;
+        if (slot.state == SlotState::Pending) continue;
+        return frame;
+    }
+    return -1;
+}
+
+void ImageSequence::WorkerLoop() {
+    ThreadStats::RegisterCurrentThread(ThreadRole::FFmpeg);
+
+    SwsContext* sws = nullptr;
+    std::vector<uint8_t> pixels;
+    std::string path;
+
+    while (true) {
+        int frame = -1;
+        int slot = 0;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _work.wait(lock, [this, &frame]() { return _stopping || (frame = PickFrame()) >= 0; });
+            if (_stopping) break;
+
+            slot = frame % static_cast<int>(_slots.size());
+            _slots[slot].frame = frame;
+            _slots[slot].state = SlotState::Pending;
+            pixels.swap(_slots[slot].data);
+            path = _files[frame];
+        }
+
+        bool decoded = DecodeImage(path, _width, _height, sws, &pixels, nullptr);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (slot < static_cast<int>(_slots.size()) && _slots[slot].frame == frame &&
+                _slots[slot].state == SlotState::Pending) {
+                _slots[slot].state = decoded ? SlotState::Ready : SlotState::Failed;
+                _slots[slot].data.swap(pixels);
+            }
+        }
+        _ready.notify_all();
+    }
+
+    sws_freeContext(sws);
+}
+
+bool ImageSequence::IsReady() {
+    StartWorkers();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_cursor >= GetFrameCount()) return true;
+    const Slot& slot = _slots[_cursor % _slots.size()];
+    return slot.frame == _cursor && (slot.state == SlotState::Ready || slot.state == SlotState::Failed);
+}
+
+bool ImageSequence::Read(VideoFrame& outFrame) {
+    StartWorkers();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_cursor < GetFrameCount()) {
+        _ready.wait(lock, [this]() {
+            const Slot& slot = _slots[_cursor % _slots.size()];
+            return _stopping || (slot.frame == _cursor &&
+                                 (slot.state == SlotState::Ready || slot.state == SlotState::Failed));
+        });
+        if (_stopping) return false;
+
+        Slot& slot = _slots[_cursor % _slots.size()];
+        int frame = _cursor++;
+        bool failed = slot.state == SlotState::Failed;
+        if (!failed) {
+            outFrame.data.swap(slot.data);
+            outFrame.width = _width;
+            outFrame.height = _height;
+            outFrame.timestamp = frame / _fps;
+            outFrame.grain.present = false;
+        }
+        slot.frame = -1;
+        slot.state = SlotState::Empty;
+        _work.notify_all();
+
+        if (!failed) return true;
+        TVK_LOG_ERROR("Image sequence: could not decode {}", _files[frame]);
+    }
+    return false;
+}
+
+void ImageSequence::Seek(int frame) {
+    if (!IsOpen()) return;
+    StartWorkers();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cursor = std::clamp(frame, 0, GetFrameCount() - 1);
+    }
+    _work.notify_all();
+}
+
+bool ImageSequence::DecodeThumbnail(int frame, VideoFrame& outFrame, int maxWidth, int maxHeight) {
+    if (!IsOpen() || _width <= 0 || _height <= 0) return false;
+
+    float aspect = (float)_width / (float)_height;
+    int thumbW = maxWidth;
+    int thumbH = (int)(maxWidth / aspect);
+    if (thumbH > maxHeight) {
+        thumbH = maxHeight;
+        thumbW = (int)(maxHeight * aspect);
+    }
+
+    int index = std::clamp(frame, 0, GetFrameCount() - 1);
+    SwsContext* sws = nullptr;
+    bool decoded = DecodeImage(_files[index], thumbW, thumbH, sws, &outFrame.data, nullptr);
+    sws_freeContext(sws);
+    if (!decoded) return false;
+
+    outFrame.width = thumbW;
+    outFrame.height = thumbH;
+    outFrame.timestamp = index / _fps;
+    return true;
+}
+
+int ImageSequence::GetReadyAhead() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    int ready = 0;
+    for (const Slot& slot : _slots) {
+        if (slot.state == SlotState::Ready && slot.frame >= _cursor) ready++;
+    }
+    return ready;
+}
+
+} // namespace tvk_media
@@ -0,0 +1,133 @@
+#include "latency_tracker.h"
+#include <tinyvk/core/log.h>
+#include <algorithm>
+
+namespace tvk_media {
+
+static constexpr int STAGE_COUNT = static_cast<int>(LatencyStage::Count);
+static constexpr int PRESENTED = static_cast<int>(LatencyStage::Presented);
+static constexpr int PROCESSED = static_cast<int>(LatencyStage::Processed);
+
+static void ClearSample(LatencySample& sample) {
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        sample.stages[i] = -1.0f;
+    }
+}
+
+LatencyTracker::LatencyTracker()
+    : _frameStart(std::chrono::steady_clock::now())
+    , _inputTime(_frameStart)
+    , _action(UserAction::Play)
+    , _pending(false)
+    , _frameBuilt(false)
+{
+    for (History& history : _history) {
+        history.next = 0;
+        history.count = 0;
+    }
+    ClearSample(_current);
+}
+
+const char* LatencyTracker::GetActionName(UserAction action) {
+    switch (action) {
+        case UserAction::Play: return "play";
+        case UserAction::Pause: return "pause";
+        case UserAction::Seek: return "seek";
+        default: return "unknown";
+    }
+}
+
+const char* LatencyTracker::GetStageName(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::Issued: return "issued";
+        case LatencyStage::Decoded: return "decoded";
+        case LatencyStage::Uploaded: return "uploaded";
+        case LatencyStage::Processed: return "effects";
+        case LatencyStage::Presented: return "presented";
+        default: return "unknown";
+    }
+}
+
+float LatencyTracker::Elapsed() const {
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - _inputTime).count();
+}
+
+void LatencyTracker::BeginFrame() {
+    _frameStart = std::chrono::steady_clock::now();
+}
+
+void LatencyTracker::Begin(UserAction action) {
+    _action = action;
+    _inputTime = _frameStart;
+    _pending = true;
+    _frameBuilt = false;
+    ClearSample(_current);
+}
+
+void LatencyTracker::Mark(LatencyStage stage) {
+    int index = static_cast<int>(stage);
+    if (!_pending || _current.stages[index] >= 0.0f) return;
+    _current.stages[index] = Elapsed();
+}
+
+void LatencyTracker::MarkFrameBuilt() {
+    if (!_pending || _frameBuilt) return;
+    if (_action != UserAction::Pause && _current.stages[PROCESSED] < 0.0f) return;
+    _frameBuilt = true;
+}
+
+void LatencyTracker::MarkPresented() {
+    if (!_pending || !_frameBuilt) return;
+
+    _current.stages[PRESENTED] = Elapsed();
+    _pending = false;
+
+    History& history = _history[static_cast<int>(_action)];
+    history.samples[history.next] = _current;
+    history.next = (history.next + 1) % HISTORY;
+    if (history.count < HISTORY) history.count++;
+
+    TVK_LOG_INFO("Latency {}: {:.1f} ms to present", GetActionName(_action), _current.stages[PRESENTED]);
+}
+
+const LatencySample& LatencyTracker::GetLast(UserAction action) const {
+    const History& history = _history[static_cast<int>(action)];
+    return history.samples[(history.next + HISTORY - 1) % HISTORY];
+}
+
+LatencySummary LatencyTracker::GetSummary(UserAction action) const {
+    LatencySummary summary;
+    const History& history = _history[static_cast<int>(action)];
+    if (history.count == 0) return summary;
+
+    float totals[HISTORY];
+    for (int i = 0; i < history.count; i++) {
+        totals[i] = history.samples[i].stages[PRESENTED];
+    }
+    std::sort(totals, totals + history.count);
+
+    summary.count = history.count;
+    summary.p50 = totals[(history.count - 1) / 2];
+    summary.p95 = totals[(history.count - 1) * 95 / 100];
+    summary.max = totals[history.count - 1];
+    return summary;
+}
+
+void LatencyTracker::LogSummary() const {
+    for (int i = 0; i < static_cast<int>(UserAction::Count); i++) {
+        UserAction action = static_cast<UserAction>(i);
+        LatencySummary summary = GetSummary(action);
+        if (summary.count == 0) continue;
+
+        TVK_LOG_INFO("Latency {}: {} samples, p50 {:.1f} ms, p95 {:.1f} ms, max {:.1f} ms",
+                     GetActionName(action), summary.count, summary.p50, summary.p95, summary.max);
+
+        const LatencySample& last = GetLast(action);
+        for (int s = 0; s < STAGE_COUNT; s++) {
+            if (last.stages[s] < 0.0f) continue;
+            TVK_LOG_INFO("  last {}: {:.1f} ms", GetStageName(static_cast<LatencyStage>(s)), last.stages[s]);
+        }
+    }
+}
+
+} // namespace tvk_media
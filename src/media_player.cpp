@@ -8,25 +8,46 @@
 #include <imgui_internal.h>
 #include <tinyvk/assets/icons_font_awesome.h>
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <filesystem>
 
 namespace tvk_media {
 
+static constexpr int ALLOC_WARMUP_FRAMES = 30;
+static constexpr double SEEK_STEP = 5.0;
+static constexpr double DISPLAY_RATE_CHECK_INTERVAL = 1.0;
+static const double SEQUENCE_FRAME_RATES[] = { 23.976, 24.0, 25.0, 29.97, 30.0, 48.0, 50.0, 60.0 };
+
 MediaPlayer::MediaPlayer()
     : _decoder(nullptr)
     , _thumbnailDecoder(nullptr)
+    , _thumbnailReady(false)
+    , _decoderEof(false)
     , _videoTexture(nullptr)
     , _thumbnailTexture(nullptr)
     , _lastThumbnailTime(-1.0)
     , _showThumbnail(false)
+    , _timelineAtlas(nullptr)
+    , _showTimelineWindow(false)
+    , _timelineOpenPending(false)
+    , _timelineStart(0.0)
+    , _timelineSpan(1.0)
+    , _timelineDragged(false)
     , _isPlaying(false)
     , _hasVideo(false)
     , _videoStartTime(0.0)
     , _pausedAtTime(0.0)
+    , _refineTarget(-1.0)
+    , _refineStart(0.0)
+    , _refineMs(0.0f)
     , _volume(1.0f)
     , _showControls(true)
     , _seekBarValue(0.0f)
     , _isSeeking(false)
+    , _scrubbing(false)
+    , _scrubTarget(-1.0)
     , _isDragging(false)
     , _isResizing(false)
     , _resizeDir(0)
@@ -43,19 +64,62 @@ MediaPlayer::MediaPlayer()
     , _showFiltersWindow(false)
     , _showPostProcessWindow(false)
     , _showEffectsWindow(false)
+    , _showCopyBenchmarkWindow(false)
+    , _showSyncBenchmarkWindow(false)
+    , _showSeekStressWindow(false)
+    , _showSoakTestWindow(false)
+    , _showStats(false)
+    , _allocWarmupFrames(0)
+    , _framePoolSlots(-1)
+    , _cacheBudgetPending(false)
+    , _decoderRestartPending(false)
+    , _allocViolations(0)
+    , _coldStart("Time to window", StartupProfiler::COLD_START_BUDGET)
+    , _firstFrame("Time to first frame", StartupProfiler::FIRST_FRAME_BUDGET)
+    , _lastLoopTime(0.0)
+    , _frameLateMs(0.0f)
+    , _framePresented(false)
+    , _seekedThisFrame(false)
+    , _lastUnderruns(0)
+    , _nextDisplayRateCheck(0.0)
+    , _stabilizerActive(false)
+    , _videoFrameDirty(false)
 {
+    _coldStart.Start();
 }
 
 void MediaPlayer::OnStart() {
+    _coldStart.Mark("Window and Vulkan");
     TVK_LOG_INFO("Media Player started");
+    _threadPlacement.Init();
+    _threadPlacement.Apply(ThreadClass::Decode);
+    _resourceLimits.Detect();
+    _memoryPressure.Init(_resourceLimits.GetCgroupDirectory());
+    _powerProfile.Init();
+    _flightRecorder.Init();
+    _coldStart.Mark("System probes");
+    
     _decoder = std::make_unique<VideoDecoder>();
-    _thumbnailDecoder = std::make_unique<VideoDecoder>();
+    _decodeWorker.Init(_decoder.get(), &_threadPlacement);
     _audioDecoder = std::make_unique<AudioDecoder>();
     _videoEffects = std::make_unique<VideoEffects>();
     _videoEffects->Init(GetRenderer());
+    _stabilizer = std::make_unique<VideoStabilizer>();
+    _upscaler = std::make_unique<VideoUpscaler>();
+    _upscaler->Init(GetRenderer());
+    _uploader = std::make_unique<FrameUploader>();
+    _uploader->Init(GetRenderer());
+    ApplyPowerProfile();
+    _coldStart.Mark("Player subsystems");
 }
 
 void MediaPlayer::OnUpdate() {
+    _coldStart.MarkPresented();
+    _firstFrame.MarkPresented();
+    _latency.MarkPresented();
+    WaitForNextFrame();
+    _latency.BeginFrame();
+    
     // Handle keyboard shortcuts
     if (tvk::Input::IsKeyPressed(tvk::Key::Escape)) {
         Quit();
@@ -69,19 +133,81 @@ void MediaPlayer::OnUpdate() {
         (tvk::Input::IsKeyDown(tvk::Key::LeftControl) || tvk::Input::IsKeyDown(tvk::Key::RightControl))) {
         OpenFile();
     }
+    
+    if (_hasVideo) {
+        double position = _isPlaying ? ElapsedTime() - _videoStartTime : _pausedAtTime;
+        if (tvk::Input::IsKeyPressed(tvk::Key::Right)) {
+            SeekTo(position + SEEK_STEP);
+        } else if (tvk::Input::IsKeyPressed(tvk::Key::Left)) {
+            SeekTo(std::max(0.0, position - SEEK_STEP));
+        } else if (tvk::Input::IsKeyPressed(tvk::Key::Period) && !_isPlaying && _decoder->GetFPS() > 0.0) {
+            SeekTo(_currentFrame.timestamp + 1.0 / _decoder->GetFPS());
+        }
+    }
 
+    // Refine a keyframe preview to the exact seek target
+    if (_refineTarget >= 0.0) {
+        RefineSeek();
+    }
+    
+    if (_scrubbing) {
+        UpdateScrub();
+    }
+    
+    UpdateDisplaySync();
+    
     // Update video playback
-    if (_isPlaying && _hasVideo) {
+    if (_isPlaying && _hasVideo && _refineTarget < 0.0 && !_scrubbing) {
         UpdateVideo();
     }
     
     // Update audio
     if (_audioDecoder && _audioDecoder->HasAudio()) {
+        ScopedAllocStage stage(AllocStage::Audio);
         _audioDecoder->Update();
+        if (_isPlaying && _hasVideo && _refineTarget < 0.0 && !_scrubbing) {
+            _audioDecoder->SyncToClock(ElapsedTime() - _videoStartTime);
+        }
+    }
+    
+    UpdateSyncBenchmark();
+    UpdateSeekStress();
+    UpdateSoakTest();
+    
+    if (_memoryPressure.Update(ElapsedTime())) {
+        ApplyMemoryPressure();
+    }
+    
+    // The decode worker owns the packet cache while busy, so a new budget waits for it instead of blocking
+    if (_cacheBudgetPending && !_decodeWorker.IsBusy()) {
+        _cacheBudgetPending = false;
+        _decoder->SetCacheBudget(_memoryPressure.ScaleBudget(_resourceLimits.GetCacheBudget()));
+    }
+    
+    if (_powerProfile.Update(ElapsedTime())) {
+        ApplyPowerProfile();
+    }
+    
+    // The pyramid is built only once the Timeline window is first shown for this file
+    if (_showTimelineWindow && _timelineOpenPending && _hasVideo) {
+        _timelineOpenPending = false;
+        _thumbnailPyramid.Open(_currentFilePath, _decoder->GetDuration(), &_threadPlacement);
+    }
+    
+    if (_showTimelineWindow && _thumbnailPyramid.Update()) {
+        UploadTimelineAtlas();
+    }
+    
+    if (_showStats) {
+        _threadStats.Update(ElapsedTime());
     }
+    
+    RecordFlightSample();
 }
 
 void MediaPlayer::OnUI() {
+    ScopedAllocStage stage(AllocStage::Interface);
+    
     DrawVideoView();
     DrawMenuBar();
     DrawControls();
@@ -99,11 +225,40 @@ void MediaPlayer::OnUI() {
     if (_showEffectsWindow) {
         DrawEffectsWindow();
     }
+    if (_showCopyBenchmarkWindow) {
+        DrawCopyBenchmarkWindow();
+    }
+    if (_showSyncBenchmarkWindow) {
+        DrawSyncBenchmarkWindow();
+    }
+    if (_showSeekStressWindow) {
+        DrawSeekStressWindow();
+    }
+    if (_showSoakTestWindow) {
+        DrawSoakTestWindow();
+    }
+    if (_showTimelineWindow) {
+        DrawTimelineWindow();
+    }
+    if (_showStats) {
+        DrawStatsOverlay();
+    }
     
+    _coldStart.MarkFrameBuilt("First UI frame");
 }
 
 void MediaPlayer::OnStop() {
     TVK_LOG_INFO("Media Player stopped");
+    _latency.LogSummary();
+    _flightRecorder.Cleanup();
+    
+    if (_upscaler) {
+        _upscaler->Cleanup();
+    }
+    
+    if (_uploader) {
+        _uploader->Cleanup();
+    }
     
     if (_videoEffects) {
         _videoEffects->Cleanup();
@@ -117,14 +272,30 @@ void MediaPlayer::OnStop() {
         _thumbnailTexture.reset();
     }
     
+    if (_timelineAtlas) {
+        _timelineAtlas.reset();
+    }
+    
+    _decodeWorker.Stop();
+    
     if (_decoder) {
         _decoder->Close();
     }
     
+    if (_thumbnailOpen.valid()) {
+        _thumbnailOpen.wait();
+    }
+    
+    if (_memoryRelease.valid()) {
+        _memoryRelease.wait();
+    }
+    
     if (_thumbnailDecoder) {
         _thumbnailDecoder->Close();
     }
     
+    _thumbnailPyramid.Close();
+    
     if (_audioDecoder) {
         _audioDecoder->Close();
     }
@@ -175,13 +346,7 @@ void MediaPlayer::DrawMenuBar() {
                     for (size_t i = 0; i < names.size(); ++i) {
                         bool selected = (indices[i] == selected_stream);
                         if (ImGui::MenuItem(names[i].c_str(), nullptr, selected)) {
-                            int stream_index = indices[i];
-                            double video_time = _decoder ? _decoder->GetCurrentTime() : 0.0;
-                            if (_audioDecoder->SelectAudioStream(stream_index, video_time)) {
-                                TVK_LOG_INFO("Switched to audio stream {}", stream_index);
-                            } else {
-                                TVK_LOG_ERROR("Failed to switch audio stream {}", stream_index);
-                            }
+                            SelectAudioTrack(indices[i]);
                         }
                     }
                 } else {
@@ -194,6 +359,13 @@ void MediaPlayer::DrawMenuBar() {
 
         if (ImGui::BeginMenu("Video")) {
             ImGui::MenuItem("Effects", nullptr, &_showEffectsWindow);
+            ImGui::MenuItem("Timeline", nullptr, &_showTimelineWindow);
+            ImGui::MenuItem("Statistics", nullptr, &_showStats);
+            DrawSequenceFrameRateMenu();
+            bool displaySync = _displaySync.IsEnabled();
+            if (ImGui::MenuItem("Display Sync", nullptr, &displaySync)) {
+                _displaySync.SetEnabled(displaySync);
+            }
             ImGui::Separator();
             if (ImGui::MenuItem("Reset All Effects")) {
                 _videoEffects->ResetAll();
@@ -201,6 +373,30 @@ void MediaPlayer::DrawMenuBar() {
             ImGui::EndMenu();
         }
         
+        if (ImGui::BeginMenu("Tools")) {
+            if (ImGui::MenuItem("Benchmark Frame Copy")) {
+                uint32_t width = _videoTexture ? _videoTexture->GetWidth() : 3840;
+                uint32_t height = _videoTexture ? _videoTexture->GetHeight() : 2160;
+                RunCopyBenchmark(&GetRenderer()->GetContext(), width, height, _copyBenchmark);
+                _showCopyBenchmarkWindow = true;
+            }
+            ImGui::Separator();
+            if (ImGui::MenuItem("Benchmark A/V Sync", nullptr, false, !_syncBenchmark.IsRunning())) {
+                StartSyncBenchmark();
+            }
+            if (ImGui::MenuItem("Seek Stress Test...", nullptr, false, !_seekStress.IsRunning())) {
+                StartSeekStress();
+            }
+            if (ImGui::MenuItem("Soak Test", nullptr, false, _hasVideo && !_soakTest.IsRunning())) {
+                StartSoakTest();
+            }
+            ImGui::Separator();
+            DrawThreadPlacementMenu();
+            DrawPowerProfileMenu();
+            DrawFlightRecorderMenu();
+            ImGui::EndMenu();
+        }
+        
         if (ImGui::BeginMenu("Help")) {
             if (ImGui::MenuItem("About")) {
                 TVK_LOG_INFO("TVK Media Player v1.0.0");
@@ -272,8 +468,23 @@ void MediaPlayer::DrawVideoView() {
             imagePos.y = (windowSize.y - imageSize.y) * 0.5f;
         }
         
+        ImVec2 fbScale = ImGui::GetIO().DisplayFramebufferScale;
+        uint32_t outputWidth = _powerProfile.ScaleUpscaleSize(static_cast<uint32_t>(imageSize.x * fbScale.x));
+        uint32_t outputHeight = _powerProfile.ScaleUpscaleSize(static_cast<uint32_t>(imageSize.y * fbScale.y));
+        
+        auto textureId = _videoTexture->GetImGuiTextureID();
+        {
+            ScopedAllocStage stage(AllocStage::Effects);
+            if (_upscaler->Process(_videoTexture.get(), outputWidth, outputHeight, _videoFrameDirty)) {
+                textureId = _upscaler->GetOutput()->GetImGuiTextureID();
+            }
+        }
+        _videoFrameDirty = false;
+        
         ImGui::SetCursorPos(imagePos);
-        ImGui::Image(_videoTexture->GetImGuiTextureID(), imageSize);
+        ImGui::Image(textureId, imageSize);
+        _firstFrame.MarkFrameBuilt("Build UI frame");
+        _latency.MarkFrameBuilt();
     } else {
         ImVec2 textSize = ImGui::CalcTextSize(ICON_FA_VIDEO " No video loaded");
         ImGui::SetCursorPos(ImVec2(
@@ -440,29 +651,7 @@ void MediaPlayer::DrawControls() {
         if (_hasVideo && (hover || _isSeeking)) {
             double previewTime = _isSeeking ? (_seekBarValue * duration) : (hoverValue * duration);
             
-            if (fabs(previewTime - _lastThumbnailTime) > 0.5 || _lastThumbnailTime < 0) {
-                if (_thumbnailDecoder->GetThumbnailAt(previewTime, _thumbnailFrame, 160, 90)) {
-                    _lastThumbnailTime = previewTime;
-                    _showThumbnail = true;
-                    
-                    tvk::TextureSpec spec;
-                    spec.width = _thumbnailFrame.width;
-                    spec.height = _thumbnailFrame.height;
-                    spec.format = tvk::TextureFormat::RGBA8;
-                    
-                    _thumbnailTexture = tvk::Texture::Create(
-                        GetRenderer(),
-                        _thumbnailFrame.data.data(),
-                        _thumbnailFrame.width,
-                        _thumbnailFrame.height,
-                        spec
-                    );
-                    
-                    if (_thumbnailTexture) {
-                        _thumbnailTexture->BindToImGui();
-                    }
-                }
-            }
+            RequestThumbnail(previewTime);
             
             if (_showThumbnail && _thumbnailTexture) {
                 ImDrawList* fgDl = ImGui::GetForegroundDrawList();
@@ -510,9 +699,11 @@ void MediaPlayer::DrawControls() {
             if (_seekBarValue < 0) _seekBarValue = 0;
             if (_seekBarValue > 1) _seekBarValue = 1;
             _isSeeking = true;
+            ScrubTo(_seekBarValue * duration);
         }
         
         if (_hasVideo && _isSeeking && !active) {
+            EndScrub();
             SeekTo(_seekBarValue * duration);
             _isSeeking = false;
             _lastThumbnailTime = -1.0;
@@ -571,64 +762,118 @@ void MediaPlayer::DrawTimeline() {
 }
 
 void MediaPlayer::OpenFile() {
-    auto filepath = tvk::FileDialog::OpenFile({{"Video Files", "mp4,avi,mkv,mov,wmv,flv,webm"}});
+    auto filepath = tvk::FileDialog::OpenFile({{"Video Files", "mp4,avi,mkv,mov,wmv,flv,webm"},
+                                                {"Image Sequences", "dpx,exr,png,tif,tiff,jpg,jpeg"}});
     
     if (filepath.has_value()) {
-        if (_videoTexture) {
-            _videoTexture.reset();
-        }
-        if (_thumbnailTexture) {
-            _thumbnailTexture.reset();
+        _syncBenchmark.Cancel();
+        _seekStress.Cancel();
+        _soakTest.Cancel();
+        _audioDecoder->SetCaptureSink(nullptr);
+        OpenMedia(filepath.value());
+    }
+}
+
+bool MediaPlayer::OpenMedia(const std::string& filepath) {
+    _firstFrame.Start();
+    _decodeWorker.Cancel();
+    
+    if (_videoTexture) {
+        _videoTexture.reset();
+    }
+    if (_thumbnailTexture) {
+        _thumbnailTexture.reset();
+    }
+    
+    _decoder->SetThreadCount(GetDecoderThreads());
+    _decoderRestartPending = false;
+    _decoder->SetCacheBudget(_memoryPressure.ScaleBudget(_resourceLimits.GetCacheBudget()));
+    _cacheBudgetPending = false;
+    _decoder->SetRawPassthrough(false);
+    _decoder->SetDirectConversion(false);
+    
+    if (_decoder->Open(filepath)) {
+        _firstFrame.Mark("Open video decoder");
+        StartThumbnailDecoder(filepath);
+        _thumbnailPyramid.Close();
+        _timelineOpenPending = true;
+        {
+            ScopedThreadPlacement placement(_threadPlacement, ThreadClass::Audio, ThreadClass::Decode);
+            _audioDecoder->Open(filepath);
         }
+        _firstFrame.Mark("Open audio");
         
-        if (_decoder->Open(filepath.value())) {
-            _thumbnailDecoder->Open(filepath.value());
-            _audioDecoder->Open(filepath.value());
+        _currentFilePath = filepath;
+        _hasVideo = true;
+        _isPlaying = false;
+        _pausedAtTime = 0.0;
+        _refineTarget = -1.0;
+        _scrubbing = false;
+        _scrubTarget = -1.0;
+        _timelineStart = 0.0;
+        _timelineSpan = _decoder->GetDuration();
+        _seekBarValue = 0.0f;
+        _lastThumbnailTime = -1.0;
+        _showThumbnail = false;
+        _displaySync.ResetCounters();
+        ResetFrameQueue();
+        _framePoolSlots = -1;
+        _currentFrame.data.reserve(static_cast<size_t>(_decoder->GetWidth()) * _decoder->GetHeight() * 4);
+        _firstFrame.Mark("Frame pool");
+        
+        if (_decoder->DecodeNextFrame(_currentFrame)) {
+            if (_stabilizerActive) {
+                _stabilizer->Analyze(_currentFrame);
+            }
+            _firstFrame.Mark("Decode first frame");
             
-            _currentFilePath = filepath.value();
-            _hasVideo = true;
-            _isPlaying = false;
-            _pausedAtTime = 0.0;
-            _seekBarValue = 0.0f;
-            _lastThumbnailTime = -1.0;
-            _showThumbnail = false;
+            tvk::TextureSpec spec;
+            spec.width = _currentFrame.width;
+            spec.height = _currentFrame.height;
+            spec.format = tvk::TextureFormat::RGBA8;
+            spec.generateMipmaps = false;
+            spec.storageUsage = true;
             
-            if (_decoder->DecodeNextFrame(_currentFrame)) {
-                tvk::TextureSpec spec;
-                spec.width = _currentFrame.width;
-                spec.height = _currentFrame.height;
-                spec.format = tvk::TextureFormat::RGBA8;
-                spec.generateMipmaps = false;
-                spec.storageUsage = true;
-                
-                _videoTexture = tvk::Texture::Create(
-                    GetRenderer(),
-                    _currentFrame.data.data(),
-                    _currentFrame.width,
-                    _currentFrame.height,
-                    spec
-                );
-                
-                if (_videoTexture) {
-                    _videoTexture->BindToImGui();
-                }
-            }
+            _videoTexture = tvk::Texture::Create(
+                GetRenderer(),
+                _currentFrame.data.data(),
+                _currentFrame.width,
+                _currentFrame.height,
+                spec
+            );
             
-            TVK_LOG_INFO("Opened video file: {}", filepath.value());
+            if (_videoTexture) {
+                CountTextureCreated();
+                _videoTexture->BindToImGui();
+                ProcessCurrentFrame();
+                _firstFrame.Mark("Texture and effects");
+            } else {
+                _firstFrame.Cancel();
+            }
         } else {
-            TVK_LOG_ERROR("Failed to open video file: {}", filepath.value());
+            _firstFrame.Cancel();
         }
+        
+        TVK_LOG_INFO("Opened video file: {}", filepath);
+        return true;
     }
+    
+    _firstFrame.Cancel();
+    TVK_LOG_ERROR("Failed to open video file: {}", filepath);
+    return false;
 }
 
 void MediaPlayer::TogglePlayPause() {
     if (!_hasVideo) return;
     
     _isPlaying = !_isPlaying;
+    _latency.Begin(_isPlaying ? UserAction::Play : UserAction::Pause);
     
     if (_isPlaying) {
+        _allocWarmupFrames = ALLOC_WARMUP_FRAMES;
         _videoStartTime = ElapsedTime() - _pausedAtTime;
-        if (_audioDecoder->HasAudio()) {
+        _displaySync.Restart(ElapsedTime(), _currentFrame.timestamp);
+        if (_audioDecoder->HasAudio() && _refineTarget < 0.0) {
             _audioDecoder->Play();
         }
         TVK_LOG_INFO("Playback started");
@@ -639,28 +884,43 @@ void MediaPlayer::TogglePlayPause() {
         }
         TVK_LOG_INFO("Playback paused at {}s", _pausedAtTime);
     }
+    _latency.Mark(LatencyStage::Issued);
 }
 
 void MediaPlayer::UpdateVideo() {
     if (!_decoder || !_hasVideo) return;
     
-    double currentPlaybackTime = ElapsedTime() - _videoStartTime;
+    FillFrameQueue();
+    
+    double now = ElapsedTime();
+    double currentPlaybackTime = now - _videoStartTime;
     double frameDuration = 1.0 / _decoder->GetFPS();
+    bool due = currentPlaybackTime >= _currentFrame.timestamp + frameDuration;
     
-    if (currentPlaybackTime >= _currentFrame.timestamp + frameDuration) {
-        if (_decoder->DecodeNextFrame(_currentFrame)) {
-            if (_videoTexture) {
-                _videoTexture->SetData(
-                    _currentFrame.data.data(),
-                    _currentFrame.width,
-                    _currentFrame.height
-                );
-                
-                if (_videoEffects && _videoEffects->HasActiveEffects()) {
-                    _videoEffects->ProcessFrame(_videoTexture.get());
-                }
+    // Hold each frame for a whole number of refreshes; the clock follows the presented frame
+    int dropped = 0;
+    if (_displaySync.IsActive()) {
+        if (_currentFrame.timestamp != _displaySync.GetLastTimestamp()) {
+            _displaySync.Restart(now, _currentFrame.timestamp);
+        }
+        int frames = _displaySync.GetDueFrames(now);
+        due = frames > 0;
+        while (frames-- > 1 && _frameQueue.GetSize() > 1) {
+            _frameQueue.PopInto(_currentFrame);
+            dropped++;
+        }
+    }
+    
+    if (due) {
+        if (!_frameQueue.IsEmpty()) {
+            PresentNextFrame();
+            _frameLateMs = static_cast<float>((currentPlaybackTime - _currentFrame.timestamp) * 1000.0);
+            _framePresented = true;
+            if (_displaySync.IsActive()) {
+                _displaySync.OnPresented(now, _currentFrame.timestamp, dropped);
+                _videoStartTime = now - _currentFrame.timestamp;
             }
-        } else {
+        } else if (_decoderEof) {
             _isPlaying = false;
             _pausedAtTime = _decoder->GetDuration();
             if (_audioDecoder->HasAudio()) {
@@ -671,24 +931,436 @@ void MediaPlayer::UpdateVideo() {
     }
 }
 
-void MediaPlayer::SeekTo(double timeSeconds) {
-    if (!_decoder || !_hasVideo) return;
+void MediaPlayer::FillFrameQueue() {
+    ScopedAllocStage allocStage(AllocStage::Decode);
+    
+    const StabilizationSettings& stab = _videoEffects->GetStabilization();
+    if (stab.enabled != _stabilizerActive) {
+        _stabilizerActive = stab.enabled;
+        _stabilizer->Reset();
+    }
+    _decoder->SetRawPassthrough(!_stabilizerActive && !_syncBenchmark.IsRunning() && _uploader->SupportsRaw());
+    _decoder->SetDirectConversion(!_stabilizerActive && !_syncBenchmark.IsRunning());
+    
+    int radius = stab.smoothingRadius;
+    if (radius > VideoStabilizer::MAX_RADIUS) radius = VideoStabilizer::MAX_RADIUS;
+    size_t frameBytes = static_cast<size_t>(_decoder->GetWidth()) * _decoder->GetHeight() * 4;
+    int required = _stabilizerActive ? 1 + radius : 1;
+    int capacity = _memoryPressure.ScaleCapacity(_resourceLimits.GetFrameQueueCapacity(required, frameBytes));
+    // The stabilizer needs its whole lookahead queued, so memory limits stop short of it
+    _frameQueue.SetCapacity(std::max(capacity, required));
+    PrepareFramePool();
+    
+    while (!_decoderEof && !_frameQueue.IsFull() && _decoder->HasFrameReady()) {
+        VideoFrame& slot = _frameQueue.Back();
+        if (!_decoder->DecodeNextFrame(slot)) {
+            _decoderEof = true;
+            break;
+        }
+        if (_stabilizerActive) {
+            _stabilizer->Analyze(slot);
+        }
+        _frameQueue.Push();
+    }
+}
+
+void MediaPlayer::PresentNextFrame() {
+    _frameQueue.PopInto(_currentFrame);
+    _latency.Mark(LatencyStage::Decoded);
+    if (!_videoTexture) return;
+    
+    UploadCurrentFrame();
+    
+    if (_stabilizerActive) {
+        _videoEffects->SetStabilizationTransform(
+            _stabilizer->Resolve(_currentFrame.timestamp, _videoEffects->GetStabilization()));
+    }
+    
+    ProcessCurrentFrame();
+    CheckFrameAllocations();
+    _syncBenchmark.OnFramePresented(ElapsedTime(), _currentFrame);
+}
+
+void MediaPlayer::UploadCurrentFrame() {
+    ScopedAllocStage stage(AllocStage::Upload);
+    
+    uint32_t width = static_cast<uint32_t>(_currentFrame.width);
+    uint32_t height = static_cast<uint32_t>(_currentFrame.height);
+    
+    if (_currentFrame.raw.data) {
+        if (!_uploader->UploadRaw(_videoTexture.get(), _currentFrame.raw, width, height)) {
+            TVK_LOG_ERROR("Raw frame upload failed; converting raw video on the CPU");
+            _decoder->SetRawPassthrough(false);
+        }
+        _latency.Mark(LatencyStage::Uploaded);
+        return;
+    }
     
+    if (_currentFrame.source) {
+        size_t pitch = 0;
+        uint8_t* staging = _uploader->MapUpload(_videoTexture.get(), width, height, pitch);
+        if (!staging || !_decoder->ConvertFrame(_currentFrame, staging, pitch) ||
+            !_uploader->SubmitUpload(_videoTexture.get(), width, height, pitch)) {
+            TVK_LOG_ERROR("Direct frame conversion failed; converting video on the CPU");
+            _decoder->SetDirectConversion(false);
+        }
+        _latency.Mark(LatencyStage::Uploaded);
+        return;
+    }
+    
+    if (!_uploader->Upload(_videoTexture.get(), _currentFrame.data.data(), width, height,
+                           static_cast<size_t>(width) * 4)) {
+        _videoTexture->SetData(_currentFrame.data.data(), width, height);
+    }
+    _latency.Mark(LatencyStage::Uploaded);
+}
+
+void MediaPlayer::ProcessCurrentFrame() {
+    if (!_videoTexture) return;
+    
+    ScopedAllocStage stage(AllocStage::Effects);
+    _videoEffects->SetFilmGrain(_currentFrame.grain, _currentFrame.width, _currentFrame.height);
+    _videoEffects->ProcessFrame(_videoTexture.get());
+    _videoFrameDirty = true;
+    _latency.Mark(LatencyStage::Processed);
+}
+
+void MediaPlayer::StartThumbnailDecoder(const std::string& filepath) {
+    if (_thumbnailOpen.valid()) {
+        _thumbnailOpen.wait();
+    }
+    if (!_thumbnailDecoder) {
+        _thumbnailDecoder = std::make_unique<VideoDecoder>();
+    }
+    
+    _thumbnailReady = false;
+    _thumbnailDecoder->SetThreadCount(1);
+    
+    VideoDecoder* decoder = _thumbnailDecoder.get();
+    const ThreadPlacement* placement = &_threadPlacement;
+    _thumbnailOpen = std::async(std::launch::async, [decoder, placement, filepath]() {
+        placement->Apply(ThreadClass::Background);
+        ThreadStats::RegisterCurrentThread(ThreadRole::Background);
+        return decoder->Open(filepath);
+    });
+}
+
+bool MediaPlayer::IsThumbnailDecoderReady() {
+    if (_thumbnailOpen.valid() &&
+        _thumbnailOpen.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        _thumbnailReady = _thumbnailOpen.get();
+    }
+    return _thumbnailReady && !_thumbnailOpen.valid();
+}
+
+void MediaPlayer::RequestThumbnail(double previewTime) {
+    if (!IsThumbnailDecoderReady()) return;
+    if (fabs(previewTime - _lastThumbnailTime) <= 0.5 && _lastThumbnailTime >= 0) return;
+    
+    ScopedAllocStage stage(AllocStage::Thumbnail);
+    if (_thumbnailDecoder->GetThumbnailAt(previewTime, _thumbnailFrame, 160, 90)) {
+        _lastThumbnailTime = previewTime;
+        _showThumbnail = true;
+        UploadThumbnail();
+    }
+}
+
+void MediaPlayer::UploadThumbnail() {
+    uint32_t width = static_cast<uint32_t>(_thumbnailFrame.width);
+    uint32_t height = static_cast<uint32_t>(_thumbnailFrame.height);
+    
+    if (_thumbnailTexture && _thumbnailTexture->GetWidth() == width && _thumbnailTexture->GetHeight() == height) {
+        if (!_uploader->Upload(_thumbnailTexture.get(), _thumbnailFrame.data.data(), width, height,
+                               static_cast<size_t>(width) * 4)) {
+            _thumbnailTexture->SetData(_thumbnailFrame.data.data(), width, height);
+        }
+        return;
+    }
+    
+    tvk::TextureSpec spec;
+    spec.width = _thumbnailFrame.width;
+    spec.height = _thumbnailFrame.height;
+    spec.format = tvk::TextureFormat::RGBA8;
+    
+    _thumbnailTexture = tvk::Texture::Create(
+        GetRenderer(),
+        _thumbnailFrame.data.data(),
+        _thumbnailFrame.width,
+        _thumbnailFrame.height,
+        spec
+    );
+    
+    if (_thumbnailTexture) {
+        CountTextureCreated();
+        _thumbnailTexture->BindToImGui();
+    }
+}
+
+void MediaPlayer::UploadTimelineAtlas() {
+    const std::vector<uint8_t>& atlas = _thumbnailPyramid.GetAtlas();
+    uint32_t size = static_cast<uint32_t>(ThumbnailPyramid::ATLAS_SIZE);
+    
+    if (_timelineAtlas) {
+        if (!_uploader->Upload(_timelineAtlas.get(), atlas.data(), size, size, static_cast<size_t>(size) * 4)) {
+            _timelineAtlas->SetData(atlas.data(), size, size);
+        }
+        return;
+    }
+    
+    tvk::TextureSpec spec;
+    spec.width = ThumbnailPyramid::ATLAS_SIZE;
+    spec.height = ThumbnailPyramid::ATLAS_SIZE;
+    spec.format = tvk::TextureFormat::RGBA8;
+    
+    _timelineAtlas = tvk::Texture::Create(
+        GetRenderer(),
+        atlas.data(),
+        ThumbnailPyramid::ATLAS_SIZE,
+        ThumbnailPyramid::ATLAS_SIZE,
+        spec
+    );
+    
+    if (_timelineAtlas) {
+        CountTextureCreated();
+        _timelineAtlas->BindToImGui();
+    }
+}
+
+void MediaPlayer::CheckFrameAllocations() {
+    if (!AllocTracker::ENABLED) return;
+    
+    AllocStats stats = AllocTracker::GetPlaybackStats();
+    uint64_t count = stats.count - _frameAllocs.count;
+    uint64_t bytes = stats.bytes - _frameAllocs.bytes;
+    _frameAllocs = stats;
+    
+    if (_allocWarmupFrames > 0) {
+        _allocWarmupFrames--;
+        return;
+    }
+    if (count == 0) return;
+    
+    _allocViolations++;
+    TVK_LOG_ERROR("Steady-state frame at {:.3f}s made {} heap allocation(s), {} bytes, in playback stages",
+                  _currentFrame.timestamp, count, bytes);
+}
+
+void MediaPlayer::ResetFrameQueue() {
+    _allocWarmupFrames = ALLOC_WARMUP_FRAMES;
+    _frameQueue.Clear();
+    _decoderEof = false;
+    _stabilizer->Reset();
+    _videoEffects->SetStabilizationTransform(StabilizationTransform());
+}
+
+void MediaPlayer::PrepareFramePool() {
+    // Direct conversion and raw passthrough never touch VideoFrame::data, so only the CPU path gets buffers
+    int slots = _decoder->WritesFrameData() ? _frameQueue.GetCapacity() : 0;
+    if (slots == _framePoolSlots) return;
+    if (slots < _framePoolSlots) _frameQueue.ReleaseUnused();
+    _framePoolSlots = slots;
+    _allocWarmupFrames = ALLOC_WARMUP_FRAMES;
+    if (slots == 0) return;
+    
+    size_t frameBytes = static_cast<size_t>(_decoder->GetWidth()) * _decoder->GetHeight() * 4;
+    for (int i = 0; i <= slots; i++) {
+        VideoFrame& frame = i < slots ? _frameQueue.GetSlot(i) : _currentFrame;
+        frame.data.reserve(frameBytes);
+        _threadPlacement.BindMemory(frame.data.data(), frame.data.capacity(), ThreadClass::Decode);
+    }
+}
+
+void MediaPlayer::ApplyMemoryPressure() {
+    int level = _memoryPressure.GetShrinkLevel();
+    _allocWarmupFrames = ALLOC_WARMUP_FRAMES;
+    _cacheBudgetPending = true;
+    // FillFrameQueue re-reserves the pool for whatever capacity the new level allows
+    _framePoolSlots = -1;
+    if (level == 0) return;
+    
+    _frameQueue.ReleaseUnused();
+    
+    if (level >= 2 && !_isSeeking) {
+        _thumbnailTexture.reset();
+        std::vector<uint8_t>().swap(_thumbnailFrame.data);
+        if (IsThumbnailDecoderReady()) {
+            _thumbnailDecoder->ReleaseCaches();
+        }
+        _showThumbnail = false;
+        _lastThumbnailTime = -1.0;
+    }
+    
+    // Returning freed pages to the OS can take tens of milliseconds, so keep it off the render thread
+    if (!_memoryRelease.valid() ||
+        _memoryRelease.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        const ThreadPlacement* placement = &_threadPlacement;
+        _memoryRelease = std::async(std::launch::async, [placement]() {
+            placement->Apply(ThreadClass::Background);
+            MemoryPressureMonitor::ReleaseFreeMemory();
+        });
+    }
+}
+
+void MediaPlayer::ApplyPowerProfile() {
+    _allocWarmupFrames = ALLOC_WARMUP_FRAMES;
+    _audioDecoder->SetBufferScale(_powerProfile.GetAudioBufferScale());
+    _videoEffects->SetStep(_powerProfile.GetEffectsStep());
+    _decoder->SetThreadCount(GetDecoderThreads());
+    // Restarting the codec drops its reference frames, so it waits for the next seek
+    _decoderRestartPending = _hasVideo;
+}
+
+int MediaPlayer::GetDecoderThreads() const {
+    return _powerProfile.CapDecoderThreads(_resourceLimits.GetDecoderThreads(
+        _threadPlacement.GetSet(ThreadClass::Decode).Count()));
+}
+
+void MediaPlayer::RecordFlightSample() {
+    double now = ElapsedTime();
+    
+    FlightSample sample;
+    sample.time = now;
+    sample.frameMs = static_cast<float>((now - _lastLoopTime) * 1000.0);
+    sample.queueDepth = static_cast<uint16_t>(_frameQueue.GetSize());
+    sample.queueCapacity = static_cast<uint16_t>(_frameQueue.GetCapacity());
+    _lastLoopTime = now;
+    
+    if (_framePresented) {
+        sample.flags |= FlightRecorder::FLAG_PRESENTED;
+        sample.lateMs = _frameLateMs;
+    }
+    if (_seekedThisFrame) {
+        sample.flags |= FlightRecorder::FLAG_SEEK;
+    }
+    if (_isPlaying) {
+        sample.flags |= FlightRecorder::FLAG_PLAYING;
+    }
+    
+    if (_audioDecoder && _audioDecoder->HasAudio()) {
+        uint64_t underruns = _audioDecoder->GetUnderrunCount();
+        if (underruns != _lastUnderruns) {
+            sample.flags |= FlightRecorder::FLAG_UNDERRUN;
+        }
+        _lastUnderruns = underruns;
+        sample.underruns = static_cast<uint32_t>(underruns);
+        
+        if (_isPlaying && _hasVideo) {
+            double videoClock = now - _videoStartTime;
+            sample.driftMs = static_cast<float>((_audioDecoder->GetPlaybackTime() - videoClock) * 1000.0);
+        }
+    }
+    
+    _flightRecorder.Record(sample);
+    _framePresented = false;
+    _seekedThisFrame = false;
+}
+
+void MediaPlayer::WaitForNextFrame() {
+    if (!_powerProfile.IsPowerSaving() || _latency.IsPending()) return;
+    if (_isSeeking || _isDragging || _isResizing || ImGui::IsAnyItemActive()) return;
+    
+    double timeout = PowerProfile::MAX_IDLE_WAIT;
+    if (_isPlaying && _hasVideo) {
+        double due = _displaySync.IsActive() ? _displaySync.GetNextDue()
+                                             : _videoStartTime + _currentFrame.timestamp + 1.0 / _decoder->GetFPS();
+        double wait = due - ElapsedTime();
+        if (wait < timeout) timeout = wait;
+    }
+    
+    if (timeout > 0.0) {
+        glfwWaitEventsTimeout(timeout);
+    }
+}
+
+void MediaPlayer::UpdateDisplaySync() {
+    double now = ElapsedTime();
+    if (now >= _nextDisplayRateCheck) {
+        _nextDisplayRateCheck = now + DISPLAY_RATE_CHECK_INTERVAL;
+        _displaySync.SetNominalRate(GetDisplayRefreshRate());
+    }
+    _displaySync.OnFrame(now);
+    _displaySync.Configure(_hasVideo ? _decoder->GetFPS() : 0.0);
+    
+    if (_audioDecoder && _audioDecoder->HasAudio()) {
+        _audioDecoder->SetSpeed(_displaySync.GetSpeed());
+    }
+}
+
+GLFWmonitor* MediaPlayer::FindWindowMonitor() {
+    tvk::Window* window = GetWindow();
+    if (!window) return glfwGetPrimaryMonitor();
+    
+    tvk::i32 win_x, win_y;
+    window->GetPosition(win_x, win_y);
+    tvk::Extent2D ext = window->GetExtent();
+    int cx = win_x + static_cast<int>(ext.width) / 2;
+    int cy = win_y + static_cast<int>(ext.height) / 2;
+    
+    int monitor_count = 0;
+    GLFWmonitor** monitors = glfwGetMonitors(&monitor_count);
+    for (int i = 0; i < monitor_count; ++i) {
+        const GLFWvidmode* mode = glfwGetVideoMode(monitors[i]);
+        int mx, my;
+        glfwGetMonitorPos(monitors[i], &mx, &my);
+        if (mode && cx >= mx && cx < mx + mode->width && cy >= my && cy < my + mode->height) {
+            return monitors[i];
+        }
+    }
+    return glfwGetPrimaryMonitor();
+}
+
+double MediaPlayer::GetDisplayRefreshRate() {
+    GLFWmonitor* monitor = FindWindowMonitor();
+    const GLFWvidmode* mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+    return mode ? static_cast<double>(mode->refreshRate) : 0.0;
+}
+
+bool MediaPlayer::SeekTo(double timeSeconds) {
+    if (!_decoder || !_hasVideo) return false;
+    
+    _latency.Begin(UserAction::Seek);
+    _seekedThisFrame = true;
+    _refineTarget = -1.0;
+    _decodeWorker.Cancel();
+    if (_decoderRestartPending) {
+        _decoderRestartPending = false;
+        _decoder->RestartCodec();
+    }
+    bool decoded = false;
     if (_decoder->Seek(timeSeconds)) {
-        if (_decoder->DecodeNextFrame(_currentFrame)) {
+        _latency.Mark(LatencyStage::Issued);
+        ResetFrameQueue();
+        decoded = _decoder->DecodeNextFrame(_currentFrame);
+        if (decoded) {
+            _latency.Mark(LatencyStage::Decoded);
+            if (_stabilizerActive) {
+                _stabilizer->Analyze(_currentFrame);
+            }
             if (_videoTexture) {
-                _videoTexture->SetData(
-                    _currentFrame.data.data(),
-                    _currentFrame.width,
-                    _currentFrame.height
-                );
+                UploadCurrentFrame();
+                ProcessCurrentFrame();
+                _syncBenchmark.OnFramePresented(ElapsedTime(), _currentFrame);
             }
         }
         
         double actual_time = _currentFrame.timestamp;
+        double fps = _decoder->GetFPS();
+        if (decoded && fps > 0.0 && actual_time < timeSeconds - 0.5 / fps &&
+            timeSeconds < _decoder->GetDuration() - 0.5 / fps) {
+            _decoder->SkipTo(timeSeconds);
+            if (_decoder->IsSkipping() && _decodeWorker.Refine()) {
+                _refineTarget = timeSeconds;
+                _refineStart = ElapsedTime();
+            }
+        }
         
         if (_audioDecoder->HasAudio()) {
             _audioDecoder->Seek(actual_time);
+            if (_isPlaying && _refineTarget >= 0.0) {
+                _audioDecoder->Pause();
+            } else if (_isPlaying) {
+                _audioDecoder->Play();
+            }
         }
         
         _pausedAtTime = actual_time;
@@ -697,7 +1369,267 @@ void MediaPlayer::SeekTo(double timeSeconds) {
             _videoStartTime = ElapsedTime() - actual_time;
         }
         
-        TVK_LOG_INFO("Seeked to {}s", actual_time);
+        if (_refineTarget >= 0.0) {
+            TVK_LOG_INFO("Seeked to keyframe {}s, refining to {}s", actual_time, timeSeconds);
+        } else {
+            TVK_LOG_INFO("Seeked to {}s", actual_time);
+        }
+    }
+    return decoded;
+}
+
+void MediaPlayer::RefineSeek() {
+    DecodeResult result = _decodeWorker.Poll(_currentFrame);
+    if (result == DecodeResult::Frame) {
+        if (_stabilizerActive) {
+            _stabilizer->Analyze(_currentFrame);
+        }
+        if (_videoTexture) {
+            UploadCurrentFrame();
+            ProcessCurrentFrame();
+        }
+        _refineMs = static_cast<float>((ElapsedTime() - _refineStart) * 1000.0);
+        TVK_LOG_INFO("Refined seek to {}s in {:.1f} ms", _currentFrame.timestamp, _refineMs);
+        FinishRefine();
+    } else if (result == DecodeResult::Failed) {
+        TVK_LOG_ERROR("Seek refinement to {:.3f}s failed, keeping the keyframe", _refineTarget);
+        FinishRefine();
+    } else if (_isPlaying) {
+        _videoStartTime = ElapsedTime() - _pausedAtTime;
+    }
+}
+
+void MediaPlayer::FinishRefine() {
+    _refineTarget = -1.0;
+    double actual_time = _currentFrame.timestamp;
+    
+    if (_audioDecoder->HasAudio()) {
+        _audioDecoder->Seek(actual_time);
+        if (_isPlaying) {
+            _audioDecoder->Play();
+        }
+    }
+    
+    _pausedAtTime = actual_time;
+    
+    if (_isPlaying) {
+        _videoStartTime = ElapsedTime() - actual_time;
+    }
+}
+
+void MediaPlayer::ScrubTo(double timeSeconds) {
+    if (!_decoder || !_hasVideo) return;
+    
+    if (!_scrubbing) {
+        _decodeWorker.Cancel();
+        _scrubbing = true;
+        _refineTarget = -1.0;
+        _decoder->SetScrubbing(true);
+        ResetFrameQueue();
+        if (_isPlaying && _audioDecoder->HasAudio()) {
+            _audioDecoder->Pause();
+        }
+    }
+    if (_isPlaying) {
+        _videoStartTime = ElapsedTime() - _pausedAtTime;
+    }
+    
+    _scrubTarget = timeSeconds;
+    UpdateScrub();
+}
+
+void MediaPlayer::UpdateScrub() {
+    if (_decodeWorker.Poll(_currentFrame) == DecodeResult::Frame) {
+        _pausedAtTime = _currentFrame.timestamp;
+        if (_videoTexture) {
+            UploadCurrentFrame();
+            ProcessCurrentFrame();
+        }
+    }
+    
+    // Only the newest position is kept; it is sent as soon as the worker is free
+    if (_scrubTarget >= 0.0 && _decodeWorker.Scrub(_scrubTarget)) {
+        _scrubTarget = -1.0;
+    }
+}
+
+void MediaPlayer::EndScrub() {
+    if (!_scrubbing) return;
+    _decodeWorker.Cancel();
+    _scrubbing = false;
+    _scrubTarget = -1.0;
+    _decoder->SetScrubbing(false);
+}
+
+bool MediaPlayer::SelectAudioTrack(int streamIndex) {
+    _decodeWorker.Wait();
+    double video_time = _decoder ? _decoder->GetCurrentTime() : 0.0;
+    if (!_audioDecoder->SelectAudioStream(streamIndex, video_time)) {
+        TVK_LOG_ERROR("Failed to switch audio stream {}", streamIndex);
+        return false;
+    }
+    TVK_LOG_INFO("Switched to audio stream {}", streamIndex);
+    return true;
+}
+
+bool MediaPlayer::SelectNextAudioTrack() {
+    if (!_audioDecoder->HasAudio()) return false;
+    
+    std::vector<int> indices = _audioDecoder->GetAvailableAudioStreamIndices();
+    if (indices.size() < 2) return false;
+    
+    auto it = std::find(indices.begin(), indices.end(), _audioDecoder->GetSelectedAudioStreamIndex());
+    int next = (it == indices.end() || it + 1 == indices.end()) ? indices.front() : *(it + 1);
+    return SelectAudioTrack(next);
+}
+
+void MediaPlayer::StartSyncBenchmark() {
+    std::string path = SyncBenchmark::GetMediaPath();
+    if (!SyncBenchmark::GenerateMedia(path, _syncBenchmark.GetSettings().trackOffsetMs)) return;
+    
+    _audioDecoder->SetCaptureSink(nullptr);
+    if (!OpenMedia(path) || !_audioDecoder->HasAudio() ||
+        static_cast<int>(_audioDecoder->GetAvailableAudioStreamIndices().size()) < SyncBenchmark::TRACK_COUNT) {
+        TVK_LOG_ERROR("Sync benchmark: could not play the generated media");
+        return;
+    }
+    
+    _audioDecoder->SetCaptureSink(&_syncBenchmark);
+    _syncBenchmark.Start(ElapsedTime());
+    _showSyncBenchmarkWindow = true;
+    TVK_LOG_INFO("Sync benchmark started with {}", path);
+}
+
+void MediaPlayer::StartSeekStress() {
+    auto filepath = tvk::FileDialog::OpenFile({{"Video Files", "mp4,m4v,mov,mkv,webm,avi,wmv,flv,ts,nut"}});
+    if (!filepath.has_value()) return;
+    
+    _syncBenchmark.Cancel();
+    _soakTest.Cancel();
+    _audioDecoder->SetCaptureSink(nullptr);
+    if (_seekStress.Start(filepath.value())) {
+        _showSeekStressWindow = true;
+    }
+}
+
+void MediaPlayer::UpdateSeekStress() {
+    if (!_seekStress.IsRunning()) return;
+    
+    if (_seekStress.NeedsOpen()) {
+        if (OpenMedia(_seekStress.GetCurrentPath()) && _hasVideo) {
+            if (_isPlaying) TogglePlayPause();
+            _seekStress.BeginFile(*_decoder);
+        } else {
+            _seekStress.SkipFile();
+        }
+        return;
+    }
+    
+    if (_isPlaying) TogglePlayPause();
+    
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::duration<double>(_seekStress.GetSettings().frameBudget);
+    do {
+        SeekRequest request = _seekStress.Next();
+        if (request.switchTrack) {
+            SelectNextAudioTrack();
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        bool presented = SeekTo(request.target);
+        if (_refineTarget >= 0.0) {
+            _decodeWorker.Wait();
+            RefineSeek();
+        }
+        double latency = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        bool hasAudio = _audioDecoder->HasAudio();
+        _seekStress.Check(request, latency, presented, _currentFrame.timestamp, hasAudio,
+                          hasAudio ? _audioDecoder->GetPlaybackTime() : 0.0);
+    } while (_seekStress.IsRunning() && !_seekStress.NeedsOpen() && std::chrono::steady_clock::now() < deadline);
+}
+
+void MediaPlayer::StartSoakTest() {
+    _syncBenchmark.Cancel();
+    _seekStress.Cancel();
+    _audioDecoder->SetCaptureSink(nullptr);
+    _soakTest.Start(_currentFilePath, ElapsedTime());
+    _showSoakTestWindow = true;
+}
+
+void MediaPlayer::UpdateSoakTest() {
+    if (!_soakTest.IsRunning()) return;
+    
+    double now = ElapsedTime();
+    bool driftValid = _isPlaying && _hasVideo && _audioDecoder->HasAudio();
+    float driftMs = driftValid
+        ? static_cast<float>((_audioDecoder->GetPlaybackTime() - (now - _videoStartTime)) * 1000.0)
+        : 0.0f;
+    double duration = _hasVideo ? _decoder->GetDuration() : 0.0;
+    
+    SoakAction action = _soakTest.Update(now, driftValid, driftMs);
+    switch (action) {
+        case SoakAction::Reopen:
+            if (!OpenMedia(_soakTest.GetPath())) {
+                TVK_LOG_ERROR("Soak test: could not reopen {}", _soakTest.GetPath());
+                _soakTest.Cancel();
+            }
+            break;
+        case SoakAction::Play:
+            if (!_isPlaying) TogglePlayPause();
+            break;
+        case SoakAction::Seek:
+            SeekTo(_soakTest.GetTarget() * duration);
+            break;
+        case SoakAction::HoverThumbnail:
+            RequestThumbnail(_soakTest.GetTarget() * duration);
+            break;
+        case SoakAction::SwitchTrack:
+            SelectNextAudioTrack();
+            break;
+        case SoakAction::EffectsOn:
+        case SoakAction::EffectsOff: {
+            bool on = action == SoakAction::EffectsOn;
+            PostProcessSettings& pp = _videoEffects->GetPostProcess();
+            pp.vignette = on ? 0.4f : 0.0f;
+            pp.bloom = on ? 0.5f : 0.0f;
+            _videoEffects->GetStabilization().enabled = on;
+            _videoFrameDirty = true;
+            break;
+        }
+        case SoakAction::Finish:
+            if (_isPlaying) TogglePlayPause();
+            break;
+        default:
+            break;
+    }
+}
+
+void MediaPlayer::UpdateSyncBenchmark() {
+    if (!_syncBenchmark.IsRunning()) return;
+    
+    double audioClock = _audioDecoder->GetPlaybackTime();
+    SyncAction action = _syncBenchmark.Update(ElapsedTime(), audioClock, _audioDecoder->IsPlaying());
+    
+    switch (action) {
+        case SyncAction::Play:
+            if (!_isPlaying) TogglePlayPause();
+            break;
+        case SyncAction::Pause:
+            if (_isPlaying) TogglePlayPause();
+            break;
+        case SyncAction::Seek:
+            SeekTo(SyncBenchmark::SEEK_TARGET);
+            break;
+        case SyncAction::SwitchTrack:
+            SelectAudioTrack(_audioDecoder->GetAvailableAudioStreamIndices()[_syncBenchmark.GetTrack()]);
+            break;
+        case SyncAction::Finish:
+            if (_isPlaying) TogglePlayPause();
+            _audioDecoder->SetCaptureSink(nullptr);
+            break;
+        default:
+            break;
     }
 }
 
@@ -885,28 +1817,10 @@ void MediaPlayer::DrawWindowControls() {
             _prevWinW = ext.width;
             _prevWinH = ext.height;
 
-            int wx = _prevWinX + static_cast<int>(_prevWinW) / 2;
-            int wy = _prevWinY + static_cast<int>(_prevWinH) / 2;
-            int monitor_count = 0;
-            GLFWmonitor** monitors = glfwGetMonitors(&monitor_count);
-
             int work_x = 0, work_y = 0, work_w = 0, work_h = 0;
-            bool found = false;
-            for (int i = 0; i < monitor_count; ++i) {
-                int mx, my, mw, mh;
-                glfwGetMonitorWorkarea(monitors[i], &mx, &my, &mw, &mh);
-                if (wx >= mx && wx < mx + mw && wy >= my && wy < my + mh) {
-                    work_x = mx; work_y = my; work_w = mw; work_h = mh;
-                    found = true;
-                    break;
-                }
-            }
-
-            if (!found) {
-                GLFWmonitor* primary = glfwGetPrimaryMonitor();
-                if (primary)
-                    glfwGetMonitorWorkarea(primary, &work_x, &work_y, &work_w, &work_h);
-            }
+            GLFWmonitor* monitor = FindWindowMonitor();
+            if (monitor)
+                glfwGetMonitorWorkarea(monitor, &work_x, &work_y, &work_w, &work_h);
 
             if (work_w > 0 && work_h > 0) {
                 window->SetPosition(work_x, work_y);
@@ -1042,6 +1956,7 @@ void MediaPlayer::DrawPostProcessWindow() {
         
         ImGui::SliderFloat("Film Grain", &pp.filmGrain, 0.0f, 1.0f, "%.2f");
         ImGui::SliderFloat("Scanlines", &pp.scanlines, 0.0f, 1.0f, "%.2f");
+        ImGui::Checkbox("Source Film Grain (AV1)", &_videoEffects->GetFilmGrainSettings().enabled);
         
         ImGui::Spacing();
         ImGui::Text("Vintage");
@@ -1052,9 +1967,21 @@ void MediaPlayer::DrawPostProcessWindow() {
             ImGui::SliderFloat("Vintage Strength", &pp.vintageStrength, 0.0f, 1.0f, "%.2f");
         }
         
+        UpscaleSettings& upscale = _upscaler->GetSettings();
+        ImGui::Spacing();
+        ImGui::Text("Upscaling");
+        ImGui::Separator();
+        
+        ImGui::Checkbox("Enable Upscaling", &upscale.enabled);
+        if (upscale.enabled) {
+            ImGui::SliderFloat("Sharpening Falloff", &upscale.sharpness, 0.0f, 2.0f, "%.2f stops");
+            ImGui::TextDisabled("%s", _upscaler->IsActive() ? "Upscaling to the view size" : "Source already fills the view");
+        }
+        
         ImGui::Spacing();
         if (ImGui::Button("Reset##PostProcess", ImVec2(-1, 0))) {
             pp.Reset();
+            upscale.Reset();
         }
     }
     ImGui::End();
@@ -1121,10 +2048,33 @@ void MediaPlayer::DrawEffectsWindow() {
             ImGui::Spacing(); ImGui::Text("Film"); ImGui::Separator();
             ImGui::SliderFloat("Film Grain", &pp.filmGrain, 0.0f, 1.0f, "%.2f");
             ImGui::SliderFloat("Scanlines", &pp.scanlines, 0.0f, 1.0f, "%.2f");
+            ImGui::Checkbox("Source Film Grain (AV1)", &_videoEffects->GetFilmGrainSettings().enabled);
             ImGui::Spacing(); ImGui::Text("Vintage"); ImGui::Separator();
             ImGui::Checkbox("Enable Vintage", &pp.vintageEnabled);
             if (pp.vintageEnabled) ImGui::SliderFloat("Vintage Strength", &pp.vintageStrength, 0.0f, 1.0f, "%.2f");
-            ImGui::Spacing(); if (ImGui::Button("Reset##PostProcess", ImVec2(-1, 0))) pp.Reset();
+            UpscaleSettings& upscale = _upscaler->GetSettings();
+            ImGui::Spacing(); ImGui::Text("Upscaling"); ImGui::Separator();
+            ImGui::Checkbox("Enable Upscaling", &upscale.enabled);
+            if (upscale.enabled) ImGui::SliderFloat("Sharpening Falloff", &upscale.sharpness, 0.0f, 2.0f, "%.2f stops");
+            ImGui::Spacing();
+            if (ImGui::Button("Reset##PostProcess", ImVec2(-1, 0))) {
+                pp.Reset();
+                upscale.Reset();
+            }
+            ImGui::EndTabItem();
+        }
+
+        if (ImGui::BeginTabItem("Stabilization")) {
+            StabilizationSettings& stab = _videoEffects->GetStabilization();
+            ImGui::Checkbox("Enable Stabilization", &stab.enabled);
+            ImGui::Spacing(); ImGui::Text("Smoothing"); ImGui::Separator();
+            ImGui::SliderInt("Smoothing Radius", &stab.smoothingRadius, 1, VideoStabilizer::MAX_RADIUS, "%d frames");
+            ImGui::SliderFloat("Max Correction", &stab.maxCorrection, 0.0f, 0.2f, "%.2f");
+            if (_stabilizerActive) {
+                ImGui::TextDisabled("Analysis: %.2f ms/frame, peak %.2f ms",
+                                    _stabilizer->GetAnalyzeSeconds() * 1000.0, _stabilizer->GetPeakAnalyzeSeconds() * 1000.0);
+            }
+            ImGui::Spacing(); if (ImGui::Button("Reset##Stabilization", ImVec2(-1, 0))) stab.Reset();
             ImGui::EndTabItem();
         }
 
@@ -1136,6 +2086,563 @@ void MediaPlayer::DrawEffectsWindow() {
     ImGui::End();
 }
 
+void MediaPlayer::DrawCopyBenchmarkWindow() {
+    ImGui::SetNextWindowSize(ImVec2(420, 220), ImGuiCond_FirstUseEver);
+    
+    if (ImGui::Begin("Frame Copy Benchmark", &_showCopyBenchmarkWindow)) {
+        ImGui::Text("Frame: %ux%u RGBA", _copyBenchmark.width, _copyBenchmark.height);
+        ImGui::Separator();
+        
+        if (_copyBenchmark.count == 0) {
+            ImGui::TextDisabled("No mapped memory types could be benchmarked");
+        } else if (ImGui::BeginTable("CopyBenchmark", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerH)) {
+            ImGui::TableSetupColumn("Memory");
+            ImGui::TableSetupColumn("Method");
+            ImGui::TableSetupColumn("GB/s");
+            ImGui::TableSetupColumn("ms/frame");
+            ImGui::TableHeadersRow();
+            
+            for (int i = 0; i < _copyBenchmark.count; i++) {
+                const CopyBenchmarkResult& result = _copyBenchmark.results[i];
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(result.memory);
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(result.method);
+                ImGui::TableNextColumn(); ImGui::Text("%.2f", result.gigabytesPerSecond);
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", result.millisecondsPerFrame);
+            }
+            ImGui::EndTable();
+        }
+    }
+    ImGui::End();
+}
+
+void MediaPlayer::DrawSyncBenchmarkWindow() {
+    ImGui::SetNextWindowSize(ImVec2(460, 280), ImGuiCond_FirstUseEver);
+    
+    if (ImGui::Begin("A/V Sync Benchmark", &_showSyncBenchmarkWindow)) {
+        const SyncBenchmarkReport& report = _syncBenchmark.GetReport();
+        const SyncBenchmarkSettings& settings = _syncBenchmark.GetSettings();
+        ImGui::Text("Limits: %.0f ms offset, %.0f ms drift; second track offset %+.0f ms",
+                    settings.maxOffsetMs, settings.maxDriftMs, settings.trackOffsetMs);
+        ImGui::Separator();
+        
+        if (_syncBenchmark.IsRunning()) {
+            ImGui::Text("Running... %d flash/beep pairs measured", report.count);
+        } else if (!report.finished) {
+            ImGui::TextDisabled("Not run");
+        } else {
+            ImVec4 color = report.passed ? ImVec4(0.3f, 0.9f, 0.4f, 1.0f) : ImVec4(1.0f, 0.35f, 0.3f, 1.0f);
+            ImGui::TextColored(color, "%s%s%s", report.passed ? "PASS" : "FAIL", report.passed ? "" : ": ",
+                               report.failure);
+            ImGui::Text("%d pairs, mean %+.1f ms, stddev %.1f ms, worst %.1f ms, drift %.1f ms",
+                        report.count, report.meanMs, report.stddevMs, report.worstMs, report.driftMs);
+        }
+        
+        if (report.count > 0 && ImGui::BeginTable("SyncPhases", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerH)) {
+            ImGui::TableSetupColumn("Phase");
+            ImGui::TableSetupColumn("Pairs");
+            ImGui::TableSetupColumn("Mean ms");
+            ImGui::TableSetupColumn("Range ms");
+            ImGui::TableHeadersRow();
+            
+            for (int i = 0; i < static_cast<int>(SyncPhase::Count); i++) {
+                const SyncPhaseResult& phase = report.phases[i];
+                if (phase.count == 0) continue;
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(SyncBenchmark::GetPhaseName(static_cast<SyncPhase>(i)));
+                ImGui::TableNextColumn(); ImGui::Text("%d", phase.count);
+                ImGui::TableNextColumn(); ImGui::Text("%+.1f", phase.meanMs);
+                ImGui::TableNextColumn(); ImGui::Text("%+.1f .. %+.1f", phase.minMs, phase.maxMs);
+            }
+            ImGui::EndTable();
+        }
+        
+        if (report.count > 1) {
+            ImGui::PlotLines("##SyncErrors", report.errorsMs, report.count, 0, "error per pair (ms)",
+                             -settings.maxOffsetMs, settings.maxOffsetMs, ImVec2(-1.0f, 80.0f));
+        }
+    }
+    ImGui::End();
+}
+
+void MediaPlayer::DrawSeekStressWindow() {
+    ImGui::SetNextWindowSize(ImVec2(720, 300), ImGuiCond_FirstUseEver);
+    
+    if (ImGui::Begin("Seek Stress Test", &_showSeekStressWindow)) {
+        const SeekStressSettings& settings = _seekStress.GetSettings();
+        ImGui::Text("%d seeks per pattern, seed %u, audio tolerance %.0f ms",
+                    settings.seeksPerPattern, settings.seed, settings.audioTolerance * 1000.0);
+        ImGui::Separator();
+        
+        if (_seekStress.IsRunning()) {
+            ImGui::Text("Running file %d/%d, seek %d/%d", _seekStress.GetFileIndex() + 1, _seekStress.GetFileCount(),
+                        _seekStress.GetSeekIndex(), _seekStress.GetSeeksPerFile());
+            if (ImGui::Button("Cancel")) {
+                _seekStress.Cancel();
+            }
+        } else if (_seekStress.GetResults().empty()) {
+            ImGui::TextDisabled("Not run");
+        }
+        
+        const std::vector<SeekStressResult>& results = _seekStress.GetResults();
+        if (!results.empty() && ImGui::BeginTable("SeekStress", 8, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerH)) {
+            ImGui::TableSetupColumn("File");
+            ImGui::TableSetupColumn("Format");
+            ImGui::TableSetupColumn("Seeks");
+            ImGui::TableSetupColumn("Failures");
+            ImGui::TableSetupColumn("p50 ms");
+            ImGui::TableSetupColumn("p95 ms");
+            ImGui::TableSetupColumn("p99 ms");
+            ImGui::TableSetupColumn("Max ms");
+            ImGui::TableHeadersRow();
+            
+            for (const SeekStressResult& result : results) {
+                int failures = 0;
+                for (int failure : result.failures) {
+                    failures += failure;
+                }
+                std::string name = std::filesystem::path(result.path).filename().string();
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(name.c_str());
+                if (!result.opened) {
+                    ImGui::TableNextColumn(); ImGui::TextDisabled("open failed");
+                    continue;
+                }
+                ImGui::TableNextColumn(); ImGui::Text("%s / %s", result.container.c_str(), result.codec.c_str());
+                ImGui::TableNextColumn(); ImGui::Text("%d", result.seeks);
+                ImGui::TableNextColumn();
+                if (failures > 0) {
+                    ImGui::TextColored(ImVec4(1.0f, 0.35f, 0.3f, 1.0f), "%d", failures);
+                    if (ImGui::IsItemHovered()) {
+                        ImGui::BeginTooltip();
+                        for (int i = 0; i < static_cast<int>(SeekPattern::Count); i++) {
+                            if (result.failures[i] == 0) continue;
+                            ImGui::Text("%s: %d", SeekStress::GetPatternName(static_cast<SeekPattern>(i)), result.failures[i]);
+                        }
+                        ImGui::EndTooltip();
+                    }
+                } else {
+                    ImGui::Text("0");
+                }
+                ImGui::TableNextColumn(); ImGui::Text("%.1f", result.p50Ms);
+                ImGui::TableNextColumn(); ImGui::Text("%.1f", result.p95Ms);
+                ImGui::TableNextColumn(); ImGui::Text("%.1f", result.p99Ms);
+                ImGui::TableNextColumn(); ImGui::Text("%.1f", result.maxMs);
+            }
+            ImGui::EndTable();
+        }
+    }
+    ImGui::End();
+}
+
+void MediaPlayer::DrawSoakTestWindow() {
+    ImGui::SetNextWindowSize(ImVec2(480, 360), ImGuiCond_FirstUseEver);
+    
+    if (ImGui::Begin("Soak Test", &_showSoakTestWindow)) {
+        const SoakReport& report = _soakTest.GetReport();
+        const SoakSettings& settings = _soakTest.GetSettings();
+        ImGui::Text("%.0f simulated hours, %.0f min per cycle", settings.simulatedHours, settings.minutesPerCycle);
+        ImGui::Text("Limits: RSS %+.0f MB/session, drift %.0f ms, %d textures/cycle",
+                    settings.maxRssGrowthMb, settings.maxDriftMs, settings.maxTexturesPerCycle);
+        ImGui::Separator();
+        
+        if (_soakTest.IsRunning()) {
+            ImGui::Text("Running cycle %d/%d", _soakTest.GetCycle() + 1, _soakTest.GetCycleCount());
+            if (ImGui::Button("Cancel")) {
+                _soakTest.Cancel();
+            }
+        } else if (!report.finished) {
+            ImGui::TextDisabled(report.count > 0 ? "Cancelled" : "Not run");
+        } else {
+            ImVec4 color = report.passed ? ImVec4(0.3f, 0.9f, 0.4f, 1.0f) : ImVec4(1.0f, 0.35f, 0.3f, 1.0f);
+            ImGui::TextColored(color, "%s%s%s", report.passed ? "PASS" : "FAIL", report.passed ? "" : ": ",
+                               report.failure);
+            ImGui::Text("RSS %+.1f MB/session, worst drift %.1f ms, drift trend %+.1f ms/session",
+                        report.rssGrowthMb, report.worstDriftMs, report.driftGrowthMs);
+        }
+        
+        if (report.count > 0) {
+            const SoakSample& last = report.samples[report.count - 1];
+            ImGui::Text("At %.1f h: RSS %.1f MB, drift %.1f ms", last.hours, last.rssMb, last.driftMs);
+            ImGui::Text("Vulkan objects %d, descriptor sets %d, OpenAL objects %d",
+                        last.gpuObjects, last.descriptorSets, last.openALObjects);
+            if (AllocTracker::ENABLED) {
+                ImGui::Text("Textures created %d, heap allocations %d per cycle",
+                            last.texturesCreated, last.heapAllocations);
+            } else {
+                ImGui::Text("Textures created %d per cycle", last.texturesCreated);
+            }
+        }
+        
+        if (report.count > 1) {
+            ImGui::PlotLines("##SoakRss", &report.samples[0].rssMb, report.count, 0, "RSS (MB)",
+                             FLT_MAX, FLT_MAX, ImVec2(-1.0f, 70.0f), sizeof(SoakSample));
+            ImGui::PlotLines("##SoakDrift", &report.samples[0].driftMs, report.count, 0, "worst drift per cycle (ms)",
+                             0.0f, settings.maxDriftMs, ImVec2(-1.0f, 70.0f), sizeof(SoakSample));
+        }
+    }
+    ImGui::End();
+}
+
+void MediaPlayer::DrawTimelineWindow() {
+    ImGui::SetNextWindowSize(ImVec2(900, 140), ImGuiCond_FirstUseEver);
+    
+    if (ImGui::Begin("Timeline", &_showTimelineWindow)) {
+        if (!_hasVideo || !_thumbnailPyramid.IsOpen()) {
+            ImGui::TextDisabled("No video loaded");
+            ImGui::End();
+            return;
+        }
+        
+        double duration = _thumbnailPyramid.GetDuration();
+        float height = ThumbnailPyramid::TILE_HEIGHT * 1.5f;
+        float width = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImGui::InvisibleButton("##timeline", ImVec2(width, height));
+        
+        ImGuiIO& io = ImGui::GetIO();
+        float mouseX = io.MousePos.x - origin.x;
+        double finest = _thumbnailPyramid.GetTileSeconds(_thumbnailPyramid.GetLevelCount() - 1);
+        double minSpan = std::min(duration, finest * width / (height * 16.0f / 9.0f) * 0.25);
+        
+        if (ImGui::IsItemHovered() && io.MouseWheel != 0.0f) {
+            double anchor = _timelineStart + mouseX * _timelineSpan / width;
+            _timelineSpan = std::clamp(_timelineSpan * std::pow(0.8, io.MouseWheel), minSpan, duration);
+            _timelineStart = anchor - mouseX * _timelineSpan / width;
+        }
+        if (ImGui::IsItemActive() && ImGui::IsMouseDragging(ImGuiMouseButton_Left)) {
+            _timelineStart -= io.MouseDelta.x * _timelineSpan / width;
+            _timelineDragged = true;
+        }
+        if (ImGui::IsItemDeactivated()) {
+            if (!_timelineDragged) {
+                SeekTo(std::clamp(_timelineStart + mouseX * _timelineSpan / width, 0.0, duration));
+            }
+            _timelineDragged = false;
+        }
+        _timelineSpan = std::clamp(_timelineSpan, minSpan, duration);
+        _timelineStart = std::clamp(_timelineStart, 0.0, duration - _timelineSpan);
+        
+        double secondsPerPixel = _timelineSpan / width;
+        double end = _timelineStart + _timelineSpan;
+        int level = _thumbnailPyramid.ChooseLevel(secondsPerPixel * height * 16.0 / 9.0);
+        _thumbnailPyramid.RequestRange(level, _timelineStart, end);
+        
+        ImDrawList* dl = ImGui::GetWindowDrawList();
+        ImVec2 corner = ImVec2(origin.x + width, origin.y + height);
+        dl->PushClipRect(origin, corner, true);
+        dl->AddRectFilled(origin, corner, IM_COL32(20, 20, 20, 255));
+        
+        if (_timelineAtlas) {
+            double tileSeconds = _thumbnailPyramid.GetTileSeconds(level);
+            int first = static_cast<int>(_timelineStart / tileSeconds);
+            int last = std::min(static_cast<int>(end / tileSeconds), _thumbnailPyramid.GetTileCount(level) - 1);
+            PyramidTile tile;
+            for (int i = first; i <= last; i++) {
+                if (!_thumbnailPyramid.GetTile(level, i, tile)) continue;
+                float x0 = origin.x + static_cast<float>((i * tileSeconds - _timelineStart) / secondsPerPixel);
+                float x1 = origin.x + static_cast<float>(((i + 1) * tileSeconds - _timelineStart) / secondsPerPixel);
+                dl->AddImage(_timelineAtlas->GetImGuiTextureID(), ImVec2(x0, origin.y), ImVec2(x1, corner.y),
+                             ImVec2(tile.u0, tile.v0), ImVec2(tile.u1, tile.v1));
+            }
+        }
+        
+        double position = _isPlaying ? ElapsedTime() - _videoStartTime : _pausedAtTime;
+        float playheadX = origin.x + static_cast<float>((position - _timelineStart) / secondsPerPixel);
+        dl->AddLine(ImVec2(playheadX, origin.y), ImVec2(playheadX, corner.y), IM_COL32(255, 100, 50, 255), 2.0f);
+        dl->PopClipRect();
+        
+        ImGui::Text("%.1fs - %.1fs, level %d/%d (%.1fs per tile)", _timelineStart, end, level + 1,
+                    _thumbnailPyramid.GetLevelCount(), _thumbnailPyramid.GetTileSeconds(level));
+        ImGui::TextDisabled("%d / %d tiles resident, %llu decoded, %llu read from %s",
+                            _thumbnailPyramid.GetResidentCount(), ThumbnailPyramid::ATLAS_SLOTS,
+                            static_cast<unsigned long long>(_thumbnailPyramid.GetDecodedCount()),
+                            static_cast<unsigned long long>(_thumbnailPyramid.GetDiskReadCount()),
+                            _thumbnailPyramid.GetCachePath().c_str());
+    }
+    ImGui::End();
+}
+
+void MediaPlayer::DrawThreadPlacementMenu() {
+    if (!ImGui::BeginMenu("Thread Placement")) return;
+    
+    ThreadPlacementSettings& settings = _threadPlacement.GetSettings();
+    bool changed = false;
+    
+    changed |= ImGui::MenuItem("Enabled", nullptr, &settings.enabled);
+    ImGui::Separator();
+    changed |= ImGui::MenuItem("Isolate Audio Core", nullptr, &settings.isolateAudio, settings.enabled);
+    changed |= ImGui::MenuItem("Decode on Performance Cores", nullptr, &settings.performanceDecode, settings.enabled);
+    changed |= ImGui::MenuItem("Background on Efficiency Cores", nullptr, &settings.efficiencyBackground, settings.enabled);
+    changed |= ImGui::MenuItem("NUMA-Local Frame Pool", nullptr, &settings.numaLocalFrames, settings.enabled);
+    
+    if (changed) {
+        _threadPlacement.Replan();
+        _threadPlacement.Apply(ThreadClass::Decode);
+        TVK_LOG_INFO("Thread placement updated; decoder and audio threads follow on next open");
+    }
+    
+    ImGui::EndMenu();
+}
+
+void MediaPlayer::DrawPowerProfileMenu() {
+    if (!ImGui::BeginMenu("Power Profile")) return;
+    
+    PowerProfileSettings& settings = _powerProfile.GetSettings();
+    const PowerMode modes[] = { PowerMode::Auto, PowerMode::Performance, PowerMode::PowerSaver };
+    const char* labels[] = { "Automatic", "Performance", "Power Saver" };
+    
+    for (int i = 0; i < 3; i++) {
+        if (ImGui::MenuItem(labels[i], nullptr, settings.mode == modes[i])) {
+            settings.mode = modes[i];
+        }
+    }
+    
+    ImGui::Separator();
+    ImGui::TextDisabled("On %s, %s", PowerProfile::GetSourceName(_powerProfile.GetSource()),
+                        _powerProfile.IsPowerSaving() ? "saving power" : "full performance");
+    
+    ImGui::EndMenu();
+}
+
+void MediaPlayer::DrawSequenceFrameRateMenu() {
+    if (!ImGui::BeginMenu("Sequence Frame Rate")) return;
+    
+    double current = ImageSequence::GetFrameRate();
+    for (double rate : SEQUENCE_FRAME_RATES) {
+        char label[32];
+        snprintf(label, sizeof(label), "%g fps", rate);
+        if (ImGui::MenuItem(label, nullptr, std::fabs(current - rate) < 0.001)) {
+            ImageSequence::SetFrameRate(rate);
+            if (_hasVideo && _decoder->IsSequence()) {
+                OpenMedia(_currentFilePath);
+            }
+        }
+    }
+    
+    ImGui::EndMenu();
+}
+
+void MediaPlayer::DrawFlightRecorderMenu() {
+    if (!ImGui::BeginMenu("Flight Recorder")) return;
+    
+    FlightRecorderSettings& settings = _flightRecorder.GetSettings();
+    ImGui::MenuItem("Enabled", nullptr, &settings.enabled);
+    ImGui::MenuItem("Dump on Audio Underrun", nullptr, &settings.dumpOnUnderrun, settings.enabled);
+    ImGui::SetNextItemWidth(160.0f);
+    ImGui::SliderFloat("Hitch Threshold", &settings.hitchThresholdMs, 10.0f, 500.0f, "%.0f ms");
+    
+    ImGui::Separator();
+    if (ImGui::MenuItem("Dump Now")) {
+        _flightRecorder.Trigger("manual");
+    }
+    ImGui::TextDisabled("%llu hitches, %d dumps in %s", static_cast<unsigned long long>(_flightRecorder.GetHitchCount()),
+                        _flightRecorder.GetDumpCount(), _flightRecorder.GetDirectory().c_str());
+    
+    ImGui::EndMenu();
+}
+
+void MediaPlayer::DrawStatsOverlay() {
+    const ImGuiViewport* viewport = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + 12.0f, viewport->WorkPos.y + 12.0f), ImGuiCond_Always);
+    ImGui::SetNextWindowBgAlpha(0.6f);
+    
+    ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+                             ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
+                             ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove;
+    
+    if (ImGui::Begin("Statistics", &_showStats, flags)) {
+        if (_hasVideo && _decoder) {
+            ImGui::Text("Video: %dx%d @ %.2f fps", _decoder->GetWidth(), _decoder->GetHeight(), _decoder->GetFPS());
+            if (_decoder->IsRaw()) {
+                ImGui::Text("Decoder: none, raw %s mapped, %s unpack", RawVideoFile::GetFormatName(_decoder->GetRawFormat()),
+                            _decoder->IsRawPassthrough() ? "GPU" : "CPU");
+            } else {
+                ImGui::Text("Decoder: %s", _decoder->IsHardwareAccelerated() ? _decoder->GetHWAccelName() : "Software");
+            }
+            ImGui::Text("Frame queue: %d / %d", _frameQueue.GetSize(), _frameQueue.GetCapacity());
+            if (_stabilizerActive) {
+                double budget = _decoder->GetFPS() > 0.0 ? 1000.0 / _decoder->GetFPS() : 0.0;
+                ImGui::Text("Stabilizer: analysis %.2f ms/frame (peak %.2f) of %.1f ms, lookahead %d",
+                            _stabilizer->GetAnalyzeSeconds() * 1000.0, _stabilizer->GetPeakAnalyzeSeconds() * 1000.0,
+                            budget, _videoEffects->GetStabilization().smoothingRadius);
+            }
+            if (_displaySync.IsActive()) {
+                ImGui::Text("Display sync: x%d at %.3f Hz, speed %+.3f%%, %llu dropped, %llu repeated",
+                            _displaySync.GetRepeats(), _displaySync.GetRefreshRate(),
+                            (_displaySync.GetSpeed() - 1.0) * 100.0,
+                            static_cast<unsigned long long>(_displaySync.GetDroppedCount()),
+                            static_cast<unsigned long long>(_displaySync.GetRepeatedCount()));
+            } else if (_displaySync.IsEnabled()) {
+                ImGui::Text("Display sync: inactive (%.3f Hz%s)", _displaySync.GetRefreshRate(),
+                            _displaySync.IsMeasured() ? ", rate does not fit" : ", measuring vsync");
+            }
+            if (_decodeWorker.IsBusy()) {
+                ImGui::TextDisabled("Seeks: decoding on the worker, last job %.1f ms",
+                                    _decodeWorker.GetLastJobSeconds() * 1000.0);
+            } else {
+                ImGui::Text("Seeks: %llu forward, %llu keyframe; decode %.1f ms/frame, seek %.1f ms, refine %.1f ms",
+                            static_cast<unsigned long long>(_decoder->GetForwardSeekCount()),
+                            static_cast<unsigned long long>(_decoder->GetKeyframeSeekCount()),
+                            _decoder->GetDecodeSeconds() * 1000.0, _decoder->GetSeekSeconds() * 1000.0, _refineMs);
+                const PacketCache& cache = _decoder->GetPacketCache();
+                if (_decoder->IsSequence()) {
+                    const ImageSequence& sequence = _decoder->GetImageSequence();
+                    ImGui::Text("Sequence: %d frames, %d ready ahead / %d cached, %d workers",
+                                sequence.GetFrameCount(), sequence.GetReadyAhead(), sequence.GetCapacity(),
+                                sequence.GetActiveWorkers());
+                } else if (cache.IsEnabled()) {
+                    ImGui::Text("Packet cache: %zu / %zu MiB, -%.1fs +%.1fs, %llu hits / %llu misses",
+                                cache.GetBytes() >> 20, cache.GetBudget() >> 20,
+                                cache.GetBehindSeconds(), cache.GetAheadSeconds(),
+                                static_cast<unsigned long long>(cache.GetHits()),
+                                static_cast<unsigned long long>(cache.GetMisses()));
+                } else {
+                    ImGui::TextDisabled("Packet cache: off");
+                }
+            }
+        } else {
+            ImGui::TextDisabled("No video loaded");
+        }
+        
+        ImGui::Separator();
+        const CpuTopology& topology = _threadPlacement.GetTopology();
+        ImGui::Text("CPUs: %d (%d P / %d E), %d package(s), %d node(s)",
+                    topology.GetCpuCount(), topology.GetPerformanceSet().Count(),
+                    topology.GetEfficiencySet().Count(), topology.GetPackageCount(), topology.GetNodeCount());
+        
+        char cpuList[128];
+        for (int i = 0; i < static_cast<int>(ThreadClass::Count); i++) {
+            ThreadClass threadClass = static_cast<ThreadClass>(i);
+            _threadPlacement.GetSet(threadClass).Format(cpuList, sizeof(cpuList));
+            ImGui::Text("%-10s CPUs %s (node %d)", ThreadPlacement::GetClassName(threadClass),
+                        cpuList, _threadPlacement.GetNode(threadClass));
+        }
+        if (!_threadPlacement.GetSettings().enabled) {
+            ImGui::TextDisabled("Thread placement disabled");
+        }
+        
+        ImGui::Separator();
+        if (_resourceLimits.GetCpuQuota() > 0.0) {
+            ImGui::Text("CPU quota: %.2f of %d host CPUs (cgroup %s)", _resourceLimits.GetCpuQuota(),
+                        _resourceLimits.GetHostCpus(), _resourceLimits.GetCgroupVersion());
+        } else {
+            ImGui::Text("CPU quota: none (%d host CPUs)", _resourceLimits.GetHostCpus());
+        }
+        if (_resourceLimits.GetMemoryLimit() > 0) {
+            ImGui::Text("Memory limit: %llu MiB", static_cast<unsigned long long>(_resourceLimits.GetMemoryLimit() >> 20));
+        } else {
+            ImGui::Text("Memory limit: none (%llu MiB host)", static_cast<unsigned long long>(_resourceLimits.GetHostMemory() >> 20));
+        }
+        ImGui::Text("Decoder threads: %d, frame budget %zu MiB, cache budget %zu MiB",
+                    _resourceLimits.GetDecoderThreads(_threadPlacement.GetSet(ThreadClass::Decode).Count()),
+                    _resourceLimits.GetFrameBudget() >> 20, _resourceLimits.GetCacheBudget() >> 20);
+        if (_memoryPressure.IsAvailable()) {
+            ImGui::Text("Memory pressure: %s (some %.1f%%, full %.1f%%), shrink level %d",
+                        MemoryPressureMonitor::GetLevelName(_memoryPressure.GetLevel()),
+                        _memoryPressure.GetSomeAvg10(), _memoryPressure.GetFullAvg10(),
+                        _memoryPressure.GetShrinkLevel());
+        }
+        
+        ImGui::Separator();
+        if (_powerProfile.GetBatteryPercent() >= 0) {
+            ImGui::Text("Power: %s (%s, %s %d%%)", _powerProfile.IsPowerSaving() ? "saving" : "performance",
+                        PowerProfile::GetModeName(_powerProfile.GetSettings().mode),
+                        PowerProfile::GetSourceName(_powerProfile.GetSource()), _powerProfile.GetBatteryPercent());
+        } else {
+            ImGui::Text("Power: %s (%s, %s)", _powerProfile.IsPowerSaving() ? "saving" : "performance",
+                        PowerProfile::GetModeName(_powerProfile.GetSettings().mode),
+                        PowerProfile::GetSourceName(_powerProfile.GetSource()));
+        }
+        ImGui::Text("CPU wakeups: %s%.0f/s, redraws %.0f/s",
+                    _powerProfile.IsWakeupCountAvailable() ? "" : "~",
+                    _powerProfile.GetWakeupsPerSecond(), _powerProfile.GetRedrawsPerSecond());
+        if (_threadStats.IsAvailable()) {
+            ImGui::Separator();
+            ImGui::TextDisabled("%-10s %3s %7s %6s %7s %7s %9s", "Threads", "n", "cpu %", "peak", "vol/s",
+                                "invol/s", _threadStats.HasRunDelay() ? "runq ms/s" : "");
+            for (int i = 0; i < static_cast<int>(ThreadRole::Count); i++) {
+                ThreadRole role = static_cast<ThreadRole>(i);
+                const ThreadRoleStats& stats = _threadStats.GetRole(role);
+                if (stats.threads == 0) continue;
+                if (_threadStats.HasRunDelay()) {
+                    ImGui::Text("%-10s %3d %7.1f %6.1f %7.0f %7.0f %9.1f", ThreadStats::GetRoleName(role),
+                                stats.threads, stats.cpuPercent, stats.peakThreadPercent, stats.voluntaryPerSecond,
+                                stats.involuntaryPerSecond, stats.runDelayMsPerSecond);
+                } else {
+                    ImGui::Text("%-10s %3d %7.1f %6.1f %7.0f %7.0f", ThreadStats::GetRoleName(role),
+                                stats.threads, stats.cpuPercent, stats.peakThreadPercent, stats.voluntaryPerSecond,
+                                stats.involuntaryPerSecond);
+                }
+            }
+        }
+        
+        ImGui::Separator();
+        for (int i = 0; i < static_cast<int>(UserAction::Count); i++) {
+            UserAction action = static_cast<UserAction>(i);
+            LatencySummary summary = _latency.GetSummary(action);
+            if (summary.count == 0) {
+                ImGui::TextDisabled("Latency %-6s no samples", LatencyTracker::GetActionName(action));
+                continue;
+            }
+            ImGui::Text("Latency %-6s p50 %.1f  p95 %.1f  max %.1f ms (%d)", LatencyTracker::GetActionName(action),
+                        summary.p50, summary.p95, summary.max, summary.count);
+            
+            const LatencySample& last = _latency.GetLast(action);
+            char stages[160];
+            int length = 0;
+            for (int s = 0; s < static_cast<int>(LatencyStage::Count) && length < (int)sizeof(stages); s++) {
+                if (last.stages[s] < 0.0f) continue;
+                length += snprintf(stages + length, sizeof(stages) - length, "%s%s %.1f",
+                                   length ? ", " : "", LatencyTracker::GetStageName(static_cast<LatencyStage>(s)),
+                                   last.stages[s]);
+            }
+            ImGui::TextDisabled("  last: %s", length ? stages : "-");
+        }
+        
+        ImGui::Separator();
+        ImGui::Text("Hitches: %llu over %.0f ms, %d dump(s)%s",
+                    static_cast<unsigned long long>(_flightRecorder.GetHitchCount()),
+                    _flightRecorder.GetSettings().hitchThresholdMs, _flightRecorder.GetDumpCount(),
+                    _flightRecorder.GetSettings().enabled ? "" : " (recorder off)");
+        if (_audioDecoder && _audioDecoder->HasAudio()) {
+            ImGui::Text("Audio underruns: %llu", static_cast<unsigned long long>(_audioDecoder->GetUnderrunCount()));
+            ImGui::Text("Audio: %d -> %d Hz (%s), drift %+.1f ms, correction %+.2f%%",
+                        _audioDecoder->GetSourceSampleRate(), _audioDecoder->GetSampleRate(),
+                        _audioDecoder->GetResamplerName(), _audioDecoder->GetDrift() * 1000.0,
+                        _audioDecoder->GetCorrection() * 100.0);
+        }
+        if (_flightRecorder.GetDumpCount() > 0) {
+            ImGui::TextDisabled("  last: %s", _flightRecorder.GetLastDumpPath().c_str());
+        }
+        
+        ImGui::Separator();
+        const StartupProfiler* profiles[2] = { &_coldStart, &_firstFrame };
+        for (const StartupProfiler* profile : profiles) {
+            if (!profile->IsFinished()) continue;
+            ImGui::Text("%s: %.1f ms%s", profile->GetLabel(), profile->GetTotal() * 1000.0,
+                        profile->IsOverBudget() ? " (over budget)" : "");
+            for (int i = 0; i < profile->GetPhaseCount(); i++) {
+                const ProfilePhase& phase = profile->GetPhase(i);
+                ImGui::TextDisabled("  %-24s %7.1f ms", phase.name, phase.seconds * 1000.0);
+            }
+        }
+        
+        if (AllocTracker::ENABLED) {
+            ImGui::Separator();
+            for (int i = 0; i < static_cast<int>(AllocStage::Count); i++) {
+                AllocStage allocStage = static_cast<AllocStage>(i);
+                AllocStats stats = AllocTracker::GetStats(allocStage);
+                ImGui::Text("Allocations %-10s %llu (%llu KiB)", AllocTracker::GetStageName(allocStage),
+                            static_cast<unsigned long long>(stats.count),
+                            static_cast<unsigned long long>(stats.bytes >> 10));
+            }
+            ImGui::Text("Allocating steady-state frames: %llu", static_cast<unsigned long long>(_allocViolations));
+        }
+    }
+    ImGui::End();
+}
+
 /* Audio UI removed; audio tracks are available under the main Audio->Tracks menu */
 
 } // namespace tvk_media
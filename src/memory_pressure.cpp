@@ -0,0 +1,158 @@
+#include "memory_pressure.h"
+#include <tinyvk/core/log.h>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace tvk_media {
+
+static constexpr float MODERATE_SOME_AVG10 = 10.0f;
+static constexpr float SEVERE_SOME_AVG10 = 40.0f;
+static constexpr float SEVERE_FULL_AVG10 = 5.0f;
+
+MemoryPressureMonitor::MemoryPressureMonitor()
+    : _psiAvailable(false)
+    , _eventsAvailable(false)
+    , _someAvg10(0.0f)
+    , _fullAvg10(0.0f)
+    , _lastHighEvents(0)
+    , _lastMaxEvents(0)
+    , _level(PressureLevel::None)
+    , _shrinkLevel(0)
+    , _lastPoll(-1.0)
+    , _calmSince(0.0)
+{
+    _eventsPath[0] = '\0';
+}
+
+const char* MemoryPressureMonitor::GetLevelName(PressureLevel level) {
+    switch (level) {
+        case PressureLevel::None: return "none";
+        case PressureLevel::Moderate: return "moderate";
+        case PressureLevel::Severe: return "severe";
+        default: return "unknown";
+    }
+}
+
+void MemoryPressureMonitor::Init(const char* cgroupDirectory) {
+    _psiAvailable = ReadPsi();
+
+    if (cgroupDirectory && cgroupDirectory[0]) {
+        snprintf(_eventsPath, sizeof(_eventsPath), "%s/memory.events", cgroupDirectory);
+        _eventsAvailable = ReadEvents(_lastHighEvents, _lastMaxEvents);
+    }
+
+    TVK_LOG_INFO("Memory pressure monitor: PSI {}, cgroup events {}",
+                 _psiAvailable ? "available" : "unavailable",
+                 _eventsAvailable ? "available" : "unavailable");
+}
+
+bool MemoryPressureMonitor::ReadPsi() {
+    FILE* file = fopen("/proc/pressure/memory", "r");
+    if (!file) return false;
+
+    char line[256];
+    bool parsed = false;
+    while (fgets(line, sizeof(line), file)) {
+        float avg10 = 0.0f;
+        if (sscanf(line, "some avg10=%f", &avg10) == 1) {
+            _someAvg10 = avg10;
+            parsed = true;
+        } else if (sscanf(line, "full avg10=%f", &avg10) == 1) {
+            _fullAvg10 = avg10;
+        }
+    }
+
+    fclose(file);
+    return parsed;
+}
+
+bool MemoryPressureMonitor::ReadEvents(uint64_t& high, uint64_t& max) {
+    FILE* file = fopen(_eventsPath, "r");
+    if (!file) return false;
+
+    char line[128];
+    unsigned long long value = 0;
+    while (fgets(line, sizeof(line), file)) {
+        if (sscanf(line, "high %llu", &value) == 1) {
+            high = value;
+        } else if (sscanf(line, "max %llu", &value) == 1) {
+            max = value;
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+bool MemoryPressureMonitor::Update(double now) {
+    if (!IsAvailable()) return false;
+    if (_lastPoll >= 0.0 && now - _lastPoll < POLL_INTERVAL) return false;
+    _lastPoll = now;
+
+    PressureLevel level = PressureLevel::None;
+
+    if (_psiAvailable && ReadPsi()) {
+        if (_fullAvg10 >= SEVERE_FULL_AVG10 || _someAvg10 >= SEVERE_SOME_AVG10) {
+            level = PressureLevel::Severe;
+        } else if (_someAvg10 >= MODERATE_SOME_AVG10) {
+            level = PressureLevel::Moderate;
+        }
+    }
+
+    if (_eventsAvailable) {
+        uint64_t high = _lastHighEvents;
+        uint64_t max = _lastMaxEvents;
+        if (ReadEvents(high, max)) {
+            if (max > _lastMaxEvents) {
+                level = PressureLevel::Severe;
+            } else if (high > _lastHighEvents && level == PressureLevel::None) {
+                level = PressureLevel::Moderate;
+            }
+            _lastHighEvents = high;
+            _lastMaxEvents = max;
+        }
+    }
+
+    _level = level;
+    int previous = _shrinkLevel;
+
+    if (level != PressureLevel::None) {
+        _shrinkLevel += level == PressureLevel::Severe ? 2 : 1;
+        if (_shrinkLevel > MAX_SHRINK_LEVEL) _shrinkLevel = MAX_SHRINK_LEVEL;
+        _calmSince = now;
+    } else if (_shrinkLevel > 0 && now - _calmSince >= RECOVERY_DELAY) {
+        _shrinkLevel--;
+        _calmSince = now;
+    }
+
+    if (_shrinkLevel != previous) {
+        TVK_LOG_INFO("Memory pressure {}: cache shrink level {} -> {}",
+                     GetLevelName(level), previous, _shrinkLevel);
+        return true;
+    }
+    return false;
+}
+
+int MemoryPressureMonitor::ScaleCapacity(int capacity) const {
+    if (_shrinkLevel >= MAX_SHRINK_LEVEL) return 1;
+
+    int scaled = capacity >> _shrinkLevel;
+    return scaled < 1 ? 1 : scaled;
+}
+
+size_t MemoryPressureMonitor::ScaleBudget(size_t bytes) const {
+    if (_shrinkLevel >= MAX_SHRINK_LEVEL) return 0;
+    return bytes >> _shrinkLevel;
+}
+
+void MemoryPressureMonitor::ReleaseFreeMemory() {
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
+
+} // namespace tvk_media
@@ -0,0 +1,159 @@
+#include "packet_cache.h"
+
+namespace tvk_media {
+
+static int64_t GetPacketTimestamp(const AVPacket* packet) {
+    return packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+}
+
+PacketCache::PacketCache()
+    : _timeBase(AVRational{ 1, 1 })
+    , _cursor(0)
+    , _bytes(0)
+    , _budget(0)
+    , _hits(0)
+    , _misses(0)
+    , _atEnd(false)
+    , _detached(false)
+{
+}
+
+PacketCache::~PacketCache() {
+    Clear();
+    for (AVPacket* packet : _spare) {
+        av_packet_free(&packet);
+    }
+}
+
+void PacketCache::SetBudget(size_t bytes) {
+    _budget = bytes;
+    Trim(bytes);
+}
+
+void PacketCache::Trim(size_t bytes) {
+    while (_bytes > bytes && _cursor > 0) {
+        EvictFront();
+    }
+}
+
+void PacketCache::Clear() {
+    while (!_entries.empty()) {
+        EvictFront();
+    }
+    _cursor = 0;
+    _bytes = 0;
+    _atEnd = false;
+    _detached = false;
+}
+
+void PacketCache::EvictFront() {
+    Entry& entry = _entries.front();
+    _bytes -= static_cast<size_t>(entry.packet->size) + sizeof(AVPacket);
+    av_packet_unref(entry.packet);
+    _spare.push_back(entry.packet);
+    _entries.pop_front();
+    if (_cursor > 0) _cursor--;
+}
+
+bool PacketCache::Read(AVPacket* out) {
+    if (_detached || _cursor >= _entries.size()) return false;
+    if (av_packet_ref(out, _entries[_cursor].packet) < 0) return false;
+    _cursor++;
+    return true;
+}
+
+void PacketCache::Append(const AVPacket* packet) {
+    if (_budget == 0 || _detached || _cursor != _entries.size()) return;
+
+    AVPacket* copy = nullptr;
+    if (!_spare.empty()) {
+        copy = _spare.back();
+        _spare.pop_back();
+    } else {
+        copy = av_packet_alloc();
+        if (!copy) return;
+    }
+    if (av_packet_ref(copy, packet) < 0) {
+        _spare.push_back(copy);
+        return;
+    }
+
+    Entry entry;
+    entry.packet = copy;
+    entry.timestamp = GetPacketTimestamp(packet);
+    entry.keyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0 && entry.timestamp != AV_NOPTS_VALUE;
+    _entries.push_back(entry);
+    _bytes += static_cast<size_t>(packet->size) + sizeof(AVPacket);
+    _cursor = _entries.size();
+
+    Trim(_budget);
+}
+
+bool PacketCache::Seek(int64_t timestamp) {
+    if (_entries.empty()) {
+        _misses++;
+        return false;
+    }
+
+    int64_t last = AV_NOPTS_VALUE;
+    for (size_t i = _entries.size(); i-- > 0;) {
+        if (_entries[i].timestamp != AV_NOPTS_VALUE) {
+            last = _entries[i].timestamp;
+            break;
+        }
+    }
+    if (last == AV_NOPTS_VALUE || (timestamp > last && !_atEnd)) {
+        _misses++;
+        return false;
+    }
+
+    size_t index = FindKeyframeIndex(timestamp);
+    if (index == _entries.size()) {
+        _misses++;
+        return false;
+    }
+
+    _cursor = index;
+    _detached = false;
+    _hits++;
+    return true;
+}
+
+size_t PacketCache::FindKeyframeIndex(int64_t timestamp) const {
+    for (size_t i = _entries.size(); i-- > 0;) {
+        if (_entries[i].keyframe && _entries[i].timestamp <= timestamp) return i;
+    }
+    return _entries.size();
+}
+
+bool PacketCache::FindKeyframe(int64_t timestamp, int64_t& out) const {
+    size_t index = FindKeyframeIndex(timestamp);
+    if (index == _entries.size()) return false;
+    out = _entries[index].timestamp;
+    return true;
+}
+
+int64_t PacketCache::GetEndDts() const {
+    return _entries.empty() ? AV_NOPTS_VALUE : _entries.back().packet->dts;
+}
+
+double PacketCache::GetBehindSeconds() const {
+    if (_entries.empty()) return 0.0;
+
+    size_t current = _cursor < _entries.size() ? _cursor : _entries.size() - 1;
+    for (const Entry& entry : _entries) {
+        if (!entry.keyframe) continue;
+        int64_t span = _entries[current].timestamp - entry.timestamp;
+        return span > 0 ? span * av_q2d(_timeBase) : 0.0;
+    }
+    return 0.0;
+}
+
+double PacketCache::GetAheadSeconds() const {
+    if (_cursor >= _entries.size()) return 0.0;
+
+    int64_t span = _entries.back().timestamp - _entries[_cursor].timestamp;
+    return span > 0 ? span * av_q2d(_timeBase) : 0.0;
+}
+
+} // namespace tvk_media
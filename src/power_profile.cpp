@@ -0,0 +1,206 @@
+#include "power_profile.h"
+#include "text_file.h"
+#include <tinyvk/core/log.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__)
+#include <dirent.h>
+#endif
+
+namespace tvk_media {
+
+#if defined(__linux__)
+static const char* POWER_SUPPLY_ROOT = "/sys/class/power_supply";
+
+static bool ReadSupplyAttribute(const char* supply, const char* attribute, char* buffer, size_t size) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s/%s", POWER_SUPPLY_ROOT, supply, attribute);
+    return ReadTextFile(path, buffer, size);
+}
+#endif
+
+PowerProfile::PowerProfile()
+    : _source(PowerSource::Unknown)
+    , _batteryPercent(-1)
+    , _powerSaving(false)
+    , _wakeupsAvailable(false)
+    , _lastSwitches(0)
+    , _redraws(0)
+    , _wakeupsPerSecond(0.0)
+    , _redrawsPerSecond(0.0)
+    , _lastSourcePoll(-1.0)
+    , _lastSample(-1.0)
+{
+}
+
+const char* PowerProfile::GetModeName(PowerMode mode) {
+    switch (mode) {
+        case PowerMode::Auto: return "auto";
+        case PowerMode::Performance: return "performance";
+        case PowerMode::PowerSaver: return "power saver";
+        default: return "unknown";
+    }
+}
+
+const char* PowerProfile::GetSourceName(PowerSource source) {
+    switch (source) {
+        case PowerSource::Mains: return "AC power";
+        case PowerSource::Battery: return "battery";
+        default: return "unknown";
+    }
+}
+
+void PowerProfile::Init() {
+    ReadPowerSupply();
+    _wakeupsAvailable = ReadContextSwitches(_lastSwitches);
+    _powerSaving = _settings.mode == PowerMode::PowerSaver ||
+                   (_settings.mode == PowerMode::Auto && _source == PowerSource::Battery);
+
+    TVK_LOG_INFO("Power profile: {} on {}, {}", GetModeName(_settings.mode), GetSourceName(_source),
+                 _powerSaving ? "power saving" : "full performance");
+}
+
+void PowerProfile::ReadPowerSupply() {
+#if defined(__linux__)
+    DIR* dir = opendir(POWER_SUPPLY_ROOT);
+    if (!dir) {
+        _source = PowerSource::Unknown;
+        return;
+    }
+
+    bool mainsOnline = false;
+    bool battery = false;
+    bool discharging = false;
+    int percent = -1;
+
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') continue;
+
+        char value[64];
+        if (!ReadSupplyAttribute(entry->d_name, "type", value, sizeof(value))) continue;
+
+        if (strcmp(value, "Mains") == 0 || strncmp(value, "USB", 3) == 0) {
+            if (ReadSupplyAttribute(entry->d_name, "online", value, sizeof(value)) && atoi(value) == 1) {
+                mainsOnline = true;
+            }
+        } else if (strcmp(value, "Battery") == 0) {
+            if (ReadSupplyAttribute(entry->d_name, "scope", value, sizeof(value)) &&
+                strcmp(value, "Device") == 0) {
+                continue;
+            }
+            battery = true;
+            if (ReadSupplyAttribute(entry->d_name, "status", value, sizeof(value)) &&
+                strcmp(value, "Discharging") == 0) {
+                discharging = true;
+            }
+            if (ReadSupplyAttribute(entry->d_name, "capacity", value, sizeof(value))) {
+                percent = atoi(value);
+            }
+        }
+    }
+    closedir(dir);
+
+    if (mainsOnline) {
+        _source = PowerSource::Mains;
+    } else if (discharging) {
+        _source = PowerSource::Battery;
+    } else if (battery) {
+        _source = PowerSource::Mains;
+    } else {
+        _source = PowerSource::Unknown;
+    }
+    _batteryPercent = battery ? percent : -1;
+#else
+    _source = PowerSource::Unknown;
+    _batteryPercent = -1;
+#endif
+}
+
+bool PowerProfile::ReadContextSwitches(uint64_t& switches) {
+#if defined(__linux__)
+    DIR* dir = opendir("/proc/self/task");
+    if (!dir) return false;
+
+    uint64_t total = 0;
+    bool found = false;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') continue;
+
+        char path[128];
+        snprintf(path, sizeof(path), "/proc/self/task/%s/status", entry->d_name);
+        FILE* file = fopen(path, "r");
+        if (!file) continue;
+
+        char line[128];
+        unsigned long long value = 0;
+        while (fgets(line, sizeof(line), file)) {
+            if (sscanf(line, "voluntary_ctxt_switches: %llu", &value) == 1) {
+                total += value;
+                found = true;
+                break;
+            }
+        }
+        fclose(file);
+    }
+    closedir(dir);
+
+    switches = total;
+    return found;
+#else
+    (void)switches;
+    return false;
+#endif
+}
+
+bool PowerProfile::Update(double now) {
+    _redraws++;
+
+    if (_lastSourcePoll < 0.0 || now - _lastSourcePoll >= SOURCE_POLL_INTERVAL) {
+        ReadPowerSupply();
+        _lastSourcePoll = now;
+    }
+
+    if (_lastSample < 0.0) {
+        _lastSample = now;
+        _redraws = 0;
+    } else if (now - _lastSample >= SAMPLE_INTERVAL) {
+        double elapsed = now - _lastSample;
+        _redrawsPerSecond = static_cast<double>(_redraws) / elapsed;
+        _redraws = 0;
+
+        uint64_t switches = 0;
+        if (_wakeupsAvailable && ReadContextSwitches(switches)) {
+            _wakeupsPerSecond = switches > _lastSwitches
+                ? static_cast<double>(switches - _lastSwitches) / elapsed : 0.0;
+            _lastSwitches = switches;
+        } else {
+            _wakeupsPerSecond = _redrawsPerSecond;
+        }
+        _lastSample = now;
+    }
+
+    bool saving = _settings.mode == PowerMode::PowerSaver ||
+                  (_settings.mode == PowerMode::Auto && _source == PowerSource::Battery);
+    if (saving == _powerSaving) return false;
+
+    _powerSaving = saving;
+    TVK_LOG_INFO("Power profile: switched to {} ({} on {})", saving ? "power saving" : "full performance",
+                 GetModeName(_settings.mode), GetSourceName(_source));
+    return true;
+}
+
+int PowerProfile::CapDecoderThreads(int threads) const {
+    if (!_powerSaving) return threads;
+    int cap = _settings.maxDecoderThreads > 0 ? _settings.maxDecoderThreads : 1;
+    return threads < cap ? threads : cap;
+}
+
+uint32_t PowerProfile::ScaleUpscaleSize(uint32_t size) const {
+    if (!_powerSaving) return size;
+    uint32_t scaled = static_cast<uint32_t>(static_cast<float>(size) * _settings.upscaleScale);
+    return scaled > 0 ? scaled : 1;
+}
+
+} // namespace tvk_media
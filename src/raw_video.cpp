@@ -0,0 +1,379 @@
+#include "raw_video.h"
+#include <tinyvk/core/log.h>
+#include <algorithm>
+#include <cstring>
+
+extern "C" {
+#include <libavutil/imgutils.h>
+}
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tvk_media {
+
+static constexpr size_t Y4M_MAX_FRAME_HEADER = 256;
+static constexpr size_t AVI_CHUNK_HEADER = 8;
+
+static uint32_t ReadLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static void UnpackV210Row(const uint8_t* src, int width, uint16_t* y, uint16_t* u, uint16_t* v) {
+    uint16_t c[12];
+    for (int x = 0; x < width; x += 6) {
+        for (int w = 0; w < 4; w++) {
+            uint32_t word = ReadLE32(src + w * 4);
+            c[w * 3] = word & 0x3FF;
+            c[w * 3 + 1] = (word >> 10) & 0x3FF;
+            c[w * 3 + 2] = (word >> 20) & 0x3FF;
+        }
+        src += 16;
+
+        int count = std::min(6, width - x);
+        for (int i = 0; i < count; i++) {
+            y[x + i] = c[i * 2 + 1];
+        }
+        for (int k = 0; k < (count + 1) / 2; k++) {
+            u[x / 2 + k] = c[k * 4];
+            v[x / 2 + k] = c[k * 4 + 2];
+        }
+    }
+}
+
+RawVideoFile::RawVideoFile()
+    : _base(nullptr)
+    , _fileSize(0)
+#if defined(_WIN32)
+    , _file(INVALID_HANDLE_VALUE)
+    , _mapping(nullptr)
+#else
+    , _file(-1)
+#endif
+    , _format(RawFormat::None)
+    , _width(0)
+    , _height(0)
+    , _fps(0.0)
+    , _frameSize(0)
+    , _prefetched(-1)
+{
+}
+
+RawVideoFile::~RawVideoFile() {
+    Close();
+}
+
+RawFormat RawVideoFile::GetFormat(const AVCodecParameters* params) {
+    if (params->codec_id == AV_CODEC_ID_V210) return RawFormat::V210;
+    if (params->codec_id != AV_CODEC_ID_RAWVIDEO) return RawFormat::None;
+
+    switch (static_cast<AVPixelFormat>(params->format)) {
+        case AV_PIX_FMT_UYVY422: return RawFormat::UYVY;
+        case AV_PIX_FMT_YUYV422: return RawFormat::YUYV;
+        case AV_PIX_FMT_YUV420P: return RawFormat::YUV420P;
+        case AV_PIX_FMT_YUV420P10LE: return RawFormat::YUV420P10;
+        case AV_PIX_FMT_RGB24: return RawFormat::RGB24;
+        case AV_PIX_FMT_RGBA: return RawFormat::RGBA;
+        case AV_PIX_FMT_BGRA: return RawFormat::BGRA;
+        default: return RawFormat::None;
+    }
+}
+
+const char* RawVideoFile::GetFormatName(RawFormat format) {
+    switch (format) {
+        case RawFormat::V210: return "v210";
+        case RawFormat::UYVY: return "uyvy422";
+        case RawFormat::YUYV: return "yuyv422";
+        case RawFormat::YUV420P: return "yuv420p";
+        case RawFormat::YUV420P10: return "yuv420p10le";
+        case RawFormat::RGB24: return "rgb24";
+        case RawFormat::RGBA: return "rgba";
+        case RawFormat::BGRA: return "bgra";
+        default: return "none";
+    }
+}
+
+AVPixelFormat RawVideoFile::GetPlaneFormat() const {
+    switch (_format) {
+        case RawFormat::V210: return AV_PIX_FMT_YUV422P10LE;
+        case RawFormat::UYVY: return AV_PIX_FMT_UYVY422;
+        case RawFormat::YUYV: return AV_PIX_FMT_YUYV422;
+        case RawFormat::YUV420P: return AV_PIX_FMT_YUV420P;
+        case RawFormat::YUV420P10: return AV_PIX_FMT_YUV420P10LE;
+        case RawFormat::RGB24: return AV_PIX_FMT_RGB24;
+        case RawFormat::RGBA: return AV_PIX_FMT_RGBA;
+        case RawFormat::BGRA: return AV_PIX_FMT_BGRA;
+        default: return AV_PIX_FMT_NONE;
+    }
+}
+
+bool RawVideoFile::Open(const std::string& path, AVFormatContext* formatContext, AVStream* stream, RawFormat format) {
+    Close();
+    if (format == RawFormat::None) return false;
+
+    const char* container = formatContext->iformat ? formatContext->iformat->name : "";
+    bool rgb = format == RawFormat::RGB24 || format == RawFormat::RGBA || format == RawFormat::BGRA;
+    if (rgb && strcmp(container, "avi") == 0) return false;
+
+    const AVCodecParameters* params = stream->codecpar;
+    int width = params->width;
+    int height = params->height;
+    if (width <= 0 || height <= 0) return false;
+
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    RawFrame layout;
+    layout.format = format;
+    layout.bt709 = params->color_space == AVCOL_SPC_BT709 ||
+                   (params->color_space == AVCOL_SPC_UNSPECIFIED && height > 576);
+
+    switch (format) {
+        case RawFormat::V210:
+            layout.pitch = (width + 47) / 48 * 128;
+            layout.size = static_cast<size_t>(layout.pitch) * height;
+            break;
+        case RawFormat::UYVY:
+        case RawFormat::YUYV:
+            layout.pitch = chromaWidth * 4;
+            layout.size = static_cast<size_t>(layout.pitch) * height;
+            break;
+        case RawFormat::YUV420P:
+        case RawFormat::YUV420P10: {
+            int bytes = format == RawFormat::YUV420P10 ? 2 : 1;
+            layout.pitch = width * bytes;
+            layout.chromaPitch = chromaWidth * bytes;
+            layout.chromaOffset = layout.pitch * height;
+            layout.crOffset = layout.chromaOffset + layout.chromaPitch * chromaHeight;
+            layout.size = static_cast<size_t>(layout.crOffset) + static_cast<size_t>(layout.chromaPitch) * chromaHeight;
+            break;
+        }
+        case RawFormat::RGB24:
+            layout.pitch = width * 3;
+            layout.size = static_cast<size_t>(layout.pitch) * height;
+            break;
+        default:
+            layout.pitch = width * 4;
+            layout.size = static_cast<size_t>(layout.pitch) * height;
+            break;
+    }
+
+    _format = format;
+    _width = width;
+    _height = height;
+    _layout = layout;
+    _frameSize = layout.size;
+    if (stream->avg_frame_rate.num > 0 && stream->avg_frame_rate.den > 0) {
+        _fps = av_q2d(stream->avg_frame_rate);
+    } else if (stream->r_frame_rate.num > 0 && stream->r_frame_rate.den > 0) {
+        _fps = av_q2d(stream->r_frame_rate);
+    } else {
+        _fps = 25.0;
+    }
+
+    if (!Map(path)) {
+        Close();
+        return false;
+    }
+
+    bool indexed;
+    if (strcmp(container, "yuv4mpegpipe") == 0) {
+        indexed = IndexY4M();
+    } else if (strcmp(container, "rawvideo") == 0 || strcmp(container, "v210") == 0 ||
+               strcmp(container, "v210x") == 0) {
+        indexed = IndexFixed();
+    } else {
+        indexed = IndexStream(stream, strcmp(container, "avi") == 0 ? AVI_CHUNK_HEADER : 0);
+    }
+
+    if (!indexed || _offsets.empty()) {
+        Close();
+        return false;
+    }
+
+    TVK_LOG_INFO("Raw video: {} frames of {} {}x{} ({} KiB each) mapped from {}", _offsets.size(),
+                 GetFormatName(_format), _width, _height, _frameSize >> 10, container);
+    return true;
+}
+
+void RawVideoFile::Close() {
+    Unmap();
+    _offsets.clear();
+    _times.clear();
+    std::vector<uint16_t>().swap(_unpacked);
+    _format = RawFormat::None;
+    _layout = RawFrame();
+    _frameSize = 0;
+    _prefetched = -1;
+}
+
+bool RawVideoFile::Map(const std::string& path) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    _file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) return false;
+    _fileSize = static_cast<size_t>(size.QuadPart);
+
+    _mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!_mapping) return false;
+    _base = static_cast<const uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+    return _base != nullptr;
+#else
+    _file = open(path.c_str(), O_RDONLY);
+    if (_file < 0) return false;
+
+    struct stat info;
+    if (fstat(_file, &info) != 0 || info.st_size <= 0) return false;
+    _fileSize = static_cast<size_t>(info.st_size);
+
+    void* base = mmap(nullptr, _fileSize, PROT_READ, MAP_SHARED, _file, 0);
+    if (base == MAP_FAILED) return false;
+    madvise(base, _fileSize, MADV_SEQUENTIAL);
+    _base = static_cast<const uint8_t*>(base);
+    return true;
+#endif
+}
+
+void RawVideoFile::Unmap() {
+#if defined(_WIN32)
+    if (_base) UnmapViewOfFile(_base);
+    if (_mapping) CloseHandle(_mapping);
+    if (_file != INVALID_HANDLE_VALUE) CloseHandle(_file);
+    _mapping = nullptr;
+    _file = INVALID_HANDLE_VALUE;
+#else
+    if (_base) munmap(const_cast<uint8_t*>(_base), _fileSize);
+    if (_file >= 0) close(_file);
+    _file = -1;
+#endif
+    _base = nullptr;
+    _fileSize = 0;
+}
+
+bool RawVideoFile::IndexY4M() {
+    const uint8_t* end = _base + _fileSize;
+    const uint8_t* p = static_cast<const uint8_t*>(memchr(_base, '\n', _fileSize));
+    if (!p) return false;
+    p++;
+
+    while (static_cast<size_t>(end - p) > 5 && memcmp(p, "FRAME", 5) == 0) {
+        size_t window = std::min(static_cast<size_t>(end - p), Y4M_MAX_FRAME_HEADER);
+        const uint8_t* line = static_cast<const uint8_t*>(memchr(p, '\n', window));
+        if (!line) break;
+        size_t offset = static_cast<size_t>(line + 1 - _base);
+        if (offset + _frameSize > _fileSize) break;
+
+        _times.push_back(_offsets.size() / _fps);
+        _offsets.push_back(offset);
+        p = line + 1 + _frameSize;
+    }
+    return true;
+}
+
+bool RawVideoFile::IndexFixed() {
+    size_t count = _fileSize / _frameSize;
+    _offsets.reserve(count);
+    _times.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        _offsets.push_back(i * _frameSize);
+        _times.push_back(i / _fps);
+    }
+    return true;
+}
+
+bool RawVideoFile::IndexStream(AVStream* stream, size_t headerSize) {
+    int count = avformat_index_get_entries_count(stream);
+    if (count <= 0 || (stream->nb_frames > 0 && count < stream->nb_frames)) return false;
+
+    double timeBase = av_q2d(stream->time_base);
+    _offsets.reserve(count);
+    _times.reserve(count);
+    for (int i = 0; i < count; i++) {
+        const AVIndexEntry* entry = avformat_index_get_entry(stream, i);
+        if (!entry || entry->pos < 0 || static_cast<size_t>(entry->size) != _frameSize) return false;
+        size_t offset = static_cast<size_t>(entry->pos) + headerSize;
+        if (offset + _frameSize > _fileSize) return false;
+        if (!_times.empty() && entry->timestamp * timeBase < _times.back()) return false;
+
+        _offsets.push_back(offset);
+        _times.push_back(entry->timestamp * timeBase);
+    }
+    return true;
+}
+
+void RawVideoFile::Prefetch(int index) {
+#if !defined(_WIN32)
+    int last = std::min(index + PREFETCH_FRAMES, GetFrameCount() - 1);
+    int first = _prefetched >= index && _prefetched <= last ? _prefetched + 1 : index + 1;
+    if (first > last) return;
+
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t start = _offsets[first] / pageSize * pageSize;
+    size_t end = _offsets[last] + _frameSize;
+    madvise(const_cast<uint8_t*>(_base) + start, end - start, MADV_WILLNEED);
+#endif
+    _prefetched = std::min(index + PREFETCH_FRAMES, GetFrameCount() - 1);
+}
+
+bool RawVideoFile::GetFrame(int index, RawFrame& out) {
+    if (!_base || index < 0 || index >= GetFrameCount()) return false;
+
+    out = _layout;
+    out.data = _base + _offsets[index];
+    Prefetch(index);
+    return true;
+}
+
+bool RawVideoFile::GetPlanes(const RawFrame& frame, uint8_t* data[4], int linesize[4]) {
+    if (!frame.data) return false;
+
+    if (frame.format != RawFormat::V210) {
+        return av_image_fill_arrays(data, linesize, frame.data, GetPlaneFormat(), _width, _height, 1) >= 0;
+    }
+
+    int chromaWidth = (_width + 1) / 2;
+    size_t lumaSize = static_cast<size_t>(_width) * _height;
+    size_t chromaSize = static_cast<size_t>(chromaWidth) * _height;
+    _unpacked.resize(lumaSize + chromaSize * 2);
+
+    uint16_t* y = _unpacked.data();
+    uint16_t* u = y + lumaSize;
+    uint16_t* v = u + chromaSize;
+    for (int row = 0; row < _height; row++) {
+        UnpackV210Row(frame.data + static_cast<size_t>(row) * frame.pitch, _width,
+                      y + static_cast<size_t>(row) * _width,
+                      u + static_cast<size_t>(row) * chromaWidth,
+                      v + static_cast<size_t>(row) * chromaWidth);
+    }
+
+    data[0] = reinterpret_cast<uint8_t*>(y);
+    data[1] = reinterpret_cast<uint8_t*>(u);
+    data[2] = reinterpret_cast<uint8_t*>(v);
+    data[3] = nullptr;
+    linesize[0] = _width * 2;
+    linesize[1] = chromaWidth * 2;
+    linesize[2] = chromaWidth * 2;
+    linesize[3] = 0;
+    return true;
+}
+
+int RawVideoFile::FindFrame(double timeSeconds) const {
+    if (_times.empty()) return -1;
+    auto it = std::upper_bound(_times.begin(), _times.end(), timeSeconds);
+    int index = static_cast<int>(it - _times.begin()) - 1;
+    return std::max(index, 0);
+}
+
+} // namespace tvk_media
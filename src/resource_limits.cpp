@@ -0,0 +1,232 @@
+#include "resource_limits.h"
+#include "text_file.h"
+#include <tinyvk/core/log.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace tvk_media {
+
+static bool ReadLimit(const char* path, uint64_t& value) {
+    char buffer[64];
+    if (!ReadTextFile(path, buffer, sizeof(buffer)) || strncmp(buffer, "max", 3) == 0) return false;
+
+    char* end = nullptr;
+    unsigned long long parsed = strtoull(buffer, &end, 10);
+    if (end == buffer) return false;
+
+    value = static_cast<uint64_t>(parsed);
+    return true;
+}
+
+static bool FindCgroup2Mount(char* mount, size_t size) {
+    FILE* file = fopen("/proc/self/mounts", "r");
+    if (!file) return false;
+
+    char line[512];
+    bool found = false;
+    while (!found && fgets(line, sizeof(line), file)) {
+        char device[128];
+        char point[256];
+        char type[64];
+        if (sscanf(line, "%127s %255s %63s", device, point, type) == 3 && strcmp(type, "cgroup2") == 0) {
+            snprintf(mount, size, "%s", point);
+            found = true;
+        }
+    }
+
+    fclose(file);
+    return found;
+}
+
+ResourceLimits::ResourceLimits()
+    : _hostCpus(1)
+    , _affinityCpus(1)
+    , _cpuQuota(0.0)
+    , _effectiveCpus(1)
+    , _hostMemory(0)
+    , _memoryLimit(0)
+    , _cgroupVersion("none")
+{
+    _cgroupPath[0] = '\0';
+    _cgroupDirectory[0] = '\0';
+}
+
+void ResourceLimits::Detect() {
+    _hostCpus = static_cast<int>(std::thread::hardware_concurrency());
+    if (_hostCpus <= 0) _hostCpus = 1;
+    _affinityCpus = _hostCpus;
+    _cpuQuota = 0.0;
+    _memoryLimit = 0;
+    _cgroupVersion = "none";
+    _cgroupPath[0] = '\0';
+    _cgroupDirectory[0] = '\0';
+
+#if defined(__linux__)
+    cpu_set_t mask;
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        _affinityCpus = CPU_COUNT(&mask);
+    }
+
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && pageSize > 0) {
+        _hostMemory = static_cast<uint64_t>(pages) * static_cast<uint64_t>(pageSize);
+    }
+
+    FILE* file = fopen("/proc/self/cgroup", "r");
+    if (file) {
+        char line[512];
+        char v1Memory[256] = "";
+        char v1Cpu[256] = "";
+        char v2Path[256] = "";
+        bool hasV2 = false;
+
+        while (fgets(line, sizeof(line), file)) {
+            line[strcspn(line, "\n")] = '\0';
+            char* controllers = strchr(line, ':');
+            if (!controllers) continue;
+            char* path = strchr(controllers + 1, ':');
+            if (!path) continue;
+            *path++ = '\0';
+            controllers++;
+
+            if (strncmp(line, "0", 1) == 0 && controllers[0] == '\0') {
+                snprintf(v2Path, sizeof(v2Path), "%s", path);
+                hasV2 = true;
+            } else if (strstr(controllers, "memory")) {
+                snprintf(v1Memory, sizeof(v1Memory), "%s", path);
+            } else if (strstr(controllers, "cpu") && !strstr(controllers, "cpuset") && !v1Cpu[0]) {
+                snprintf(v1Cpu, sizeof(v1Cpu), "%s", path);
+            }
+        }
+        fclose(file);
+
+        char mount[256];
+        if (hasV2 && FindCgroup2Mount(mount, sizeof(mount))) {
+            DetectCgroupV2(mount, v2Path);
+        }
+        if (_cpuQuota == 0.0 && _memoryLimit == 0 && (v1Memory[0] || v1Cpu[0])) {
+            DetectCgroupV1(v1Cpu);
+
+            char limitPath[512];
+            uint64_t value = 0;
+            snprintf(limitPath, sizeof(limitPath), "/sys/fs/cgroup/memory%s/memory.limit_in_bytes", v1Memory);
+            if (ReadLimit(limitPath, value) && value < (1ull << 60)) {
+                _memoryLimit = value;
+                _cgroupVersion = "v1";
+                snprintf(_cgroupPath, sizeof(_cgroupPath), "%s", v1Memory);
+            }
+        }
+    }
+#endif
+
+    _effectiveCpus = _affinityCpus;
+    if (_cpuQuota > 0.0) {
+        int quotaCpus = static_cast<int>(std::ceil(_cpuQuota - 0.01));
+        if (quotaCpus < 1) quotaCpus = 1;
+        if (quotaCpus < _effectiveCpus) _effectiveCpus = quotaCpus;
+    }
+
+    TVK_LOG_INFO("Resource limits: {} host CPUs, {} in affinity, quota {:.2f}, {} effective; memory limit {} MiB (cgroup {})",
+                 _hostCpus, _affinityCpus, _cpuQuota, _effectiveCpus,
+                 _memoryLimit / (1024 * 1024), _cgroupVersion);
+}
+
+void ResourceLimits::DetectCgroupV2(const char* mount, const char* path) {
+    char current[256];
+    snprintf(current, sizeof(current), "%s", path);
+
+    while (true) {
+        char file[640];
+        char buffer[128];
+
+        snprintf(file, sizeof(file), "%s%s/cpu.max", mount, current);
+        if (ReadTextFile(file, buffer, sizeof(buffer)) && strncmp(buffer, "max", 3) != 0) {
+            double quota = 0.0;
+            double period = 0.0;
+            if (sscanf(buffer, "%lf %lf", &quota, &period) == 2 && quota > 0.0 && period > 0.0) {
+                double cpus = quota / period;
+                if (_cpuQuota == 0.0 || cpus < _cpuQuota) _cpuQuota = cpus;
+            }
+        }
+
+        uint64_t value = 0;
+        snprintf(file, sizeof(file), "%s%s/memory.max", mount, current);
+        if (ReadLimit(file, value) && (_memoryLimit == 0 || value < _memoryLimit)) {
+            _memoryLimit = value;
+        }
+
+        char* slash = strrchr(current, '/');
+        if (!slash || current[1] == '\0') break;
+        if (slash == current) {
+            current[1] = '\0';
+        } else {
+            *slash = '\0';
+        }
+    }
+
+    _cgroupVersion = "v2";
+    snprintf(_cgroupPath, sizeof(_cgroupPath), "%s", path);
+    snprintf(_cgroupDirectory, sizeof(_cgroupDirectory), "%s%s", mount, strcmp(path, "/") == 0 ? "" : path);
+}
+
+void ResourceLimits::DetectCgroupV1(const char* path) {
+    char file[512];
+    uint64_t quota = 0;
+    uint64_t period = 0;
+
+    snprintf(file, sizeof(file), "/sys/fs/cgroup/cpu%s/cpu.cfs_quota_us", path);
+    char buffer[64];
+    if (!ReadTextFile(file, buffer, sizeof(buffer)) || buffer[0] == '-') return;
+    quota = strtoull(buffer, nullptr, 10);
+
+    snprintf(file, sizeof(file), "/sys/fs/cgroup/cpu%s/cpu.cfs_period_us", path);
+    if (!ReadLimit(file, period) || period == 0 || quota == 0) return;
+
+    _cpuQuota = static_cast<double>(quota) / static_cast<double>(period);
+    _cgroupVersion = "v1";
+    snprintf(_cgroupPath, sizeof(_cgroupPath), "%s", path);
+}
+
+uint64_t ResourceLimits::GetEffectiveMemory() const {
+    if (_memoryLimit > 0 && (_hostMemory == 0 || _memoryLimit < _hostMemory)) return _memoryLimit;
+    return _hostMemory;
+}
+
+size_t ResourceLimits::GetFrameBudget() const {
+    uint64_t memory = GetEffectiveMemory();
+    if (memory == 0) return static_cast<size_t>(512) * 1024 * 1024;
+    return static_cast<size_t>(memory / 8);
+}
+
+size_t ResourceLimits::GetCacheBudget() const {
+    uint64_t memory = GetEffectiveMemory();
+    if (memory == 0) return static_cast<size_t>(256) * 1024 * 1024;
+    uint64_t budget = memory / 16;
+    return budget < MAX_CACHE_BUDGET ? static_cast<size_t>(budget) : MAX_CACHE_BUDGET;
+}
+
+int ResourceLimits::GetDecoderThreads(int candidateCpus) const {
+    int threads = candidateCpus < _effectiveCpus ? candidateCpus : _effectiveCpus;
+    if (threads < 1) threads = 1;
+    if (threads > MAX_DECODER_THREADS) threads = MAX_DECODER_THREADS;
+    return threads;
+}
+
+int ResourceLimits::GetFrameQueueCapacity(int requested, size_t frameBytes) const {
+    if (frameBytes == 0) return requested;
+
+    size_t fits = GetFrameBudget() / frameBytes;
+    if (fits < 1) fits = 1;
+    return static_cast<size_t>(requested) < fits ? requested : static_cast<int>(fits);
+}
+
+} // namespace tvk_media
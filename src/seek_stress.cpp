@@ -0,0 +1,244 @@
+#include "seek_stress.h"
+#include <tinyvk/core/log.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+
+namespace tvk_media {
+
+static constexpr int PATTERN_COUNT = static_cast<int>(SeekPattern::Count);
+static const char* CORPUS_EXTENSIONS[] = { ".mp4", ".m4v", ".mov", ".mkv", ".webm", ".avi", ".wmv", ".flv", ".ts", ".nut" };
+
+static bool IsCorpusFile(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (const char* candidate : CORPUS_EXTENSIONS) {
+        if (extension == candidate) return true;
+    }
+    return false;
+}
+
+static float Percentile(const std::vector<float>& sorted, int percent) {
+    if (sorted.empty()) return 0.0f;
+    return sorted[(sorted.size() - 1) * percent / 100];
+}
+
+SeekStress::SeekStress()
+    : _duration(0.0)
+    , _frameDuration(0.04)
+    , _cursor(0.0)
+    , _fileIndex(0)
+    , _seekIndex(0)
+    , _loggedFailures(0)
+    , _fileOpen(false)
+    , _running(false)
+{
+}
+
+const char* SeekStress::GetPatternName(SeekPattern pattern) {
+    switch (pattern) {
+        case SeekPattern::Random: return "random";
+        case SeekPattern::Sequential: return "sequential";
+        case SeekPattern::BackAndForth: return "back-and-forth";
+        case SeekPattern::NearEnd: return "near EOF";
+        case SeekPattern::TrackSwitch: return "track switch";
+        default: return "unknown";
+    }
+}
+
+bool SeekStress::Start(const std::string& anyCorpusFile) {
+    Cancel();
+    _corpus.clear();
+    _results.clear();
+
+    std::error_code error;
+    std::filesystem::path directory = std::filesystem::path(anyCorpusFile).parent_path();
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (entry.is_regular_file(error) && IsCorpusFile(entry.path())) {
+            _corpus.push_back(entry.path().string());
+        }
+    }
+    if (_corpus.empty()) {
+        _corpus.push_back(anyCorpusFile);
+    }
+    std::sort(_corpus.begin(), _corpus.end());
+
+    _results.reserve(_corpus.size());
+    _random.seed(_settings.seed);
+    _fileIndex = 0;
+    _fileOpen = false;
+    _running = true;
+
+    TVK_LOG_INFO("Seek stress: {} file(s) in {}, {} seeks each", _corpus.size(), directory.string(),
+                 GetSeeksPerFile());
+    return true;
+}
+
+void SeekStress::Cancel() {
+    if (!_running) return;
+    _running = false;
+    _fileOpen = false;
+    _reference.Close();
+    TVK_LOG_INFO("Seek stress cancelled after {} file(s)", _results.size());
+}
+
+void SeekStress::BeginFile(const VideoDecoder& decoder) {
+    SeekStressResult result;
+    result.path = GetCurrentPath();
+    result.container = decoder.GetContainerName();
+    result.codec = decoder.GetCodecName();
+    result.opened = true;
+    _results.push_back(result);
+
+    _duration = decoder.GetDuration();
+    _frameDuration = decoder.GetFPS() > 0.0 ? 1.0 / decoder.GetFPS() : 0.04;
+    _cursor = 0.0;
+    _seekIndex = 0;
+    _loggedFailures = 0;
+    _latencies.clear();
+    _latencies.reserve(GetSeeksPerFile());
+
+    _reference.SetThreadCount(1);
+    _reference.SetForwardSeek(false);
+    if (!_reference.Open(result.path)) {
+        TVK_LOG_ERROR("Seek stress: reference decoder failed to open {}", result.path);
+        _results.back().opened = false;
+        _fileIndex++;
+        _running = _fileIndex < GetFileCount();
+        return;
+    }
+    _fileOpen = true;
+}
+
+void SeekStress::SkipFile() {
+    SeekStressResult result;
+    result.path = GetCurrentPath();
+    _results.push_back(result);
+    TVK_LOG_ERROR("Seek stress: could not open {}", result.path);
+
+    _fileIndex++;
+    _running = _fileIndex < GetFileCount();
+}
+
+SeekRequest SeekStress::Next() {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    int perPattern = _settings.seeksPerPattern > 0 ? _settings.seeksPerPattern : 1;
+    int step = _seekIndex % perPattern;
+
+    SeekRequest request;
+    request.pattern = static_cast<SeekPattern>(std::min(_seekIndex / perPattern, PATTERN_COUNT - 1));
+
+    switch (request.pattern) {
+        case SeekPattern::Random:
+            request.target = unit(_random) * _duration;
+            break;
+        case SeekPattern::Sequential:
+            request.target = _duration * step / perPattern;
+            break;
+        case SeekPattern::BackAndForth:
+            if (step % 4 == 0) _cursor = unit(_random) * _duration;
+            request.target = step % 2 == 0 ? _cursor : _cursor + (step % 4 == 1 ? -0.5 : 0.5);
+            break;
+        case SeekPattern::NearEnd:
+            request.target = step % 10 == 9 ? _duration + unit(_random) : _duration - unit(_random) * 2.0;
+            break;
+        case SeekPattern::TrackSwitch:
+            request.target = unit(_random) * _duration;
+            request.switchTrack = true;
+            break;
+        default:
+            break;
+    }
+
+    if (request.target < 0.0) request.target = 0.0;
+    return request;
+}
+
+void SeekStress::Check(const SeekRequest& request, double latencySeconds, bool presented, double presentedPts,
+                       bool hasAudio, double audioTime) {
+    if (!_fileOpen) return;
+
+    SeekStressResult& result = _results.back();
+    result.seeks++;
+    _latencies.push_back(static_cast<float>(latencySeconds * 1000.0));
+
+    // The player refines keyframe seeks to the exact frame, so both of its seek paths end there
+    bool expected = _reference.Seek(request.target) && _reference.DecodeNextFrame(_referenceFrame);
+    double expectedPts = expected ? _referenceFrame.timestamp : -1.0;
+    if (expected && request.target < _duration - _frameDuration * 0.5) {
+        double exactPts = DecodeReferenceExact(request.target);
+        if (exactPts >= 0.0) expectedPts = exactPts;
+    }
+
+    if (presented != expected) {
+        Fail(request, presented ? "frame presented where the reference decoded none" : "no frame presented",
+             presentedPts, expectedPts);
+    } else if (presented) {
+        if (request.target < _duration && presentedPts > request.target + _frameDuration) {
+            Fail(request, "presented frame is past the seek target", presentedPts, expectedPts);
+        } else if (std::fabs(presentedPts - expectedPts) > _frameDuration * 0.5) {
+            Fail(request, "PTS differs from the reference decoder", presentedPts, expectedPts);
+        } else if (hasAudio && std::fabs(audioTime - presentedPts) > _settings.audioTolerance) {
+            Fail(request, "audio does not start at the presented PTS", audioTime, presentedPts);
+        }
+    }
+
+    _seekIndex++;
+    if (_seekIndex >= GetSeeksPerFile()) {
+        FinishFile();
+    }
+}
+
+double SeekStress::DecodeReferenceExact(double target) {
+    double pts = _referenceFrame.timestamp;
+    while (pts < target - _frameDuration * 0.5) {
+        if (!_reference.DecodeNextFrame(_referenceFrame)) return -1.0;
+        pts = _referenceFrame.timestamp;
+    }
+    return pts;
+}
+
+void SeekStress::Fail(const SeekRequest& request, const char* reason, double presentedPts, double expectedPts) {
+    _results.back().failures[static_cast<int>(request.pattern)]++;
+    if (_loggedFailures >= MAX_LOGGED_FAILURES) return;
+
+    _loggedFailures++;
+    TVK_LOG_ERROR("Seek stress: {} seek to {:.3f}s: {} (got {:.3f}s, expected {:.3f}s)",
+                  GetPatternName(request.pattern), request.target, reason, presentedPts, expectedPts);
+}
+
+void SeekStress::FinishFile() {
+    SeekStressResult& result = _results.back();
+    std::sort(_latencies.begin(), _latencies.end());
+    result.p50Ms = Percentile(_latencies, 50);
+    result.p95Ms = Percentile(_latencies, 95);
+    result.p99Ms = Percentile(_latencies, 99);
+    result.maxMs = _latencies.empty() ? 0.0f : _latencies.back();
+
+    int failures = 0;
+    for (int i = 0; i < PATTERN_COUNT; i++) {
+        failures += result.failures[i];
+    }
+
+    TVK_LOG_INFO("Seek stress {} ({} / {}): {} seeks, {} failures, p50 {:.1f} ms, p95 {:.1f} ms, p99 {:.1f} ms, max {:.1f} ms",
+                 result.path, result.container, result.codec, result.seeks, failures,
+                 result.p50Ms, result.p95Ms, result.p99Ms, result.maxMs);
+    if (failures > 0) {
+        for (int i = 0; i < PATTERN_COUNT; i++) {
+            if (result.failures[i] == 0) continue;
+            TVK_LOG_ERROR("  {}: {} failure(s)", GetPatternName(static_cast<SeekPattern>(i)), result.failures[i]);
+        }
+    }
+
+    _reference.Close();
+    _fileOpen = false;
+    _fileIndex++;
+    if (_fileIndex >= GetFileCount()) {
+        _running = false;
+        TVK_LOG_INFO("Seek stress finished: {} file(s)", _results.size());
+    }
+}
+
+} // namespace tvk_media
@@ -0,0 +1,256 @@
+#include "soak_test.h"
+#include "alloc_tracker.h"
+#include "audio_decoder.h"
+#include "gpu_compute.h"
+#include <tinyvk/core/log.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace tvk_media {
+
+struct SoakStep {
+    SoakAction action;
+    double duration;
+    int repeat;
+};
+
+static const SoakStep SOAK_CYCLE[] = {
+    { SoakAction::Reopen, 0.2, 1 },
+    { SoakAction::Play, 0.5, 1 },
+    { SoakAction::Seek, 0.3, 1 },
+    { SoakAction::HoverThumbnail, 0.05, 8 },
+    { SoakAction::SwitchTrack, 0.5, 1 },
+    { SoakAction::EffectsOn, 0.5, 1 },
+    { SoakAction::Seek, 0.3, 1 },
+    { SoakAction::EffectsOff, 0.3, 1 },
+};
+
+static constexpr int STEP_COUNT = static_cast<int>(sizeof(SOAK_CYCLE) / sizeof(SOAK_CYCLE[0]));
+
+static float ReadRssMb() {
+#if defined(__linux__)
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (!file) return 0.0f;
+
+    unsigned long long size = 0;
+    unsigned long long resident = 0;
+    int parsed = fscanf(file, "%llu %llu", &size, &resident);
+    fclose(file);
+    if (parsed != 2) return 0.0f;
+
+    return static_cast<float>(resident * static_cast<unsigned long long>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0));
+#else
+    return 0.0f;
+#endif
+}
+
+static uint64_t GetTotalAllocations() {
+    uint64_t total = 0;
+    for (int i = 0; i < static_cast<int>(AllocStage::Count); i++) {
+        total += AllocTracker::GetStats(static_cast<AllocStage>(i)).count;
+    }
+    return total;
+}
+
+template <typename Field>
+static double Slope(const SoakReport& report, int first, Field field) {
+    int n = report.count - first;
+    if (n < 2) return 0.0;
+
+    double meanX = 0.0;
+    double meanY = 0.0;
+    for (int i = first; i < report.count; i++) {
+        meanX += report.samples[i].hours;
+        meanY += field(report.samples[i]);
+    }
+    meanX /= n;
+    meanY /= n;
+
+    double covariance = 0.0;
+    double variance = 0.0;
+    for (int i = first; i < report.count; i++) {
+        double dx = report.samples[i].hours - meanX;
+        covariance += dx * (field(report.samples[i]) - meanY);
+        variance += dx * dx;
+    }
+    return variance > 0.0 ? covariance / variance : 0.0;
+}
+
+template <typename Field>
+static bool Grows(const SoakReport& report, int first, Field field) {
+    int baseline = 0;
+    for (int i = 0; i < first; i++) {
+        baseline = std::max(baseline, field(report.samples[i]));
+    }
+    return field(report.samples[report.count - 1]) > baseline && Slope(report, first, field) > 0.0;
+}
+
+SoakTest::SoakTest()
+    : _lastTextures(0)
+    , _lastAllocations(0)
+    , _cycleDriftMs(0.0f)
+    , _target(0.0)
+    , _stepStart(0.0)
+    , _stepEnd(0.0)
+    , _step(-1)
+    , _repeat(0)
+    , _cycle(0)
+    , _cycleCount(0)
+    , _running(false)
+{
+}
+
+void SoakTest::Start(const std::string& path, double now) {
+    _report = SoakReport();
+    _path = path;
+    _random.seed(1);
+
+    _lastTextures = GetGpuObjectCounts().texturesCreated;
+    _lastAllocations = AllocTracker::ENABLED ? GetTotalAllocations() : 0;
+    _cycleDriftMs = 0.0f;
+
+    float minutes = _settings.minutesPerCycle > 0.0f ? _settings.minutesPerCycle : 1.0f;
+    _cycleCount = std::min(static_cast<int>(std::ceil(_settings.simulatedHours * 60.0f / minutes)),
+                           SoakReport::MAX_SAMPLES);
+    _cycle = 0;
+    _step = -1;
+    _repeat = 0;
+    _stepStart = now;
+    _stepEnd = now;
+    _running = true;
+
+    TVK_LOG_INFO("Soak test: {:.0f} simulated hours in {} cycles of {:.0f} min on {}",
+                 _settings.simulatedHours, _cycleCount, minutes, path);
+}
+
+void SoakTest::Cancel() {
+    if (!_running) return;
+    _running = false;
+    TVK_LOG_INFO("Soak test cancelled after {} cycle(s)", _cycle);
+}
+
+SoakAction SoakTest::Update(double now, bool driftValid, float driftMs) {
+    if (!_running) return SoakAction::None;
+
+    if (driftValid && now - _stepStart >= SETTLE_TIME) {
+        _cycleDriftMs = std::max(_cycleDriftMs, std::fabs(driftMs));
+    }
+    if (now < _stepEnd) return SoakAction::None;
+
+    if (_step < 0 || ++_repeat >= SOAK_CYCLE[_step].repeat) {
+        _step++;
+        _repeat = 0;
+    }
+    if (_step >= STEP_COUNT) {
+        Sample();
+        _cycle++;
+        _step = 0;
+        if (_cycle >= _cycleCount) {
+            Finish();
+            return SoakAction::Finish;
+        }
+    }
+
+    const SoakStep& step = SOAK_CYCLE[_step];
+    _stepStart = now;
+    _stepEnd = now + step.duration;
+    if (step.action == SoakAction::Seek || step.action == SoakAction::HoverThumbnail) {
+        _target = std::uniform_real_distribution<double>(0.0, 0.95)(_random);
+    }
+    return step.action;
+}
+
+void SoakTest::Sample() {
+    GpuObjectCounts gpu = GetGpuObjectCounts();
+
+    SoakSample& sample = _report.samples[_report.count++];
+    sample.hours = (_cycle + 1) * _settings.minutesPerCycle / 60.0f;
+    sample.rssMb = ReadRssMb();
+    sample.driftMs = _cycleDriftMs;
+    sample.gpuObjects = static_cast<int>(gpu.liveObjects);
+    sample.descriptorSets = static_cast<int>(gpu.descriptorSets);
+    sample.openALObjects = AudioDecoder::GetOpenALObjectCount();
+    sample.texturesCreated = static_cast<int>(gpu.texturesCreated - _lastTextures);
+    _lastTextures = gpu.texturesCreated;
+
+    if (AllocTracker::ENABLED) {
+        uint64_t allocations = GetTotalAllocations();
+        sample.heapAllocations = static_cast<int>(allocations - _lastAllocations);
+        _lastAllocations = allocations;
+    }
+    _cycleDriftMs = 0.0f;
+
+    int cyclesPerHour = std::max(1, static_cast<int>(std::lround(60.0f / _settings.minutesPerCycle)));
+    if ((_cycle + 1) % cyclesPerHour == 0) {
+        TVK_LOG_INFO("Soak {:.1f}h: RSS {:.1f} MB, {} Vulkan objects, {} descriptor sets, {} OpenAL objects, "
+                     "{} textures/cycle, drift {:.1f} ms",
+                     sample.hours, sample.rssMb, sample.gpuObjects, sample.descriptorSets, sample.openALObjects,
+                     sample.texturesCreated, sample.driftMs);
+    }
+}
+
+void SoakTest::Finish() {
+    _running = false;
+    _report.finished = true;
+    _report.passed = false;
+
+    int first = std::min(WARMUP_CYCLES, _report.count / 2);
+    if (_report.count - first < MIN_TREND_CYCLES) {
+        _report.failure = "too few cycles for a trend";
+        TVK_LOG_ERROR("Soak test: {}", _report.failure);
+        return;
+    }
+
+    auto rss = [](const SoakSample& s) { return s.rssMb; };
+    auto drift = [](const SoakSample& s) { return s.driftMs; };
+    auto allocations = [](const SoakSample& s) { return s.heapAllocations; };
+
+    _report.rssGrowthMb = static_cast<float>(Slope(_report, first, rss) * _settings.simulatedHours);
+    _report.driftGrowthMs = static_cast<float>(Slope(_report, first, drift) * _settings.simulatedHours);
+    _report.worstDriftMs = 0.0f;
+    int maxTextures = 0;
+    double meanAllocations = 0.0;
+    for (int i = first; i < _report.count; i++) {
+        _report.worstDriftMs = std::max(_report.worstDriftMs, _report.samples[i].driftMs);
+        maxTextures = std::max(maxTextures, _report.samples[i].texturesCreated);
+        meanAllocations += _report.samples[i].heapAllocations;
+    }
+    meanAllocations /= _report.count - first;
+    double allocationGrowth = Slope(_report, first, allocations) * _settings.simulatedHours;
+
+    if (Grows(_report, first, [](const SoakSample& s) { return s.gpuObjects; })) {
+        _report.failure = "Vulkan objects grow";
+    } else if (Grows(_report, first, [](const SoakSample& s) { return s.descriptorSets; })) {
+        _report.failure = "descriptor pool usage grows";
+    } else if (Grows(_report, first, [](const SoakSample& s) { return s.openALObjects; })) {
+        _report.failure = "OpenAL objects grow";
+    } else if (maxTextures > _settings.maxTexturesPerCycle) {
+        _report.failure = "textures recreated above the per-cycle limit";
+    } else if (AllocTracker::ENABLED && allocationGrowth > meanAllocations * 0.5) {
+        _report.failure = "heap allocations per cycle grow";
+    } else if (_report.rssGrowthMb > _settings.maxRssGrowthMb) {
+        _report.failure = "RSS grows";
+    } else if (_report.worstDriftMs > _settings.maxDriftMs) {
+        _report.failure = "A/V drift above limit";
+    } else if (_report.driftGrowthMs > _settings.maxDriftMs * 0.5f) {
+        _report.failure = "A/V drift grows";
+    } else {
+        _report.passed = true;
+    }
+
+    if (_report.passed) {
+        TVK_LOG_INFO("Soak test PASS: {} cycles, RSS {:+.1f} MB/session, worst drift {:.1f} ms",
+                     _report.count, _report.rssGrowthMb, _report.worstDriftMs);
+    } else {
+        TVK_LOG_ERROR("Soak test FAIL: {} ({} cycles, RSS {:+.1f} MB/session, worst drift {:.1f} ms, "
+                      "{} textures/cycle peak)",
+                      _report.failure, _report.count, _report.rssGrowthMb, _report.worstDriftMs, maxTextures);
+    }
+}
+
+} // namespace tvk_media
@@ -0,0 +1,76 @@
+#include "startup_profiler.h"
+#include <tinyvk/core/log.h>
+
+namespace tvk_media {
+
+StartupProfiler::StartupProfiler(const char* label, double budgetSeconds)
+    : _label(label)
+    , _budget(budgetSeconds)
+    , _count(0)
+    , _total(0.0)
+    , _frameBuilt(false)
+    , _running(false)
+    , _finished(false)
+{
+}
+
+void StartupProfiler::Start() {
+    _origin = std::chrono::steady_clock::now();
+    _last = _origin;
+    _count = 0;
+    _total = 0.0;
+    _frameBuilt = false;
+    _running = true;
+    _finished = false;
+}
+
+void StartupProfiler::Mark(const char* phase) {
+    if (!_running) return;
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - _last).count();
+    _last = now;
+
+    if (_count < MAX_PHASES) {
+        _phases[_count].name = phase;
+        _phases[_count].seconds = seconds;
+        _count++;
+    } else {
+        _phases[MAX_PHASES - 1].seconds += seconds;
+    }
+}
+
+void StartupProfiler::MarkFrameBuilt(const char* phase) {
+    if (!_running || _frameBuilt) return;
+    Mark(phase);
+    _frameBuilt = true;
+}
+
+void StartupProfiler::MarkPresented() {
+    if (!_running || !_frameBuilt) return;
+    Mark("Render and present");
+    Finish();
+}
+
+void StartupProfiler::Cancel() {
+    _running = false;
+}
+
+void StartupProfiler::Finish() {
+    if (!_running) return;
+    _total = std::chrono::duration<double>(_last - _origin).count();
+    _running = false;
+    _finished = true;
+
+    TVK_LOG_INFO("{}: {:.1f} ms (budget {:.0f} ms)", _label, _total * 1000.0, _budget * 1000.0);
+    for (int i = 0; i < _count; i++) {
+        TVK_LOG_INFO("  {}: {:.1f} ms", _phases[i].name, _phases[i].seconds * 1000.0);
+    }
+
+    if (_total > _budget) {
+        TVK_LOG_ERROR("{} exceeded its {:.0f} ms budget by {:.1f} ms", _label, _budget * 1000.0,
+                      (_total - _budget) * 1000.0);
+    }
+}
+
+} // namespace tvk_media
@@ -0,0 +1,476 @@
+#include "sync_benchmark.h"
+#include "video_decoder.h"
+#include <tinyvk/core/log.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+
+namespace tvk_media {
+
+static constexpr int PHASE_COUNT = static_cast<int>(SyncPhase::Count);
+static constexpr int AUDIO_FRAME_SAMPLES = 1024;
+static constexpr int BEEP_THRESHOLD = 8192;
+static constexpr double BEEP_FREQUENCY = 1000.0;
+static constexpr double TWO_PI = 6.283185307179586;
+static constexpr int MIN_MEASUREMENTS = 8;
+
+struct SyncStep {
+    SyncAction action;
+    double duration;
+};
+
+static const SyncStep SYNC_SCRIPT[] = {
+    { SyncAction::Play, 4.0 },
+    { SyncAction::Pause, 1.0 },
+    { SyncAction::Play, 4.0 },
+    { SyncAction::Seek, 4.0 },
+    { SyncAction::SwitchTrack, 4.0 },
+    { SyncAction::Finish, 0.0 },
+};
+
+static AVCodecContext* OpenVideoEncoder(AVFormatContext* format, AVStream*& stream, bool compressed) {
+    const AVCodec* codec = avcodec_find_encoder(compressed ? AV_CODEC_ID_MPEG4 : AV_CODEC_ID_RAWVIDEO);
+    if (!codec) return nullptr;
+
+    AVCodecContext* context = avcodec_alloc_context3(codec);
+    if (!context) return nullptr;
+
+    context->width = SyncBenchmark::WIDTH;
+    context->height = SyncBenchmark::HEIGHT;
+    context->pix_fmt = AV_PIX_FMT_YUV420P;
+    context->time_base = AVRational{ 1, SyncBenchmark::FPS };
+    context->framerate = AVRational{ SyncBenchmark::FPS, 1 };
+    if (compressed) {
+        // One keyframe a second so seeks and the packet path behave like real media
+        context->gop_size = SyncBenchmark::FPS;
+        context->max_b_frames = 0;
+    }
+    if (format->oformat->flags & AVFMT_GLOBALHEADER) {
+        context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+
+    stream = avformat_new_stream(format, nullptr);
+    if (!stream || avcodec_open2(context, codec, nullptr) < 0 ||
+        avcodec_parameters_from_context(stream->codecpar, context) < 0) {
+        avcodec_free_context(&context);
+        return nullptr;
+    }
+    stream->time_base = context->time_base;
+    return context;
+}
+
+static AVCodecContext* OpenAudioEncoder(AVFormatContext* format, AVStream*& stream, const char* label) {
+    const AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_PCM_S16LE);
+    if (!codec) return nullptr;
+
+    AVCodecContext* context = avcodec_alloc_context3(codec);
+    if (!context) return nullptr;
+
+    context->sample_fmt = AV_SAMPLE_FMT_S16;
+    context->sample_rate = SyncBenchmark::SAMPLE_RATE;
+    av_channel_layout_default(&context->ch_layout, 2);
+    context->time_base = AVRational{ 1, SyncBenchmark::SAMPLE_RATE };
+    if (format->oformat->flags & AVFMT_GLOBALHEADER) {
+        context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+
+    stream = avformat_new_stream(format, nullptr);
+    if (!stream || avcodec_open2(context, codec, nullptr) < 0 ||
+        avcodec_parameters_from_context(stream->codecpar, context) < 0) {
+        avcodec_free_context(&context);
+        return nullptr;
+    }
+    stream->time_base = context->time_base;
+    av_dict_set(&stream->metadata, "language", label, 0);
+    return context;
+}
+
+static bool EncodeFrame(AVFormatContext* format, AVCodecContext* context, AVStream* stream,
+                        AVFrame* frame, AVPacket* packet) {
+    if (avcodec_send_frame(context, frame) < 0) return false;
+
+    while (true) {
+        int ret = avcodec_receive_packet(context, packet);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) return true;
+        if (ret < 0) return false;
+
+        av_packet_rescale_ts(packet, context->time_base, stream->time_base);
+        packet->stream_index = stream->index;
+        if (av_interleaved_write_frame(format, packet) < 0) return false;
+    }
+}
+
+static bool IsEventActive(double time, double offset) {
+    double local = time - offset;
+    if (local < 0.0) return false;
+    return std::fmod(local, SyncBenchmark::EVENT_INTERVAL) < SyncBenchmark::EVENT_LENGTH;
+}
+
+static void FillVideoFrame(AVFrame* frame, bool flash) {
+    uint8_t luma = flash ? 235 : 16;
+    for (int y = 0; y < frame->height; y++) {
+        std::fill_n(frame->data[0] + y * frame->linesize[0], frame->width, luma);
+    }
+    for (int plane = 1; plane < 3; plane++) {
+        for (int y = 0; y < (frame->height + 1) / 2; y++) {
+            std::fill_n(frame->data[plane] + y * frame->linesize[plane], (frame->width + 1) / 2, uint8_t(128));
+        }
+    }
+}
+
+static void FillAudioFrame(AVFrame* frame, int64_t firstSample, double offset) {
+    int16_t* out = reinterpret_cast<int16_t*>(frame->data[0]);
+    for (int i = 0; i < frame->nb_samples; i++) {
+        double time = static_cast<double>(firstSample + i) / SyncBenchmark::SAMPLE_RATE;
+        int16_t value = 0;
+        if (IsEventActive(time, offset)) {
+            value = static_cast<int16_t>(16384.0 * std::sin(TWO_PI * BEEP_FREQUENCY * time));
+        }
+        out[i * 2] = value;
+        out[i * 2 + 1] = value;
+    }
+}
+
+bool SyncBenchmark::GenerateMedia(const std::string& path, float trackOffsetMs, bool compressed) {
+    AVFormatContext* format = nullptr;
+    if (avformat_alloc_output_context2(&format, nullptr, "nut", path.c_str()) < 0 || !format) {
+        TVK_LOG_ERROR("Sync benchmark: NUT muxer unavailable");
+        return false;
+    }
+
+    double offsets[TRACK_COUNT] = { 0.0, trackOffsetMs / 1000.0 };
+    char labels[TRACK_COUNT][32];
+    AVStream* videoStream = nullptr;
+    AVStream* audioStreams[TRACK_COUNT] = {};
+    AVCodecContext* audioContexts[TRACK_COUNT] = {};
+    AVCodecContext* videoContext = OpenVideoEncoder(format, videoStream, compressed);
+    bool ok = videoContext != nullptr;
+    for (int t = 0; t < TRACK_COUNT && ok; t++) {
+        snprintf(labels[t], sizeof(labels[t]), "sync%+.0fms", offsets[t] * 1000.0);
+        audioContexts[t] = OpenAudioEncoder(format, audioStreams[t], labels[t]);
+        ok = audioContexts[t] != nullptr;
+    }
+
+    AVFrame* videoFrame = av_frame_alloc();
+    AVFrame* audioFrame = av_frame_alloc();
+    AVPacket* packet = av_packet_alloc();
+    ok = ok && videoFrame && audioFrame && packet;
+
+    if (ok) {
+        videoFrame->format = AV_PIX_FMT_YUV420P;
+        videoFrame->width = WIDTH;
+        videoFrame->height = HEIGHT;
+        audioFrame->format = AV_SAMPLE_FMT_S16;
+        audioFrame->sample_rate = SAMPLE_RATE;
+        audioFrame->nb_samples = AUDIO_FRAME_SAMPLES;
+        av_channel_layout_default(&audioFrame->ch_layout, 2);
+        ok = av_frame_get_buffer(videoFrame, 0) >= 0 && av_frame_get_buffer(audioFrame, 0) >= 0;
+    }
+
+    if (ok && !(format->oformat->flags & AVFMT_NOFILE)) {
+        ok = avio_open(&format->pb, path.c_str(), AVIO_FLAG_WRITE) >= 0;
+    }
+    ok = ok && avformat_write_header(format, nullptr) >= 0;
+
+    int videoFrames = static_cast<int>(MEDIA_DURATION * FPS);
+    int64_t audioSamples = 0;
+    for (int i = 0; i < videoFrames && ok; i++) {
+        double time = static_cast<double>(i) / FPS;
+        ok = av_frame_make_writable(videoFrame) >= 0;
+        if (!ok) break;
+        FillVideoFrame(videoFrame, IsEventActive(time, 0.0));
+        videoFrame->pts = i;
+        ok = EncodeFrame(format, videoContext, videoStream, videoFrame, packet);
+
+        int64_t audioEnd = static_cast<int64_t>(i + 1) * SAMPLE_RATE / FPS;
+        while (ok && audioSamples < audioEnd) {
+            for (int t = 0; t < TRACK_COUNT && ok; t++) {
+                ok = av_frame_make_writable(audioFrame) >= 0;
+                if (!ok) break;
+                FillAudioFrame(audioFrame, audioSamples, offsets[t]);
+                audioFrame->pts = audioSamples;
+                ok = EncodeFrame(format, audioContexts[t], audioStreams[t], audioFrame, packet);
+            }
+            audioSamples += AUDIO_FRAME_SAMPLES;
+        }
+    }
+
+    if (ok) {
+        ok = EncodeFrame(format, videoContext, videoStream, nullptr, packet);
+        for (int t = 0; t < TRACK_COUNT && ok; t++) {
+            ok = EncodeFrame(format, audioContexts[t], audioStreams[t], nullptr, packet);
+        }
+        ok = ok && av_write_trailer(format) >= 0;
+    }
+
+    av_packet_free(&packet);
+    av_frame_free(&audioFrame);
+    av_frame_free(&videoFrame);
+    for (int t = 0; t < TRACK_COUNT; t++) {
+        avcodec_free_context(&audioContexts[t]);
+    }
+    avcodec_free_context(&videoContext);
+    if (format->pb && !(format->oformat->flags & AVFMT_NOFILE)) {
+        avio_closep(&format->pb);
+    }
+    avformat_free_context(format);
+
+    if (!ok) {
+        TVK_LOG_ERROR("Sync benchmark: failed to write {}", path);
+    }
+    return ok;
+}
+
+std::string SyncBenchmark::GetMediaPath() {
+    std::error_code error;
+    std::filesystem::path directory = std::filesystem::temp_directory_path(error);
+    if (error) directory = ".";
+    return (directory / "tvk-sync-benchmark.nut").string();
+}
+
+SyncBenchmark::SyncBenchmark()
+    : _flashCount(0)
+    , _beepCount(0)
+    , _pendingCount(0)
+    , _lastLoudTime(-1.0)
+    , _lastFrameBright(false)
+    , _lastNow(0.0)
+    , _lastClock(-1.0)
+    , _stepEnd(0.0)
+    , _step(-1)
+    , _segment(0)
+    , _track(0)
+    , _phase(SyncPhase::Start)
+    , _running(false)
+{
+}
+
+const char* SyncBenchmark::GetPhaseName(SyncPhase phase) {
+    switch (phase) {
+        case SyncPhase::Start: return "start";
+        case SyncPhase::AfterPause: return "after pause";
+        case SyncPhase::AfterSeek: return "after seek";
+        case SyncPhase::AfterTrackSwitch: return "after track switch";
+        default: return "unknown";
+    }
+}
+
+float SyncBenchmark::GetTrackOffset() const {
+    return _track == 0 ? 0.0f : _settings.trackOffsetMs;
+}
+
+void SyncBenchmark::Start(double now) {
+    _report = SyncBenchmarkReport();
+    _flashCount = 0;
+    _beepCount = 0;
+    _pendingCount = 0;
+    _lastLoudTime = -1.0;
+    _lastFrameBright = false;
+    _lastNow = now;
+    _lastClock = -1.0;
+    _stepEnd = now;
+    _step = -1;
+    _segment = 0;
+    _track = 0;
+    _phase = SyncPhase::Start;
+    _running = true;
+}
+
+void SyncBenchmark::Cancel() {
+    if (!_running) return;
+    _running = false;
+    TVK_LOG_INFO("Sync benchmark cancelled");
+}
+
+SyncAction SyncBenchmark::Update(double now, double audioClock, bool audioPlaying) {
+    if (!_running) return SyncAction::None;
+
+    if (audioPlaying && _lastClock >= 0.0 && audioClock > _lastClock && audioClock - _lastClock < 0.5) {
+        int kept = 0;
+        for (int i = 0; i < _pendingCount; i++) {
+            double beep = _pendingBeeps[i];
+            if (beep > audioClock) {
+                _pendingBeeps[kept++] = beep;
+                continue;
+            }
+            if (beep <= _lastClock) continue;
+
+            double wall = _lastNow + (beep - _lastClock) / (audioClock - _lastClock) * (now - _lastNow);
+            int slot = static_cast<int>(std::floor((beep - GetTrackOffset() / 1000.0) / EVENT_INTERVAL + 0.5));
+            AddBeep(slot, wall);
+        }
+        _pendingCount = kept;
+    }
+    _lastNow = now;
+    _lastClock = audioPlaying ? audioClock : -1.0;
+
+    if (now < _stepEnd) return SyncAction::None;
+
+    _step++;
+    const SyncStep& step = SYNC_SCRIPT[_step];
+    _stepEnd = now + step.duration;
+
+    _segment++;
+    _flashCount = 0;
+    _beepCount = 0;
+    if (step.action == SyncAction::Seek || step.action == SyncAction::SwitchTrack) {
+        _pendingCount = 0;
+        _lastLoudTime = -1.0;
+        _lastFrameBright = false;
+    }
+
+    switch (step.action) {
+        case SyncAction::Play:
+            if (_step > 0) _phase = SyncPhase::AfterPause;
+            break;
+        case SyncAction::Seek:
+            _phase = SyncPhase::AfterSeek;
+            break;
+        case SyncAction::SwitchTrack:
+            _phase = SyncPhase::AfterTrackSwitch;
+            _track = 1;
+            break;
+        case SyncAction::Finish:
+            Finish();
+            break;
+        default:
+            break;
+    }
+    return step.action;
+}
+
+void SyncBenchmark::OnFramePresented(double now, const VideoFrame& frame) {
+    if (!_running || frame.width <= 0 || frame.height <= 0) return;
+
+    size_t center = (static_cast<size_t>(frame.height / 2) * frame.width + frame.width / 2) * 4;
+    if (center >= frame.data.size()) return;
+
+    bool bright = frame.data[center] > 128;
+    if (bright && !_lastFrameBright) {
+        int slot = static_cast<int>(std::floor(frame.timestamp / EVENT_INTERVAL + 0.5));
+        if (std::fabs(frame.timestamp - slot * EVENT_INTERVAL) < 0.5 / FPS) {
+            AddFlash(slot, now);
+        }
+    }
+    _lastFrameBright = bright;
+}
+
+void SyncBenchmark::OnAudioBuffer(double startTime, const int16_t* samples, int frames, int channels,
+                                  int sampleRate) {
+    if (!_running || sampleRate <= 0 || channels <= 0) return;
+
+    for (int i = 0; i < frames; i++) {
+        int value = samples[i * channels];
+        if (value < BEEP_THRESHOLD && value > -BEEP_THRESHOLD) continue;
+
+        double time = startTime + static_cast<double>(i) / sampleRate;
+        if (_lastLoudTime < 0.0 || time < _lastLoudTime || time - _lastLoudTime > EVENT_INTERVAL * 0.5) {
+            if (_pendingCount < MAX_EVENTS) _pendingBeeps[_pendingCount++] = time;
+        }
+        _lastLoudTime = time;
+    }
+}
+
+void SyncBenchmark::AddFlash(int slot, double wall) {
+    for (int i = 0; i < _beepCount; i++) {
+        if (_beeps[i].slot != slot || _beeps[i].segment != _segment) continue;
+        Measure(slot, wall, _beeps[i].wall);
+        _beeps[i] = _beeps[--_beepCount];
+        return;
+    }
+    if (_flashCount == MAX_EVENTS) {
+        for (int i = 1; i < MAX_EVENTS; i++) _flashes[i - 1] = _flashes[i];
+        _flashCount--;
+    }
+    _flashes[_flashCount++] = { slot, _segment, wall };
+}
+
+void SyncBenchmark::AddBeep(int slot, double wall) {
+    for (int i = 0; i < _flashCount; i++) {
+        if (_flashes[i].slot != slot || _flashes[i].segment != _segment) continue;
+        Measure(slot, _flashes[i].wall, wall);
+        _flashes[i] = _flashes[--_flashCount];
+        return;
+    }
+    if (_beepCount == MAX_EVENTS) {
+        for (int i = 1; i < MAX_EVENTS; i++) _beeps[i - 1] = _beeps[i];
+        _beepCount--;
+    }
+    _beeps[_beepCount++] = { slot, _segment, wall };
+}
+
+void SyncBenchmark::Measure(int slot, double flashWall, double beepWall) {
+    if (_report.count >= SyncBenchmarkReport::MAX_MEASUREMENTS) return;
+
+    float offsetMs = static_cast<float>((beepWall - flashWall) * 1000.0);
+    float errorMs = offsetMs - GetTrackOffset();
+    _report.errorsMs[_report.count] = errorMs;
+    _report.mediaTimes[_report.count] = slot * EVENT_INTERVAL;
+    _report.count++;
+
+    SyncPhaseResult& phase = _report.phases[static_cast<int>(_phase)];
+    if (phase.count == 0 || errorMs < phase.minMs) phase.minMs = errorMs;
+    if (phase.count == 0 || errorMs > phase.maxMs) phase.maxMs = errorMs;
+    phase.meanMs = (phase.meanMs * phase.count + errorMs) / (phase.count + 1);
+    phase.count++;
+
+    TVK_LOG_INFO("Sync benchmark: event at {:.0f}s ({}), audio {:+.1f} ms vs video, error {:+.1f} ms",
+                 slot * EVENT_INTERVAL, GetPhaseName(_phase), offsetMs, errorMs);
+}
+
+void SyncBenchmark::Finish() {
+    _running = false;
+    _report.finished = true;
+
+    int count = _report.count;
+    if (count > 0) {
+        double sum = 0.0;
+        float lowest = _report.errorsMs[0];
+        float highest = _report.errorsMs[0];
+        for (int i = 0; i < count; i++) {
+            float error = _report.errorsMs[i];
+            sum += error;
+            if (error < lowest) lowest = error;
+            if (error > highest) highest = error;
+            if (std::fabs(error) > _report.worstMs) _report.worstMs = std::fabs(error);
+        }
+        _report.meanMs = static_cast<float>(sum / count);
+
+        double variance = 0.0;
+        for (int i = 0; i < count; i++) {
+            double delta = _report.errorsMs[i] - _report.meanMs;
+            variance += delta * delta;
+        }
+        _report.stddevMs = static_cast<float>(std::sqrt(variance / count));
+        _report.driftMs = highest - lowest;
+    }
+
+    if (count < MIN_MEASUREMENTS) {
+        _report.failure = "too few flash/beep pairs measured";
+    } else if (_report.worstMs > _settings.maxOffsetMs) {
+        _report.failure = "A/V offset above limit";
+    } else if (_report.driftMs > _settings.maxDriftMs) {
+        _report.failure = "A/V drift above limit";
+    }
+    _report.passed = _report.failure[0] == '\0';
+
+    TVK_LOG_INFO("Sync benchmark: {} pairs, mean {:+.1f} ms, stddev {:.1f} ms, worst {:.1f} ms, drift {:.1f} ms",
+                 count, _report.meanMs, _report.stddevMs, _report.worstMs, _report.driftMs);
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        const SyncPhaseResult& phase = _report.phases[i];
+        if (phase.count == 0) continue;
+        TVK_LOG_INFO("  {}: {} pairs, mean {:+.1f} ms, range {:+.1f} to {:+.1f} ms",
+                     GetPhaseName(static_cast<SyncPhase>(i)), phase.count, phase.meanMs, phase.minMs, phase.maxMs);
+    }
+
+    if (_report.passed) {
+        TVK_LOG_INFO("Sync benchmark passed (limits {:.0f} ms offset, {:.0f} ms drift)",
+                     _settings.maxOffsetMs, _settings.maxDriftMs);
+    } else {
+        TVK_LOG_ERROR("Sync benchmark failed: {} (limits {:.0f} ms offset, {:.0f} ms drift)",
+                      _report.failure, _settings.maxOffsetMs, _settings.maxDriftMs);
+    }
+}
+
+} // namespace tvk_media
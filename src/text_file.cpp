@@ -0,0 +1,20 @@
+#include "text_file.h"
+#include <cstdio>
+
+namespace tvk_media {
+
+bool ReadTextFile(const char* path, char* buffer, size_t size) {
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+
+    size_t length = fread(buffer, 1, size - 1, file);
+    fclose(file);
+
+    while (length > 0 && (buffer[length - 1] == '\n' || buffer[length - 1] == ' ')) {
+        length--;
+    }
+    buffer[length] = '\0';
+    return length > 0;
+}
+
+} // namespace tvk_media
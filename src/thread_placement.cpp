@@ -0,0 +1,190 @@
+#include "thread_placement.h"
+#include <tinyvk/core/log.h>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace tvk_media {
+
+#if defined(__linux__)
+static constexpr int MPOL_PREFERRED_MODE = 1;
+static constexpr unsigned MPOL_MF_MOVE_FLAG = 1u << 1;
+#endif
+
+ThreadPlacement::ThreadPlacement() {
+    for (int& node : _nodes) node = 0;
+}
+
+const char* ThreadPlacement::GetClassName(ThreadClass threadClass) {
+    switch (threadClass) {
+        case ThreadClass::Decode: return "Decode";
+        case ThreadClass::Audio: return "Audio";
+        case ThreadClass::Background: return "Background";
+        default: return "Unknown";
+    }
+}
+
+void ThreadPlacement::Init() {
+    if (_topology.Detect()) {
+        TVK_LOG_INFO("CPU topology: {} CPUs, {} performance, {} efficiency, {} package(s), {} NUMA node(s)",
+                     _topology.GetCpuCount(), _topology.GetPerformanceSet().Count(),
+                     _topology.GetEfficiencySet().Count(), _topology.GetPackageCount(),
+                     _topology.GetNodeCount());
+    } else {
+        TVK_LOG_INFO("CPU topology not available, assuming {} uniform CPUs", _topology.GetCpuCount());
+    }
+    Replan();
+}
+
+int ThreadPlacement::PickDecodeNode() const {
+    int counts[CpuTopology::MAX_NODES] = {};
+    for (int i = 0; i < _topology.GetCpuCount(); i++) {
+        const CpuInfo& info = _topology.GetCpu(i);
+        if (!info.efficiency && info.node < CpuTopology::MAX_NODES) counts[info.node]++;
+    }
+
+    int best = 0;
+    for (int node = 1; node < _topology.GetNodeCount(); node++) {
+        if (counts[node] > counts[best]) best = node;
+    }
+    return best;
+}
+
+void ThreadPlacement::Replan() {
+    const CpuSet& online = _topology.GetOnlineSet();
+    for (int i = 0; i < static_cast<int>(ThreadClass::Count); i++) {
+        _sets[i] = online;
+        _nodes[i] = 0;
+    }
+    if (!_settings.enabled) return;
+
+    int decodeNode = PickDecodeNode();
+    bool multiNode = _topology.GetNodeCount() > 1;
+
+    CpuSet& decode = _sets[static_cast<int>(ThreadClass::Decode)];
+    decode.Clear();
+    for (int i = 0; i < _topology.GetCpuCount(); i++) {
+        const CpuInfo& info = _topology.GetCpu(i);
+        if (multiNode && info.node != decodeNode) continue;
+        if (_settings.performanceDecode && info.efficiency) continue;
+        decode.Set(info.cpu);
+    }
+    if (decode.IsEmpty()) decode = online;
+
+    CpuSet& audio = _sets[static_cast<int>(ThreadClass::Audio)];
+    audio = decode;
+    if (_settings.isolateAudio) {
+        int audioCore = -1;
+        int audioPackage = 0;
+        int physicalCores = 0;
+        for (int i = 0; i < _topology.GetCpuCount(); i++) {
+            const CpuInfo& info = _topology.GetCpu(i);
+            if (!decode.Has(info.cpu)) continue;
+
+            bool sibling = false;
+            for (int j = 0; j < i && !sibling; j++) {
+                const CpuInfo& other = _topology.GetCpu(j);
+                sibling = decode.Has(other.cpu) && other.coreId == info.coreId && other.package == info.package;
+            }
+            if (sibling) continue;
+
+            physicalCores++;
+            audioCore = info.coreId;
+            audioPackage = info.package;
+        }
+
+        if (physicalCores > 2 && audioCore >= 0) {
+            audio.Clear();
+            for (int i = 0; i < _topology.GetCpuCount(); i++) {
+                const CpuInfo& info = _topology.GetCpu(i);
+                if (decode.Has(info.cpu) && info.coreId == audioCore && info.package == audioPackage) {
+                    audio.Set(info.cpu);
+                }
+            }
+            for (int cpu = 0; cpu < CpuSet::MAX_CPUS; cpu++) {
+                if (audio.Has(cpu)) decode.Reset(cpu);
+            }
+        }
+    }
+
+    CpuSet& background = _sets[static_cast<int>(ThreadClass::Background)];
+    background.Clear();
+    if (_settings.efficiencyBackground && _topology.IsHybrid()) {
+        background = _topology.GetEfficiencySet();
+    } else {
+        background = decode;
+    }
+
+    for (int i = 0; i < static_cast<int>(ThreadClass::Count); i++) {
+        _nodes[i] = decodeNode;
+    }
+    if (multiNode) {
+        for (int i = 0; i < _topology.GetCpuCount(); i++) {
+            const CpuInfo& info = _topology.GetCpu(i);
+            if (background.Has(info.cpu)) {
+                _nodes[static_cast<int>(ThreadClass::Background)] = info.node;
+                break;
+            }
+        }
+    }
+}
+
+bool ThreadPlacement::Apply(ThreadClass threadClass) const {
+#if defined(__linux__)
+    const CpuSet& set = GetSet(threadClass);
+    if (set.IsEmpty()) return false;
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int cpu = 0; cpu < CpuSet::MAX_CPUS && cpu < CPU_SETSIZE; cpu++) {
+        if (set.Has(cpu)) CPU_SET(cpu, &mask);
+    }
+
+    if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+        TVK_LOG_ERROR("Failed to set {} thread affinity", GetClassName(threadClass));
+        return false;
+    }
+    return true;
+#else
+    (void)threadClass;
+    return false;
+#endif
+}
+
+void ThreadPlacement::BindMemory(void* data, size_t size, ThreadClass threadClass) const {
+#if defined(__linux__) && defined(SYS_mbind)
+    if (!_settings.enabled || !_settings.numaLocalFrames || !data || size == 0) return;
+    if (_topology.GetNodeCount() < 2) return;
+
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pageSize <= 0) return;
+
+    uintptr_t begin = reinterpret_cast<uintptr_t>(data) & ~static_cast<uintptr_t>(pageSize - 1);
+    uintptr_t end = reinterpret_cast<uintptr_t>(data) + size;
+
+    unsigned long nodeMask = 1ul << GetNode(threadClass);
+    syscall(SYS_mbind, reinterpret_cast<void*>(begin), end - begin, MPOL_PREFERRED_MODE,
+            &nodeMask, sizeof(nodeMask) * 8, MPOL_MF_MOVE_FLAG);
+#else
+    (void)data;
+    (void)size;
+    (void)threadClass;
+#endif
+}
+
+ScopedThreadPlacement::ScopedThreadPlacement(const ThreadPlacement& placement, ThreadClass target, ThreadClass restore)
+    : _placement(placement)
+    , _restore(restore)
+{
+    _placement.Apply(target);
+}
+
+ScopedThreadPlacement::~ScopedThreadPlacement() {
+    _placement.Apply(_restore);
+}
+
+} // namespace tvk_media
@@ -0,0 +1,248 @@
+#include "thread_stats.h"
+#include "text_file.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace tvk_media {
+
+static constexpr int ROLE_COUNT = static_cast<int>(ThreadRole::Count);
+static constexpr int MAX_REGISTERED = 64;
+
+struct RegisteredThread {
+    int tid;
+    ThreadRole role;
+};
+
+static std::mutex g_registryMutex;
+static RegisteredThread g_registry[MAX_REGISTERED];
+static int g_registryCount = 0;
+
+#if defined(__linux__)
+static ThreadRole LookupRegisteredRole(int tid, bool& found) {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    for (int i = 0; i < g_registryCount; i++) {
+        if (g_registry[i].tid == tid) {
+            found = true;
+            return g_registry[i].role;
+        }
+    }
+    found = false;
+    return ThreadRole::Other;
+}
+
+static ThreadRole ClassifyThread(int tid, const char* comm) {
+    bool registered = false;
+    ThreadRole role = LookupRegisteredRole(tid, registered);
+    if (registered) return role;
+
+    if (tid == static_cast<int>(getpid())) return ThreadRole::Main;
+    if (strncmp(comm, "av:", 3) == 0) return ThreadRole::FFmpeg;
+    if (strncmp(comm, "alsoft", 6) == 0) return ThreadRole::Audio;
+    return ThreadRole::Other;
+}
+
+static bool ReadCpuTimes(const char* taskPath, uint64_t& cpuNs, uint64_t& waitNs, bool& hasWait) {
+    char path[128];
+    char buffer[512];
+
+    snprintf(path, sizeof(path), "%s/schedstat", taskPath);
+    unsigned long long run = 0;
+    unsigned long long wait = 0;
+    if (ReadTextFile(path, buffer, sizeof(buffer)) && sscanf(buffer, "%llu %llu", &run, &wait) == 2) {
+        cpuNs = run;
+        waitNs = wait;
+        hasWait = true;
+        return true;
+    }
+
+    snprintf(path, sizeof(path), "%s/stat", taskPath);
+    if (!ReadTextFile(path, buffer, sizeof(buffer))) return false;
+
+    const char* fields = strrchr(buffer, ')');
+    if (!fields) return false;
+
+    unsigned long long utime = 0;
+    unsigned long long stime = 0;
+    if (sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu", &utime, &stime) != 2) {
+        return false;
+    }
+
+    long ticks = sysconf(_SC_CLK_TCK);
+    if (ticks <= 0) ticks = 100;
+    cpuNs = (utime + stime) * 1000000000ull / static_cast<unsigned long long>(ticks);
+    waitNs = 0;
+    hasWait = false;
+    return true;
+}
+
+static void ReadContextSwitches(const char* taskPath, uint64_t& voluntary, uint64_t& involuntary) {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/status", taskPath);
+    FILE* file = fopen(path, "r");
+    if (!file) return;
+
+    char line[128];
+    unsigned long long value = 0;
+    while (fgets(line, sizeof(line), file)) {
+        if (sscanf(line, "voluntary_ctxt_switches: %llu", &value) == 1) {
+            voluntary = value;
+        } else if (sscanf(line, "nonvoluntary_ctxt_switches: %llu", &value) == 1) {
+            involuntary = value;
+            break;
+        }
+    }
+    fclose(file);
+}
+#endif
+
+ThreadStats::ThreadStats()
+    : _threadCount(0)
+    , _lastSample(-1.0)
+    , _available(false)
+    , _hasRunDelay(false)
+{
+}
+
+void ThreadStats::RegisterCurrentThread(ThreadRole role) {
+#if defined(__linux__)
+    int tid = static_cast<int>(syscall(SYS_gettid));
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    for (int i = 0; i < g_registryCount; i++) {
+        if (g_registry[i].tid == tid) {
+            g_registry[i].role = role;
+            return;
+        }
+    }
+    if (g_registryCount < MAX_REGISTERED) {
+        g_registry[g_registryCount++] = { tid, role };
+    }
+#else
+    (void)role;
+#endif
+}
+
+const char* ThreadStats::GetRoleName(ThreadRole role) {
+    switch (role) {
+        case ThreadRole::Main: return "main";
+        case ThreadRole::FFmpeg: return "ffmpeg";
+        case ThreadRole::Audio: return "audio";
+        case ThreadRole::Background: return "background";
+        case ThreadRole::Other: return "other";
+        default: return "unknown";
+    }
+}
+
+ThreadStats::ThreadEntry* ThreadStats::FindEntry(int tid) {
+    for (int i = 0; i < _threadCount; i++) {
+        if (_threads[i].tid == tid) return &_threads[i];
+    }
+    return nullptr;
+}
+
+bool ThreadStats::Update(double now) {
+#if defined(__linux__)
+    if (_lastSample >= 0.0 && now - _lastSample < SAMPLE_INTERVAL) return false;
+
+    DIR* dir = opendir("/proc/self/task");
+    if (!dir) return false;
+
+    double elapsed = _lastSample >= 0.0 ? now - _lastSample : 0.0;
+    ThreadRoleStats roles[ROLE_COUNT];
+    for (int i = 0; i < _threadCount; i++) {
+        _threads[i].seen = false;
+    }
+
+    bool hasRunDelay = true;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') continue;
+        int tid = atoi(entry->d_name);
+        if (tid <= 0) continue;
+
+        char taskPath[64];
+        snprintf(taskPath, sizeof(taskPath), "/proc/self/task/%d", tid);
+
+        uint64_t cpuNs = 0;
+        uint64_t waitNs = 0;
+        bool hasWait = false;
+        if (!ReadCpuTimes(taskPath, cpuNs, waitNs, hasWait)) continue;
+        hasRunDelay &= hasWait;
+
+        uint64_t voluntary = 0;
+        uint64_t involuntary = 0;
+        ReadContextSwitches(taskPath, voluntary, involuntary);
+
+        char path[96];
+        char comm[32];
+        snprintf(path, sizeof(path), "%s/comm", taskPath);
+        if (!ReadTextFile(path, comm, sizeof(comm))) comm[0] = '\0';
+
+        ThreadEntry* thread = FindEntry(tid);
+        bool fresh = !thread || cpuNs < thread->cpuNs || waitNs < thread->waitNs ||
+                     voluntary < thread->voluntary || involuntary < thread->involuntary;
+        if (!thread) {
+            if (_threadCount >= MAX_THREADS) continue;
+            thread = &_threads[_threadCount++];
+            thread->tid = tid;
+        }
+        thread->role = ClassifyThread(tid, comm);
+        thread->seen = true;
+
+        ThreadRoleStats& role = roles[static_cast<int>(thread->role)];
+        role.threads++;
+        if (elapsed > 0.0 && !fresh) {
+            double cpuPercent = static_cast<double>(cpuNs - thread->cpuNs) / (elapsed * 1e7);
+            role.cpuPercent += cpuPercent;
+            if (cpuPercent > role.peakThreadPercent) role.peakThreadPercent = cpuPercent;
+            role.voluntaryPerSecond += static_cast<double>(voluntary - thread->voluntary) / elapsed;
+            role.involuntaryPerSecond += static_cast<double>(involuntary - thread->involuntary) / elapsed;
+            role.runDelayMsPerSecond += static_cast<double>(waitNs - thread->waitNs) / (elapsed * 1e6);
+        }
+
+        thread->cpuNs = cpuNs;
+        thread->waitNs = waitNs;
+        thread->voluntary = voluntary;
+        thread->involuntary = involuntary;
+    }
+    closedir(dir);
+
+    int kept = 0;
+    for (int i = 0; i < _threadCount; i++) {
+        if (_threads[i].seen) _threads[kept++] = _threads[i];
+    }
+    _threadCount = kept;
+
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        int registered = 0;
+        for (int i = 0; i < g_registryCount; i++) {
+            char taskPath[64];
+            snprintf(taskPath, sizeof(taskPath), "/proc/self/task/%d", g_registry[i].tid);
+            if (FindEntry(g_registry[i].tid) || access(taskPath, F_OK) == 0) {
+                g_registry[registered++] = g_registry[i];
+            }
+        }
+        g_registryCount = registered;
+    }
+
+    for (int i = 0; i < ROLE_COUNT; i++) {
+        _roles[i] = roles[i];
+    }
+    _available = _threadCount > 0;
+    _hasRunDelay = _available && hasRunDelay;
+    _lastSample = now;
+    return elapsed > 0.0;
+#else
+    (void)now;
+    return false;
+#endif
+}
+
+} // namespace tvk_media
@@ -0,0 +1,475 @@
+#include "thumbnail_pyramid.h"
+#include "thread_placement.h"
+#include "thread_stats.h"
+#include "video_decoder.h"
+#include <tinyvk/core/log.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+
+namespace tvk_media {
+
+struct PyramidHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t tileWidth;
+    uint32_t tileHeight;
+    uint32_t baseTiles;
+    uint32_t levels;
+    uint64_t mediaSize;
+    int64_t mediaTime;
+    double duration;
+};
+
+static constexpr uint32_t CACHE_VERSION = 1;
+static constexpr size_t PACKED_BYTES = ThumbnailPyramid::TILE_WIDTH * ThumbnailPyramid::TILE_HEIGHT * 2;
+static constexpr size_t PIXEL_BYTES = ThumbnailPyramid::TILE_WIDTH * ThumbnailPyramid::TILE_HEIGHT * 4;
+
+static std::string GetCacheDirectory() {
+#if defined(_WIN32)
+    const char* local = std::getenv("LOCALAPPDATA");
+    if (local && *local) return std::string(local) + "/tvk-media-player/thumbnails";
+#else
+    const char* cache = std::getenv("XDG_CACHE_HOME");
+    if (cache && *cache) return std::string(cache) + "/tvk-media-player/thumbnails";
+    const char* home = std::getenv("HOME");
+    if (home && *home) return std::string(home) + "/.cache/tvk-media-player/thumbnails";
+#endif
+    return "thumbnails";
+}
+
+static void PackTile(const VideoFrame& frame, std::vector<uint8_t>& packed) {
+    std::fill(packed.begin(), packed.end(), 0);
+
+    int width = std::min(frame.width, ThumbnailPyramid::TILE_WIDTH);
+    int height = std::min(frame.height, ThumbnailPyramid::TILE_HEIGHT);
+    int left = (ThumbnailPyramid::TILE_WIDTH - width) / 2;
+    int top = (ThumbnailPyramid::TILE_HEIGHT - height) / 2;
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t* src = frame.data.data() + static_cast<size_t>(y) * frame.width * 4;
+        uint8_t* dst = packed.data() + (static_cast<size_t>(top + y) * ThumbnailPyramid::TILE_WIDTH + left) * 2;
+        for (int x = 0; x < width; x++, src += 4, dst += 2) {
+            uint16_t value = static_cast<uint16_t>(((src[0] >> 3) << 11) | ((src[1] >> 2) << 5) | (src[2] >> 3));
+            dst[0] = static_cast<uint8_t>(value & 0xFF);
+            dst[1] = static_cast<uint8_t>(value >> 8);
+        }
+    }
+}
+
+static void UnpackTile(const std::vector<uint8_t>& packed, std::vector<uint8_t>& pixels) {
+    const uint8_t* src = packed.data();
+    uint8_t* dst = pixels.data();
+    for (size_t i = 0; i < PACKED_BYTES / 2; i++, src += 2, dst += 4) {
+        uint16_t value = static_cast<uint16_t>(src[0] | (src[1] << 8));
+        uint8_t r = (value >> 11) & 0x1F;
+        uint8_t g = (value >> 5) & 0x3F;
+        uint8_t b = value & 0x1F;
+        dst[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+        dst[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+        dst[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+        dst[3] = 255;
+    }
+}
+
+ThumbnailPyramid::ThumbnailPyramid()
+    : _mediaSize(0)
+    , _mediaTime(0)
+    , _duration(0.0)
+    , _levels(0)
+    , _stored(0)
+    , _eagerNext(0)
+    , _eagerEnd(0)
+    , _stopping(false)
+    , _file(nullptr)
+    , _decoded(0)
+    , _diskReads(0)
+    , _frame(0)
+{
+}
+
+ThumbnailPyramid::~ThumbnailPyramid() {
+    Close();
+}
+
+bool ThumbnailPyramid::Open(const std::string& mediaPath, double duration, const ThreadPlacement* placement) {
+    Close();
+    if (duration <= 0.0) return false;
+
+    std::error_code error;
+    std::filesystem::path path = std::filesystem::absolute(mediaPath, error);
+    if (error) path = mediaPath;
+    _mediaSize = std::filesystem::file_size(path, error);
+    if (error) _mediaSize = 0;
+    auto modified = std::filesystem::last_write_time(path, error);
+    _mediaTime = error ? 0 : static_cast<int64_t>(modified.time_since_epoch().count());
+
+    _duration = duration;
+    _levels = 1;
+    while (_levels < MAX_LEVELS && GetTileSeconds(_levels) >= MIN_TILE_SECONDS) {
+        _levels++;
+    }
+
+    std::string directory = GetCacheDirectory();
+    std::filesystem::create_directories(directory, error);
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.tvkp",
+             static_cast<unsigned long long>(std::hash<std::string>{}(path.string())));
+    _cachePath = directory + "/" + name;
+
+    int total = GetTotalTiles();
+    _index.assign(total, 0);
+    _requested.assign(total, 0);
+    _wanted.clear();
+    _completed.clear();
+    _stored = 0;
+    _eagerNext = 0;
+    _eagerEnd = GetTileId(std::min(EAGER_LEVELS, _levels), 0);
+    _stopping = false;
+    _decoded = 0;
+    _diskReads = 0;
+
+    _atlas.assign(static_cast<size_t>(ATLAS_SIZE) * ATLAS_SIZE * 4, 0);
+    _slots.assign(ATLAS_SLOTS, Slot());
+    _slotOfTile.clear();
+
+    _worker = std::thread(&ThumbnailPyramid::WorkerLoop, this, path.string(), placement);
+    TVK_LOG_INFO("Thumbnail pyramid: {} levels, {} tiles, finest {:.1f}s, cache {}",
+                 _levels, total, GetTileSeconds(_levels - 1), _cachePath);
+    return true;
+}
+
+void ThumbnailPyramid::Close() {
+    if (_worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _wake.notify_one();
+        _worker.join();
+    }
+
+    _levels = 0;
+    _wanted.clear();
+    _completed.clear();
+    _slotOfTile.clear();
+}
+
+int ThumbnailPyramid::ChooseLevel(double secondsPerTile) const {
+    for (int level = 0; level < _levels; level++) {
+        if (GetTileSeconds(level) <= secondsPerTile) return level;
+    }
+    return std::max(0, _levels - 1);
+}
+
+void ThumbnailPyramid::RequestRange(int level, double start, double end) {
+    if (!IsOpen()) return;
+
+    _candidates.clear();
+    for (int l = std::min(level, _levels - 1); l >= 0; l--) {
+        double seconds = GetTileSeconds(l);
+        int last = GetTileCount(l) - 1;
+        int first = std::clamp(static_cast<int>(start / seconds), 0, last);
+        last = std::clamp(static_cast<int>(end / seconds), 0, last);
+        for (int i = first; i <= last; i++) {
+            int tile = GetTileId(l, i);
+            if (_slotOfTile.find(tile) == _slotOfTile.end()) {
+                _candidates.push_back(tile);
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_candidates == _wanted) return;
+        _wanted.assign(_candidates.begin(), _candidates.end());
+    }
+    _wake.notify_one();
+}
+
+bool ThumbnailPyramid::Update() {
+    _frame++;
+    if (!IsOpen()) return false;
+
+    bool placed = false;
+    for (int i = 0; i < MAX_TILES_PER_UPDATE; i++) {
+        Completed completed;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_completed.empty()) break;
+            completed = std::move(_completed.front());
+            _completed.pop_front();
+            _requested[completed.tile] = 0;
+        }
+        PlaceTile(completed.tile, completed.pixels);
+        placed = true;
+    }
+    return placed;
+}
+
+void ThumbnailPyramid::PlaceTile(int tile, const std::vector<uint8_t>& pixels) {
+    if (_slotOfTile.find(tile) != _slotOfTile.end()) return;
+
+    int slot = 0;
+    for (int i = 1; i < ATLAS_SLOTS; i++) {
+        if (_slots[i].lastUsed < _slots[slot].lastUsed) slot = i;
+    }
+    if (_slots[slot].tile >= 0) {
+        _slotOfTile.erase(_slots[slot].tile);
+    }
+    _slots[slot].tile = tile;
+    _slots[slot].lastUsed = _frame;
+    _slotOfTile[tile] = slot;
+
+    int x = (slot % ATLAS_COLUMNS) * TILE_WIDTH;
+    int y = (slot / ATLAS_COLUMNS) * TILE_HEIGHT;
+    for (int row = 0; row < TILE_HEIGHT; row++) {
+        memcpy(_atlas.data() + (static_cast<size_t>(y + row) * ATLAS_SIZE + x) * 4,
+               pixels.data() + static_cast<size_t>(row) * TILE_WIDTH * 4, TILE_WIDTH * 4);
+    }
+}
+
+bool ThumbnailPyramid::GetTile(int level, int index, PyramidTile& out) {
+    if (!IsOpen()) return false;
+
+    for (int l = std::min(level, _levels - 1); l >= 0; l--, index >>= 1) {
+        auto it = _slotOfTile.find(GetTileId(l, index));
+        if (it == _slotOfTile.end()) continue;
+
+        Slot& slot = _slots[it->second];
+        slot.lastUsed = _frame;
+        int x = (it->second % ATLAS_COLUMNS) * TILE_WIDTH;
+        int y = (it->second / ATLAS_COLUMNS) * TILE_HEIGHT;
+        out.u0 = static_cast<float>(x) / ATLAS_SIZE;
+        out.v0 = static_cast<float>(y) / ATLAS_SIZE;
+        out.u1 = static_cast<float>(x + TILE_WIDTH) / ATLAS_SIZE;
+        out.v1 = static_cast<float>(y + TILE_HEIGHT) / ATLAS_SIZE;
+        out.start = index * GetTileSeconds(l);
+        out.end = out.start + GetTileSeconds(l);
+        out.level = l;
+        return true;
+    }
+    return false;
+}
+
+double ThumbnailPyramid::GetTileTime(int tile) const {
+    int level = 0;
+    while (level + 1 < _levels && tile >= GetTileId(level + 1, 0)) {
+        level++;
+    }
+    int index = tile - GetTileId(level, 0);
+    return (index + 0.5) * GetTileSeconds(level);
+}
+
+int ThumbnailPyramid::PickTile(bool& eager) {
+    for (int pass = 0; pass < 2; pass++) {
+        for (int tile : _wanted) {
+            if (_requested[tile] || (pass == 0 && _index[tile] == 0)) continue;
+            _requested[tile] = 1;
+            eager = false;
+            return tile;
+        }
+    }
+
+    while (_eagerNext < _eagerEnd) {
+        int tile = _eagerNext++;
+        if (_requested[tile] || _index[tile] != 0) continue;
+        _requested[tile] = 1;
+        eager = true;
+        return tile;
+    }
+    return -1;
+}
+
+void ThumbnailPyramid::WorkerLoop(std::string mediaPath, const ThreadPlacement* placement) {
+    if (placement) {
+        placement->Apply(ThreadClass::Background);
+    }
+    ThreadStats::RegisterCurrentThread(ThreadRole::Background);
+
+    LoadCache();
+    TrimCache();
+
+    VideoDecoder decoder;
+    decoder.SetThreadCount(1);
+    bool opened = false;
+    bool triedOpen = false;
+    VideoFrame frame;
+    std::vector<uint8_t> packed(PACKED_BYTES);
+
+    while (true) {
+        int tile = -1;
+        bool eager = false;
+        uint32_t ordinal = 0;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this, &tile, &eager]() { return _stopping || (tile = PickTile(eager)) >= 0; });
+            if (_stopping) break;
+            ordinal = _index[tile];
+        }
+
+        bool loaded = ordinal > 0 && ReadTile(ordinal, packed);
+        if (loaded) {
+            _diskReads++;
+        } else {
+            if (!triedOpen) {
+                triedOpen = true;
+                opened = decoder.Open(mediaPath);
+                if (!opened) {
+                    TVK_LOG_ERROR("Thumbnail pyramid could not open {}", mediaPath);
+                }
+            }
+            loaded = opened && decoder.GetThumbnailAt(GetTileTime(tile), frame, TILE_WIDTH, TILE_HEIGHT);
+            if (loaded) {
+                PackTile(frame, packed);
+                WriteTile(tile, packed);
+                _decoded++;
+            }
+        }
+
+        std::vector<uint8_t> pixels;
+        if (loaded && !eager) {
+            pixels.resize(PIXEL_BYTES);
+            UnpackTile(packed, pixels);
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!loaded) continue;
+        if (eager) {
+            _requested[tile] = 0;
+        } else {
+            _completed.push_back(Completed{ tile, std::move(pixels) });
+        }
+    }
+
+    decoder.Close();
+    if (_file) {
+        fclose(_file);
+        _file = nullptr;
+    }
+}
+
+bool ThumbnailPyramid::LoadCache() {
+    PyramidHeader expected = {};
+    memcpy(expected.magic, "TVKP", 4);
+    expected.version = CACHE_VERSION;
+    expected.tileWidth = TILE_WIDTH;
+    expected.tileHeight = TILE_HEIGHT;
+    expected.baseTiles = BASE_TILES;
+    expected.levels = static_cast<uint32_t>(_levels);
+    expected.mediaSize = _mediaSize;
+    expected.mediaTime = _mediaTime;
+    expected.duration = _duration;
+
+    std::vector<uint32_t> index(GetTotalTiles(), 0);
+    uint32_t stored = 0;
+
+    _file = fopen(_cachePath.c_str(), "r+b");
+    if (_file) {
+        PyramidHeader header = {};
+        bool valid = fread(&header, sizeof(header), 1, _file) == 1 &&
+                     memcmp(&header, &expected, sizeof(header)) == 0 &&
+                     fread(index.data(), sizeof(uint32_t), index.size(), _file) == index.size();
+        if (valid) {
+            for (uint32_t ordinal : index) {
+                stored = std::max(stored, ordinal);
+            }
+        } else {
+            fclose(_file);
+            _file = nullptr;
+            std::fill(index.begin(), index.end(), 0);
+        }
+    }
+
+    if (!_file) {
+        _file = fopen(_cachePath.c_str(), "w+b");
+        if (!_file || fwrite(&expected, sizeof(expected), 1, _file) != 1 ||
+            fwrite(index.data(), sizeof(uint32_t), index.size(), _file) != index.size()) {
+            TVK_LOG_ERROR("Thumbnail pyramid could not create {}", _cachePath);
+            if (_file) {
+                fclose(_file);
+                _file = nullptr;
+            }
+        }
+    }
+
+    // Files are trimmed oldest first, so mark this one as recently used
+    std::error_code error;
+    std::filesystem::last_write_time(_cachePath, std::filesystem::file_time_type::clock::now(), error);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _index.swap(index);
+        _stored = stored;
+    }
+    if (stored > 0) {
+        TVK_LOG_INFO("Thumbnail pyramid: {} cached tiles in {}", stored, _cachePath);
+    }
+    return _file != nullptr;
+}
+
+void ThumbnailPyramid::TrimCache() {
+    struct CacheFile {
+        std::filesystem::path path;
+        std::filesystem::file_time_type used;
+        uint64_t bytes;
+    };
+
+    std::error_code error;
+    std::vector<CacheFile> files;
+    uint64_t total = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(GetCacheDirectory(), error)) {
+        if (entry.path().extension() != ".tvkp") continue;
+        std::error_code fileError;
+        CacheFile file = { entry.path(), entry.last_write_time(fileError), entry.file_size(fileError) };
+        if (fileError) continue;
+        total += file.bytes;
+        files.push_back(file);
+    }
+    if (total <= MAX_CACHE_BYTES) return;
+
+    std::sort(files.begin(), files.end(),
+              [](const CacheFile& a, const CacheFile& b) { return a.used < b.used; });
+    std::filesystem::path current(_cachePath);
+    uint64_t removed = 0;
+    for (const CacheFile& file : files) {
+        if (total - removed <= MAX_CACHE_BYTES) break;
+        if (file.path == current) continue;
+        if (std::filesystem::remove(file.path, error)) {
+            removed += file.bytes;
+        }
+    }
+    TVK_LOG_INFO("Thumbnail cache: removed {} MiB of least recently used pyramids, {} MiB left",
+                 removed >> 20, (total - removed) >> 20);
+}
+
+bool ThumbnailPyramid::ReadTile(uint32_t ordinal, std::vector<uint8_t>& packed) {
+    if (!_file) return false;
+
+    long offset = static_cast<long>(sizeof(PyramidHeader) + GetTotalTiles() * sizeof(uint32_t) +
+                                    (ordinal - 1) * PACKED_BYTES);
+    return fseek(_file, offset, SEEK_SET) == 0 && fread(packed.data(), PACKED_BYTES, 1, _file) == 1;
+}
+
+bool ThumbnailPyramid::WriteTile(int tile, const std::vector<uint8_t>& packed) {
+    if (!_file) return false;
+
+    uint32_t ordinal = _stored + 1;
+    long dataOffset = static_cast<long>(sizeof(PyramidHeader) + GetTotalTiles() * sizeof(uint32_t) +
+                                        _stored * PACKED_BYTES);
+    long indexOffset = static_cast<long>(sizeof(PyramidHeader) + tile * sizeof(uint32_t));
+    if (fseek(_file, dataOffset, SEEK_SET) != 0 || fwrite(packed.data(), PACKED_BYTES, 1, _file) != 1 ||
+        fseek(_file, indexOffset, SEEK_SET) != 0 || fwrite(&ordinal, sizeof(ordinal), 1, _file) != 1) {
+        return false;
+    }
+    fflush(_file);
+    _stored = ordinal;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _index[tile] = ordinal;
+    return true;
+}
+
+} // namespace tvk_media
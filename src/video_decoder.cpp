@@ -1,8 +1,16 @@
 #include "video_decoder.h"
+#include "alloc_tracker.h"
 #include <tinyvk/core/log.h>
+#include <cmath>
 
 namespace tvk_media {
 
+static constexpr double TIMING_SMOOTHING = 0.1;
+
+static double Smooth(double average, double sample) {
+    return average > 0.0 ? average + (sample - average) * TIMING_SMOOTHING : sample;
+}
+
 struct HWAccelConfig {
     AVHWDeviceType deviceType;
     HWAccelType accelType;
@@ -33,13 +41,34 @@ static AVPixelFormat GetHWFormat(AVCodecContext* ctx, const AVPixelFormat* pixFm
     return AV_PIX_FMT_NONE;
 }
 
+static void ExtractFilmGrain(const AVFrame* frame, const AVFrame* sourceFrame, FilmGrain& out) {
+    out.present = false;
+
+    const AVFrameSideData* sideData = av_frame_get_side_data(frame, AV_FRAME_DATA_FILM_GRAIN_PARAMS);
+    if (!sideData || static_cast<size_t>(sideData->size) < sizeof(AVFilmGrainParams)) return;
+
+    const AVFilmGrainParams* params = reinterpret_cast<const AVFilmGrainParams*>(sideData->data);
+    if (params->type != AV_FILM_GRAIN_PARAMS_AV1) return;
+
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(sourceFrame->format));
+    if (!desc) return;
+
+    out.params = *params;
+    out.subsamplingX = desc->log2_chroma_w;
+    out.subsamplingY = desc->log2_chroma_h;
+    out.present = true;
+}
+
 VideoDecoder::VideoDecoder()
     : _formatContext(nullptr)
     , _codecContext(nullptr)
     , _videoStream(nullptr)
     , _swsContext(nullptr)
+    , _thumbSwsContext(nullptr)
     , _frame(nullptr)
     , _swFrame(nullptr)
+    , _sources{}
+    , _nextSource(0)
     , _packet(nullptr)
     , _hwDeviceCtx(nullptr)
     , _videoStreamIndex(-1)
@@ -53,6 +82,20 @@ VideoDecoder::VideoDecoder()
     , _swsSourceFormat(AV_PIX_FMT_NONE)
     , _swsSourceWidth(0)
     , _swsSourceHeight(0)
+    , _threadCount(0)
+    , _forwardSeek(true)
+    , _hasPosition(false)
+    , _scrubbing(false)
+    , _resyncDemuxer(false)
+    , _rawPassthrough(false)
+    , _directConversion(false)
+    , _rawIndex(0)
+    , _skipUntil(-1.0)
+    , _decodeSeconds(0.0)
+    , _seekSeconds(0.0)
+    , _timingSeek(false)
+    , _forwardSeeks(0)
+    , _keyframeSeeks(0)
 {
 }
 
@@ -72,6 +115,16 @@ const char* VideoDecoder::GetHWAccelName() const {
     }
 }
 
+const char* VideoDecoder::GetContainerName() const {
+    if (_sequence.IsOpen()) return "image sequence";
+    return _formatContext && _formatContext->iformat ? _formatContext->iformat->name : "unknown";
+}
+
+const char* VideoDecoder::GetCodecName() const {
+    if (_sequence.IsOpen()) return _sequence.GetCodecName();
+    return _codecContext && _codecContext->codec ? _codecContext->codec->name : "unknown";
+}
+
 bool VideoDecoder::InitHardwareDecoder(const AVCodec* codec) {
     for (const auto& config : g_hwAccelConfigs) {
         for (int i = 0;; i++) {
@@ -112,6 +165,18 @@ bool VideoDecoder::TransferHWFrame(AVFrame* hwFrame, AVFrame* swFrame) {
 bool VideoDecoder::Open(const std::string& filepath) {
     Close();
 
+    if (ImageSequence::IsSequencePath(filepath)) {
+        _sequence.SetWorkerCount(_threadCount);
+        if (_sequence.Open(filepath)) {
+            _width = _sequence.GetWidth();
+            _height = _sequence.GetHeight();
+            _fps = _sequence.GetFPS();
+            _duration = _sequence.GetFrameCount() / _fps;
+            _currentTime = 0.0;
+            return true;
+        }
+    }
+
     if (avformat_open_input(&_formatContext, filepath.c_str(), nullptr, nullptr) < 0) {
         TVK_LOG_ERROR("Failed to open video file: {}", filepath);
         return false;
@@ -164,6 +229,15 @@ bool VideoDecoder::Open(const std::string& filepath) {
         _hwAccelType = HWAccelType::None;
     }
 
+    if (_threadCount > 0) {
+        _codecContext->thread_count = _threadCount;
+        _codecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    }
+
+    if (codecParams->codec_id == AV_CODEC_ID_AV1) {
+        _codecContext->export_side_data |= AV_CODEC_EXPORT_DATA_FILM_GRAIN;
+    }
+
     if (avcodec_open2(_codecContext, codec, nullptr) < 0) {
         TVK_LOG_ERROR("Failed to open codec");
         Close();
@@ -188,14 +262,20 @@ bool VideoDecoder::Open(const std::string& filepath) {
     _frame = av_frame_alloc();
     _swFrame = av_frame_alloc();
     _packet = av_packet_alloc();
+    bool sourcesAllocated = true;
+    for (AVFrame*& source : _sources) {
+        source = av_frame_alloc();
+        sourcesAllocated = sourcesAllocated && source;
+    }
 
-    if (!_frame || !_swFrame || !_packet) {
+    if (!_frame || !_swFrame || !_packet || !sourcesAllocated) {
         TVK_LOG_ERROR("Failed to allocate frame or packet");
         Close();
         return false;
     }
 
     _currentTime = 0.0;
+    _packetCache.SetTimeBase(_videoStream->time_base);
 
     TVK_LOG_INFO("Video opened successfully:");
     TVK_LOG_INFO("  Resolution: {}x{}", _width, _height);
@@ -203,6 +283,9 @@ bool VideoDecoder::Open(const std::string& filepath) {
     TVK_LOG_INFO("  Duration: {} seconds", _duration);
     TVK_LOG_INFO("  Decoder: {}", GetHWAccelName());
 
+    _raw.Open(filepath, _formatContext, _videoStream, RawVideoFile::GetFormat(codecParams));
+    _rawIndex = 0;
+
     return true;
 }
 
@@ -210,15 +293,108 @@ void VideoDecoder::Close() {
     Cleanup();
 }
 
-bool VideoDecoder::DecodeNextFrame(VideoFrame& outFrame) {
-    if (!_formatContext || !_codecContext) {
+// libavcodec fixes the thread count at open, so a new one needs a fresh software decoder.
+// It starts without reference frames; the caller seeks straight after.
+bool VideoDecoder::RestartCodec() {
+    if (!_codecContext || _raw.IsOpen() || _hwAccelType != HWAccelType::None) return false;
+    if (_threadCount <= 0 || _codecContext->thread_count == _threadCount) return false;
+
+    const AVCodec* codec = _codecContext->codec;
+    AVCodecContext* context = avcodec_alloc_context3(codec);
+    if (!context || avcodec_parameters_to_context(context, _videoStream->codecpar) < 0) {
+        avcodec_free_context(&context);
         return false;
     }
+    context->thread_count = _threadCount;
+    context->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    context->export_side_data = _codecContext->export_side_data;
+
+    if (avcodec_open2(context, codec, nullptr) < 0) {
+        TVK_LOG_ERROR("Failed to restart codec with {} threads", _threadCount);
+        avcodec_free_context(&context);
+        return false;
+    }
+
+    avcodec_free_context(&_codecContext);
+    _codecContext = context;
+    TVK_LOG_INFO("Video decoder restarted with {} threads", _threadCount);
+    return true;
+}
+
+int VideoDecoder::ReadPacket() {
+    if (_packetCache.Read(_packet)) return 0;
+    if (_resyncDemuxer) {
+        int ret = ResyncDemuxer();
+        if (ret < 0) return ret;
+    }
 
     while (true) {
         int ret = av_read_frame(_formatContext, _packet);
+        if (ret < 0) {
+            if (ret == AVERROR_EOF) _packetCache.MarkEnd();
+            return ret;
+        }
+        if (_packet->stream_index == _videoStreamIndex) {
+            _packetCache.Append(_packet);
+            return 0;
+        }
+        av_packet_unref(_packet);
+    }
+}
+
+int VideoDecoder::ResyncDemuxer() {
+    _resyncDemuxer = false;
+    int64_t end = _packetCache.GetEndDts();
+    int ret = end == AV_NOPTS_VALUE ? AVERROR(EINVAL)
+                                    : av_seek_frame(_formatContext, _videoStreamIndex, end, AVSEEK_FLAG_BACKWARD);
+    if (ret < 0) {
+        TVK_LOG_ERROR("Could not move the demuxer back to the end of the packet cache");
+        return ret;
+    }
+
+    // Drop packets up to the last cached one so reading continues where the cache ends
+    while ((ret = av_read_frame(_formatContext, _packet)) >= 0) {
+        bool last = _packet->stream_index == _videoStreamIndex && _packet->dts != AV_NOPTS_VALUE && _packet->dts >= end;
+        av_packet_unref(_packet);
+        if (last) return 0;
+    }
+    return ret;
+}
+
+bool VideoDecoder::DecodeNextFrame(VideoFrame& outFrame, double skipBudget) {
+    outFrame.raw = RawFrame();
+    outFrame.source = nullptr;
+
+    if (_sequence.IsOpen()) {
+        if (_skipUntil >= 0.0) {
+            _sequence.Seek(static_cast<int>(std::ceil(_skipUntil * _fps)));
+            _skipUntil = -1.0;
+        }
+        if (!_sequence.Read(outFrame)) return false;
+        _currentTime = outFrame.timestamp;
+        _hasPosition = true;
+        return true;
+    }
+
+    if (!_formatContext || !_codecContext) {
+        return false;
+    }
+
+    if (_raw.IsOpen()) {
+        return ReadRawFrame(outFrame);
+    }
+
+    auto callStart = std::chrono::steady_clock::now();
+    auto frameStart = callStart;
+    while (true) {
+        int ret;
+        {
+            ScopedAllocStage demux(AllocStage::Demux);
+            ret = ReadPacket();
+        }
         
         if (ret < 0) {
+            _skipUntil = -1.0;
             return false;
         }
 
@@ -227,27 +403,61 @@ bool VideoDecoder::DecodeNextFrame(VideoFrame& outFrame) {
             continue;
         }
 
-        ret = avcodec_send_packet(_codecContext, _packet);
-        av_packet_unref(_packet);
+        {
+            // libavcodec refcounts every packet and frame on the heap, so it is counted apart from Decode
+            ScopedAllocStage codec(AllocStage::Codec);
+            ret = avcodec_send_packet(_codecContext, _packet);
+            av_packet_unref(_packet);
+        }
 
         if (ret < 0) {
             TVK_LOG_ERROR("Error sending packet to decoder");
+            _skipUntil = -1.0;
             return false;
         }
 
-        ret = avcodec_receive_frame(_codecContext, _frame);
+        {
+            ScopedAllocStage codec(AllocStage::Codec);
+            ret = avcodec_receive_frame(_codecContext, _frame);
+        }
 
         if (ret == AVERROR(EAGAIN)) {
             continue;
         } else if (ret < 0) {
             TVK_LOG_ERROR("Error receiving frame from decoder");
+            _skipUntil = -1.0;
             return false;
         }
 
+        auto received = std::chrono::steady_clock::now();
+        if (!_scrubbing) {
+            _decodeSeconds = Smooth(_decodeSeconds, std::chrono::duration<double>(received - frameStart).count());
+        }
+        frameStart = received;
+
+        if (_skipUntil >= 0.0 && _frame->pts != AV_NOPTS_VALUE) {
+            double pts = _frame->pts * av_q2d(_videoStream->time_base);
+            if (pts < _skipUntil) {
+                _currentTime = pts;
+                av_frame_unref(_frame);
+                if (skipBudget > 0.0 &&
+                    std::chrono::duration<double>(received - callStart).count() >= skipBudget) {
+                    return false;
+                }
+                continue;
+            }
+        }
+        _skipUntil = -1.0;
+
         AVFrame* sourceFrame = _frame;
         
         if (_hwAccelType != HWAccelType::None && _frame->format == _hwPixelFormat) {
-            if (!TransferHWFrame(_frame, _swFrame)) {
+            bool transferred;
+            {
+                ScopedAllocStage codec(AllocStage::Codec);
+                transferred = TransferHWFrame(_frame, _swFrame);
+            }
+            if (!transferred) {
                 av_frame_unref(_frame);
                 continue;
             }
@@ -256,8 +466,6 @@ bool VideoDecoder::DecodeNextFrame(VideoFrame& outFrame) {
 
         outFrame.width = _width;
         outFrame.height = _height;
-        outFrame.data.resize(_width * _height * 4);
-        memset(outFrame.data.data(), 0, outFrame.data.size());
 
         if (_frame->pts != AV_NOPTS_VALUE) {
             outFrame.timestamp = _frame->pts * av_q2d(_videoStream->time_base);
@@ -266,61 +474,131 @@ bool VideoDecoder::DecodeNextFrame(VideoFrame& outFrame) {
             outFrame.timestamp = _currentTime;
         }
 
-        AVPixelFormat srcFormat = (AVPixelFormat)sourceFrame->format;
-        int srcWidth = sourceFrame->width;
-        int srcHeight = sourceFrame->height;
-        
-        if (!_swsContext || _swsSourceFormat != srcFormat || 
-            _swsSourceWidth != srcWidth || _swsSourceHeight != srcHeight) {
-            if (_swsContext) {
-                sws_freeContext(_swsContext);
-            }
-            _swsContext = sws_getContext(
-                srcWidth, srcHeight, srcFormat,
-                _width, _height, AV_PIX_FMT_RGBA,
-                SWS_BILINEAR, nullptr, nullptr, nullptr
-            );
-            _swsSourceFormat = srcFormat;
-            _swsSourceWidth = srcWidth;
-            _swsSourceHeight = srcHeight;
-        }
+        ExtractFilmGrain(_frame, sourceFrame, outFrame.grain);
 
-        if (!_swsContext) {
-            av_frame_unref(_frame);
-            if (sourceFrame == _swFrame) av_frame_unref(_swFrame);
-            return false;
-        }
+        if (_directConversion) {
+            // The uploader converts straight into its staging buffer later
+            AVFrame* source = _sources[_nextSource];
+            _nextSource = (_nextSource + 1) % MAX_SOURCE_FRAMES;
+            av_frame_unref(source);
+            av_frame_move_ref(source, sourceFrame);
+            outFrame.source = source;
+        } else {
+            if (!PrepareScaler(sourceFrame)) {
+                av_frame_unref(_frame);
+                if (sourceFrame == _swFrame) av_frame_unref(_swFrame);
+                return false;
+            }
 
-        uint8_t* dest[4] = { outFrame.data.data(), nullptr, nullptr, nullptr };
-        int destLinesize[4] = { _width * 4, 0, 0, 0 };
+            outFrame.data.resize(_width * _height * 4);
+            uint8_t* dest[4] = { outFrame.data.data(), nullptr, nullptr, nullptr };
+            int destLinesize[4] = { _width * 4, 0, 0, 0 };
 
-        sws_scale(
-            _swsContext,
-            sourceFrame->data, sourceFrame->linesize,
-            0, srcHeight,
-            dest, destLinesize
-        );
+            sws_scale(
+                _swsContext,
+                sourceFrame->data, sourceFrame->linesize,
+                0, sourceFrame->height,
+                dest, destLinesize
+            );
+        }
 
         av_frame_unref(_frame);
         if (sourceFrame == _swFrame) av_frame_unref(_swFrame);
+        
+        _hasPosition = true;
+        if (_timingSeek) {
+            _seekSeconds = Smooth(_seekSeconds, std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - _seekStart).count());
+            _timingSeek = false;
+        }
         return true;
     }
 }
 
+bool VideoDecoder::PrepareScaler(const AVFrame* source) {
+    AVPixelFormat srcFormat = (AVPixelFormat)source->format;
+    if (_swsContext && _swsSourceFormat == srcFormat &&
+        _swsSourceWidth == source->width && _swsSourceHeight == source->height) {
+        return true;
+    }
+
+    if (_swsContext) {
+        sws_freeContext(_swsContext);
+    }
+    _swsContext = sws_getContext(
+        source->width, source->height, srcFormat,
+        _width, _height, AV_PIX_FMT_RGBA,
+        SWS_BILINEAR, nullptr, nullptr, nullptr
+    );
+    _swsSourceFormat = srcFormat;
+    _swsSourceWidth = source->width;
+    _swsSourceHeight = source->height;
+    return _swsContext != nullptr;
+}
+
+bool VideoDecoder::ConvertFrame(const VideoFrame& frame, uint8_t* dest, size_t pitch) {
+    const AVFrame* source = frame.source;
+    if (!source || !PrepareScaler(source)) return false;
+
+    uint8_t* planes[4] = { dest, nullptr, nullptr, nullptr };
+    int linesize[4] = { static_cast<int>(pitch), 0, 0, 0 };
+    sws_scale(_swsContext, source->data, source->linesize, 0, source->height, planes, linesize);
+    return true;
+}
+
 bool VideoDecoder::Seek(double timeSeconds) {
+    if (_sequence.IsOpen()) {
+        _sequence.Seek(static_cast<int>(std::lround(timeSeconds * _fps)));
+        _currentTime = timeSeconds;
+        _skipUntil = -1.0;
+        return true;
+    }
+
+    if (_raw.IsOpen()) {
+        _rawIndex = _raw.FindFrame(timeSeconds + 0.5 / _fps);
+        _currentTime = _raw.GetFrameTime(_rawIndex);
+        _hasPosition = true;
+        _skipUntil = -1.0;
+        return true;
+    }
+
     if (!_formatContext || !_videoStream) {
         return false;
     }
 
+    if (ShouldDecodeForward(timeSeconds)) {
+        _skipUntil = timeSeconds - 0.5 / _fps;
+        _timingSeek = false;
+        _forwardSeeks++;
+        return true;
+    }
+
     int64_t timestamp = (int64_t)(timeSeconds / av_q2d(_videoStream->time_base));
+    _seekStart = std::chrono::steady_clock::now();
 
-    if (av_seek_frame(_formatContext, _videoStreamIndex, timestamp, AVSEEK_FLAG_BACKWARD) < 0) {
-        TVK_LOG_ERROR("Failed to seek to {:.2f} seconds", timeSeconds);
-        return false;
+    bool detached = _packetCache.IsDetached();
+    if (!_packetCache.Seek(timestamp)) {
+        if (av_seek_frame(_formatContext, _videoStreamIndex, timestamp, AVSEEK_FLAG_BACKWARD) < 0) {
+            TVK_LOG_ERROR("Failed to seek to {:.2f} seconds", timeSeconds);
+            return false;
+        }
+        // Scrub seeks keep the cached packets for the seek that ends the drag
+        if (_scrubbing) {
+            _packetCache.Detach();
+        } else {
+            _packetCache.Clear();
+        }
+        _resyncDemuxer = false;
+    } else if (detached) {
+        _resyncDemuxer = true;
     }
 
     avcodec_flush_buffers(_codecContext);
     _currentTime = timeSeconds;
+    _hasPosition = false;
+    _skipUntil = -1.0;
+    _timingSeek = !_scrubbing;
+    _keyframeSeeks++;
     
     if (_swsContext) {
         sws_freeContext(_swsContext);
@@ -333,78 +611,201 @@ bool VideoDecoder::Seek(double timeSeconds) {
     return true;
 }
 
+void VideoDecoder::SkipTo(double timeSeconds) {
+    if (_fps <= 0.0 || timeSeconds <= _currentTime) return;
+    _skipUntil = timeSeconds - 0.5 / _fps;
+}
+
+void VideoDecoder::SetScrubbing(bool enabled) {
+    if (!_codecContext || _scrubbing == enabled) return;
+
+    _scrubbing = enabled;
+    _codecContext->skip_frame = enabled ? AVDISCARD_NONKEY : AVDISCARD_DEFAULT;
+    _codecContext->skip_loop_filter = enabled ? AVDISCARD_ALL : AVDISCARD_DEFAULT;
+    _hasPosition = false;
+}
+
+double VideoDecoder::GetKeyframeTime(double timeSeconds) const {
+    if (_sequence.IsOpen()) return std::floor(timeSeconds * _fps) / _fps;
+    if (_raw.IsOpen()) return _raw.GetFrameTime(_raw.FindFrame(timeSeconds));
+    if (!_videoStream) return timeSeconds;
+
+    double timeBase = av_q2d(_videoStream->time_base);
+    int64_t keyframe = 0;
+    if (!FindKeyframe(static_cast<int64_t>(timeSeconds / timeBase), keyframe)) return timeSeconds;
+    return keyframe * timeBase;
+}
+
+bool VideoDecoder::FindKeyframe(int64_t timestamp, int64_t& out) const {
+    bool found = _packetCache.FindKeyframe(timestamp, out);
+
+    int index = av_index_search_timestamp(_videoStream, timestamp, AVSEEK_FLAG_BACKWARD);
+    const AVIndexEntry* entry = index >= 0 ? avformat_index_get_entry(_videoStream, index) : nullptr;
+    if (entry && (!found || entry->timestamp > out)) {
+        out = entry->timestamp;
+        found = true;
+    }
+    return found;
+}
+
+bool VideoDecoder::ShouldDecodeForward(double timeSeconds) const {
+    if (!_forwardSeek || _scrubbing || !_hasPosition || _decodeSeconds <= 0.0 || _fps <= 0.0) return false;
+    if (timeSeconds <= _currentTime || timeSeconds > _duration - 2.0 / _fps) return false;
+
+    double framesToKeyframe = (GetKeyframeTime(timeSeconds) - _currentTime) * _fps;
+    return framesToKeyframe * _decodeSeconds <= _seekSeconds;
+}
+
+void VideoDecoder::SetCacheBudget(size_t bytes) {
+    _packetCache.SetBudget(bytes);
+    _sequence.SetBudget(bytes);
+}
+
+bool VideoDecoder::HasFrameReady() {
+    return !_sequence.IsOpen() || _skipUntil >= 0.0 || _sequence.IsReady();
+}
+
+bool VideoDecoder::ReadRawFrame(VideoFrame& outFrame) {
+    if (_skipUntil >= 0.0) {
+        _rawIndex = _raw.FindFrame(_skipUntil);
+        if (_raw.GetFrameTime(_rawIndex) < _skipUntil && _rawIndex + 1 < _raw.GetFrameCount()) _rawIndex++;
+        _skipUntil = -1.0;
+    }
+
+    RawFrame raw;
+    if (!_raw.GetFrame(_rawIndex, raw)) return false;
+
+    if (_rawPassthrough) {
+        outFrame.width = _width;
+        outFrame.height = _height;
+        outFrame.data.clear();
+        outFrame.raw = raw;
+    } else if (!ConvertRawFrame(raw, _swsContext, outFrame, _width, _height)) {
+        return false;
+    }
+
+    outFrame.timestamp = _raw.GetFrameTime(_rawIndex);
+    outFrame.grain.present = false;
+    _currentTime = outFrame.timestamp;
+    _hasPosition = true;
+    _rawIndex++;
+    return true;
+}
+
+bool VideoDecoder::ConvertRawFrame(const RawFrame& raw, SwsContext*& sws, VideoFrame& outFrame, int width, int height) {
+    uint8_t* planes[4];
+    int linesize[4];
+    if (!_raw.GetPlanes(raw, planes, linesize)) return false;
+
+    sws = sws_getCachedContext(
+        sws,
+        _width, _height, _raw.GetPlaneFormat(),
+        width, height, AV_PIX_FMT_RGBA,
+        SWS_BILINEAR, nullptr, nullptr, nullptr
+    );
+    if (!sws) return false;
+
+    const int* coefficients = sws_getCoefficients(raw.bt709 ? SWS_CS_ITU709 : SWS_CS_ITU601);
+    sws_setColorspaceDetails(sws, coefficients, 0, coefficients, 1, 0, 1 << 16, 1 << 16);
+
+    outFrame.width = width;
+    outFrame.height = height;
+    outFrame.data.resize(static_cast<size_t>(width) * height * 4);
+
+    uint8_t* dest[4] = { outFrame.data.data(), nullptr, nullptr, nullptr };
+    int destLinesize[4] = { width * 4, 0, 0, 0 };
+    sws_scale(sws, planes, linesize, 0, _height, dest, destLinesize);
+    return true;
+}
+
+void VideoDecoder::ReleaseCaches() {
+    if (!_codecContext) return;
+
+    avcodec_flush_buffers(_codecContext);
+    av_frame_unref(_frame);
+    av_frame_unref(_swFrame);
+    _packetCache.Trim(0);
+}
+
 bool VideoDecoder::GetThumbnailAt(double timeSeconds, VideoFrame& outFrame, int maxWidth, int maxHeight) {
+    if (_sequence.IsOpen()) {
+        return _sequence.DecodeThumbnail(static_cast<int>(timeSeconds * _fps), outFrame, maxWidth, maxHeight);
+    }
+
     if (!_formatContext || !_videoStream || !_codecContext) {
         return false;
     }
 
+    float aspect = (float)_width / (float)_height;
+    int thumbW = maxWidth;
+    int thumbH = (int)(maxWidth / aspect);
+    if (thumbH > maxHeight) {
+        thumbH = maxHeight;
+        thumbW = (int)(maxHeight * aspect);
+    }
+
+    if (_raw.IsOpen()) {
+        RawFrame raw;
+        if (!_raw.GetFrame(_raw.FindFrame(timeSeconds), raw)) return false;
+        if (!ConvertRawFrame(raw, _thumbSwsContext, outFrame, thumbW, thumbH)) return false;
+        outFrame.timestamp = timeSeconds;
+        return true;
+    }
+
     int64_t timestamp = (int64_t)(timeSeconds / av_q2d(_videoStream->time_base));
     if (av_seek_frame(_formatContext, _videoStreamIndex, timestamp, AVSEEK_FLAG_BACKWARD) < 0) {
         return false;
     }
     avcodec_flush_buffers(_codecContext);
-
-    AVFrame* tempFrame = av_frame_alloc();
-    AVFrame* tempSwFrame = av_frame_alloc();
-    AVPacket* tempPacket = av_packet_alloc();
-    if (!tempFrame || !tempSwFrame || !tempPacket) {
-        if (tempFrame) av_frame_free(&tempFrame);
-        if (tempSwFrame) av_frame_free(&tempSwFrame);
-        if (tempPacket) av_packet_free(&tempPacket);
-        return false;
-    }
+    _packetCache.Clear();
+    _resyncDemuxer = false;
+    _hasPosition = false;
+    _skipUntil = -1.0;
 
     bool gotFrame = false;
     int attempts = 0;
     while (attempts < 50 && !gotFrame) {
-        int ret = av_read_frame(_formatContext, tempPacket);
+        int ret;
+        {
+            ScopedAllocStage demux(AllocStage::Demux);
+            ret = av_read_frame(_formatContext, _packet);
+        }
         if (ret < 0) break;
 
-        if (tempPacket->stream_index == _videoStreamIndex) {
-            ret = avcodec_send_packet(_codecContext, tempPacket);
+        if (_packet->stream_index == _videoStreamIndex) {
+            ret = avcodec_send_packet(_codecContext, _packet);
             if (ret >= 0) {
-                ret = avcodec_receive_frame(_codecContext, tempFrame);
+                ret = avcodec_receive_frame(_codecContext, _frame);
                 if (ret >= 0) {
                     gotFrame = true;
                 }
             }
         }
-        av_packet_unref(tempPacket);
+        av_packet_unref(_packet);
         attempts++;
     }
 
     if (!gotFrame) {
-        av_frame_free(&tempFrame);
-        av_frame_free(&tempSwFrame);
-        av_packet_free(&tempPacket);
         return false;
     }
 
-    AVFrame* sourceFrame = tempFrame;
-    if (_hwAccelType != HWAccelType::None && tempFrame->format == _hwPixelFormat) {
-        if (av_hwframe_transfer_data(tempSwFrame, tempFrame, 0) >= 0) {
-            sourceFrame = tempSwFrame;
+    AVFrame* sourceFrame = _frame;
+    if (_hwAccelType != HWAccelType::None && _frame->format == _hwPixelFormat) {
+        if (av_hwframe_transfer_data(_swFrame, _frame, 0) >= 0) {
+            sourceFrame = _swFrame;
         }
     }
 
-    float aspect = (float)_width / (float)_height;
-    int thumbW = maxWidth;
-    int thumbH = (int)(maxWidth / aspect);
-    if (thumbH > maxHeight) {
-        thumbH = maxHeight;
-        thumbW = (int)(maxHeight * aspect);
-    }
-
-    SwsContext* thumbSws = sws_getContext(
+    _thumbSwsContext = sws_getCachedContext(
+        _thumbSwsContext,
         _width, _height, (AVPixelFormat)sourceFrame->format,
         thumbW, thumbH, AV_PIX_FMT_RGBA,
         SWS_BILINEAR, nullptr, nullptr, nullptr
     );
 
-    if (!thumbSws) {
-        av_frame_free(&tempFrame);
-        av_frame_free(&tempSwFrame);
-        av_packet_free(&tempPacket);
+    if (!_thumbSwsContext) {
+        av_frame_unref(_frame);
+        av_frame_unref(_swFrame);
         return false;
     }
 
@@ -416,17 +817,21 @@ bool VideoDecoder::GetThumbnailAt(double timeSeconds, VideoFrame& outFrame, int
     uint8_t* dest[4] = { outFrame.data.data(), nullptr, nullptr, nullptr };
     int destLinesize[4] = { thumbW * 4, 0, 0, 0 };
 
-    sws_scale(thumbSws, sourceFrame->data, sourceFrame->linesize, 0, _height, dest, destLinesize);
+    sws_scale(_thumbSwsContext, sourceFrame->data, sourceFrame->linesize, 0, _height, dest, destLinesize);
 
-    sws_freeContext(thumbSws);
-    av_frame_free(&tempFrame);
-    av_frame_free(&tempSwFrame);
-    av_packet_free(&tempPacket);
+    av_frame_unref(_frame);
+    av_frame_unref(_swFrame);
 
     return true;
 }
 
 void VideoDecoder::Cleanup() {
+    _packetCache.Clear();
+    _resyncDemuxer = false;
+    _sequence.Close();
+    _raw.Close();
+    _rawIndex = 0;
+
     if (_swsContext) {
         sws_freeContext(_swsContext);
         _swsContext = nullptr;
@@ -442,6 +847,16 @@ void VideoDecoder::Cleanup() {
         _swFrame = nullptr;
     }
 
+    for (AVFrame*& source : _sources) {
+        av_frame_free(&source);
+    }
+    _nextSource = 0;
+
+    if (_thumbSwsContext) {
+        sws_freeContext(_thumbSwsContext);
+        _thumbSwsContext = nullptr;
+    }
+
     if (_packet) {
         av_packet_free(&_packet);
         _packet = nullptr;
@@ -464,6 +879,10 @@ void VideoDecoder::Cleanup() {
 
     _videoStream = nullptr;
     _videoStreamIndex = -1;
+    _hasPosition = false;
+    _scrubbing = false;
+    _skipUntil = -1.0;
+    _timingSeek = false;
     _width = 0;
     _height = 0;
     _fps = 0.0;
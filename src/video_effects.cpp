@@ -1,5 +1,4 @@
 #include "video_effects.h"
-#include <tinyvk/renderer/shader_compiler.h>
 #include <tinyvk/renderer/renderer.h>
 #include <tinyvk/core/log.h>
 
@@ -39,7 +38,7 @@ layout(push_constant) uniform PushConstants {
     float scanlines;
     float vintageStrength;
     
-    int vintageEnabled;
+    int step;
     int width;
     int height;
     int frameCounter;
@@ -47,9 +46,35 @@ layout(push_constant) uniform PushConstants {
     float bloom;
     float bloomThreshold;
     float bloomRadius;
-    int pad0;
+    int stabilize;
+    
+    float stabDx;
+    float stabDy;
+    float stabAngle;
+    float stabZoom;
 } pc;
 
+vec4 load_source(ivec2 coord) {
+    ivec2 maxCoord = ivec2(pc.width - 1, pc.height - 1);
+    if (pc.stabilize == 0) {
+        return imageLoad(sourceImage, clamp(coord, ivec2(0), maxCoord));
+    }
+    
+    vec2 center = vec2(pc.width, pc.height) * 0.5;
+    vec2 p = (vec2(coord) + 0.5 - center) / pc.stabZoom - vec2(pc.stabDx, pc.stabDy);
+    float c = cos(pc.stabAngle);
+    float s = sin(pc.stabAngle);
+    vec2 src = center + vec2(c * p.x + s * p.y, -s * p.x + c * p.y) - 0.5;
+    
+    ivec2 base = ivec2(floor(src));
+    vec2 f = src - vec2(base);
+    vec4 p00 = imageLoad(sourceImage, clamp(base, ivec2(0), maxCoord));
+    vec4 p10 = imageLoad(sourceImage, clamp(base + ivec2(1, 0), ivec2(0), maxCoord));
+    vec4 p01 = imageLoad(sourceImage, clamp(base + ivec2(0, 1), ivec2(0), maxCoord));
+    vec4 p11 = imageLoad(sourceImage, clamp(base + ivec2(1, 1), ivec2(0), maxCoord));
+    return mix(mix(p00, p10, f.x), mix(p01, p11, f.x), f.y);
+}
+
 vec3 rgb_to_hsl(vec3 rgb) {
     float maxC = max(rgb.r, max(rgb.g, rgb.b));
     float minC = min(rgb.r, min(rgb.g, rgb.b));
@@ -175,29 +200,29 @@ vec3 apply_filter(vec3 color, ivec2 coord) {
     
     if (pc.filterType == 7) {
         vec3 sum = vec3(0.0);
-        sum += imageLoad(sourceImage, coord + ivec2(-1, -1)).rgb * 0.0;
-        sum += imageLoad(sourceImage, coord + ivec2( 0, -1)).rgb * -1.0;
-        sum += imageLoad(sourceImage, coord + ivec2( 1, -1)).rgb * 0.0;
-        sum += imageLoad(sourceImage, coord + ivec2(-1,  0)).rgb * -1.0;
-        sum += imageLoad(sourceImage, coord + ivec2( 0,  0)).rgb * 5.0;
-        sum += imageLoad(sourceImage, coord + ivec2( 1,  0)).rgb * -1.0;
-        sum += imageLoad(sourceImage, coord + ivec2(-1,  1)).rgb * 0.0;
-        sum += imageLoad(sourceImage, coord + ivec2( 0,  1)).rgb * -1.0;
-        sum += imageLoad(sourceImage, coord + ivec2( 1,  1)).rgb * 0.0;
+        sum += load_source(coord + ivec2(-1, -1)).rgb * 0.0;
+        sum += load_source(coord + ivec2( 0, -1)).rgb * -1.0;
+        sum += load_source(coord + ivec2( 1, -1)).rgb * 0.0;
+        sum += load_source(coord + ivec2(-1,  0)).rgb * -1.0;
+        sum += load_source(coord + ivec2( 0,  0)).rgb * 5.0;
+        sum += load_source(coord + ivec2( 1,  0)).rgb * -1.0;
+        sum += load_source(coord + ivec2(-1,  1)).rgb * 0.0;
+        sum += load_source(coord + ivec2( 0,  1)).rgb * -1.0;
+        sum += load_source(coord + ivec2( 1,  1)).rgb * 0.0;
         return clamp(sum, 0.0, 1.0);
     }
     
     if (pc.filterType == 8) {
         vec3 sum = vec3(0.0);
-        sum += imageLoad(sourceImage, coord + ivec2(-1, -1)).rgb * -1.0;
-        sum += imageLoad(sourceImage, coord + ivec2( 0, -1)).rgb * -1.0;
-        sum += imageLoad(sourceImage, coord + ivec2( 1, -1)).rgb * -1.0;
-        sum += imageLoad(sourceImage, coord + ivec2(-1,  0)).rgb * -1.0;
-        sum += imageLoad(sourceImage, coord + ivec2( 0,  0)).rgb * 8.0;
-        sum += imageLoad(sourceImage, coord + ivec2( 1,  0)).rgb * -1.0;
-        sum += imageLoad(sourceImage, coord + ivec2(-1,  1)).rgb * -1.0;
-        sum += imageLoad(sourceImage, coord + ivec2( 0,  1)).rgb * -1.0;
-        sum += imageLoad(sourceImage, coord + ivec2( 1,  1)).rgb * -1.0;
+        sum += load_source(coord + ivec2(-1, -1)).rgb * -1.0;
+        sum += load_source(coord + ivec2( 0, -1)).rgb * -1.0;
+        sum += load_source(coord + ivec2( 1, -1)).rgb * -1.0;
+        sum += load_source(coord + ivec2(-1,  0)).rgb * -1.0;
+        sum += load_source(coord + ivec2( 0,  0)).rgb * 8.0;
+        sum += load_source(coord + ivec2( 1,  0)).rgb * -1.0;
+        sum += load_source(coord + ivec2(-1,  1)).rgb * -1.0;
+        sum += load_source(coord + ivec2( 0,  1)).rgb * -1.0;
+        sum += load_source(coord + ivec2( 1,  1)).rgb * -1.0;
         return clamp(sum, 0.0, 1.0);
     }
     
@@ -206,7 +231,7 @@ vec3 apply_filter(vec3 color, ivec2 coord) {
 
 vec3 sample_bloom(ivec2 coord, int scale) {
     ivec2 sampleCoord = clamp(coord, ivec2(0), ivec2(pc.width - 1, pc.height - 1));
-    vec3 col = imageLoad(sourceImage, sampleCoord).rgb;
+    vec3 col = load_source(sampleCoord).rgb;
     float lum = dot(col, vec3(0.299, 0.587, 0.114));
     if (lum > pc.bloomThreshold) {
         return max(col - pc.bloomThreshold, vec3(0.0));
@@ -234,25 +259,28 @@ vec3 blur_at_scale(ivec2 coord, int scale) {
     return accum / max(totalWeight, 0.001);
 }
 
-vec3 apply_post_process(vec3 color, ivec2 coord) {
+vec3 compute_bloom(ivec2 coord) {
+    vec3 bloomAccum = vec3(0.0);
+    
+    float mipWeights[6] = float[](0.5, 0.3, 0.15, 0.1, 0.05, 0.025);
+    int scales[6] = int[](1, 2, 4, 8, 16, 32);
+    int numMips = int(pc.bloomRadius);
+    numMips = clamp(numMips, 1, 6);
+    
+    float totalWeight = 0.0;
+    for (int m = 0; m < numMips; m++) {
+        bloomAccum += blur_at_scale(coord, scales[m]) * mipWeights[m];
+        totalWeight += mipWeights[m];
+    }
+    
+    return bloomAccum / totalWeight;
+}
+
+vec3 apply_post_process(vec3 color, ivec2 coord, vec3 bloom) {
     vec2 uv = vec2(coord) / vec2(pc.width, pc.height);
     
     if (pc.bloom > 0.0) {
-        vec3 bloomAccum = vec3(0.0);
-        
-        float mipWeights[6] = float[](0.5, 0.3, 0.15, 0.1, 0.05, 0.025);
-        int scales[6] = int[](1, 2, 4, 8, 16, 32);
-        int numMips = int(pc.bloomRadius);
-        numMips = clamp(numMips, 1, 6);
-        
-        float totalWeight = 0.0;
-        for (int m = 0; m < numMips; m++) {
-            bloomAccum += blur_at_scale(coord, scales[m]) * mipWeights[m];
-            totalWeight += mipWeights[m];
-        }
-        
-        bloomAccum /= totalWeight;
-        color += bloomAccum * pc.bloom;
+        color += bloom * pc.bloom;
     }
     
     if (pc.chromaticAberration > 0.0) {
@@ -270,11 +298,11 @@ vec3 apply_post_process(vec3 color, ivec2 coord) {
         ivec2 bCoord = ivec2(vec2(coord) + bOffset);
         rCoord = clamp(rCoord, ivec2(0), ivec2(pc.width - 1, pc.height - 1));
         bCoord = clamp(bCoord, ivec2(0), ivec2(pc.width - 1, pc.height - 1));
-        color.r = imageLoad(sourceImage, rCoord).r;
-        color.b = imageLoad(sourceImage, bCoord).b;
+        color.r = load_source(rCoord).r;
+        color.b = load_source(bCoord).b;
     }
     
-    if (pc.vintageEnabled != 0) {
+    if (pc.vintageStrength > 0.0) {
         vec3 vintage = vec3(
             0.9 * color.r + 0.05 * color.g + 0.05 * color.b + 0.05,
             0.05 * color.r + 0.85 * color.g + 0.05 * color.b + 0.02,
@@ -309,39 +337,47 @@ vec3 apply_post_process(vec3 color, ivec2 coord) {
 }
 
 void main() {
-    ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+    // Each invocation shades a step x step block; bloom, the costly neighbourhood term, is sampled once per block
+    ivec2 block = ivec2(gl_GlobalInvocationID.xy) * pc.step;
     
-    if (coord.x >= pc.width || coord.y >= pc.height) {
+    if (block.x >= pc.width || block.y >= pc.height) {
         return;
     }
     
-    vec4 pixel = imageLoad(sourceImage, coord);
-    vec3 color = pixel.rgb;
-    
-    color = apply_color_adjustments(color);
-    color = apply_filter(color, coord);
-    color = apply_post_process(color, coord);
-    
-    imageStore(outputImage, coord, vec4(color, pixel.a));
+    vec3 bloom = vec3(0.0);
+    if (pc.bloom > 0.0) {
+        bloom = compute_bloom(min(block + ivec2(pc.step / 2), ivec2(pc.width - 1, pc.height - 1)));
+    }
+    
+    for (int y = 0; y < pc.step; y++) {
+        for (int x = 0; x < pc.step; x++) {
+            ivec2 coord = block + ivec2(x, y);
+            if (coord.x >= pc.width || coord.y >= pc.height) continue;
+            
+            vec4 pixel = load_source(coord);
+            vec3 color = pixel.rgb;
+            
+            color = apply_color_adjustments(color);
+            color = apply_filter(color, coord);
+            color = apply_post_process(color, coord, bloom);
+            
+            imageStore(outputImage, coord, vec4(color, pixel.a));
+        }
+    }
 }
 )";
 
 VideoEffects::VideoEffects()
     : _renderer(nullptr)
     , _context(nullptr)
-    , _computePipeline(VK_NULL_HANDLE)
-    , _pipelineLayout(VK_NULL_HANDLE)
-    , _descriptorSetLayout(VK_NULL_HANDLE)
     , _descriptorSet(VK_NULL_HANDLE)
-    , _shaderModule(VK_NULL_HANDLE)
-    , _stagingImage(VK_NULL_HANDLE)
-    , _stagingMemory(VK_NULL_HANDLE)
-    , _stagingImageView(VK_NULL_HANDLE)
-    , _stagingWidth(0)
-    , _stagingHeight(0)
     , _lastSrcView(VK_NULL_HANDLE)
     , _lastDstView(VK_NULL_HANDLE)
     , _frameCounter(0)
+    , _step(1)
+    , _pipelineReady(false)
+    , _pipelineFailed(false)
+    , _filmGrainFailed(false)
     , _initialized(false)
 {
 }
@@ -355,143 +391,59 @@ bool VideoEffects::Init(tvk::Renderer* renderer) {
     
     _renderer = renderer;
     _context = &renderer->GetContext();
+    _initialized = true;
+    return true;
+}
+
+bool VideoEffects::EnsurePipeline() {
+    if (_pipelineReady) return true;
+    if (!_initialized || _pipelineFailed) return false;
     
-    if (!CreateDescriptorSetLayout()) {
-        TVK_LOG_ERROR("Failed to create descriptor set layout for video effects");
-        return false;
-    }
-    
-    if (!CreateComputePipeline()) {
+    if (!CreateComputePipeline(_renderer, g_effectsComputeShader, "video_effects", 2, 0,
+                               sizeof(EffectsPushConstants), _pipeline)) {
         TVK_LOG_ERROR("Failed to create compute pipeline for video effects");
+        _pipelineFailed = true;
         return false;
     }
     
-    if (!AllocateDescriptorSet()) {
+    if (!AllocateDescriptorSet(_context, _pipeline, _descriptorSet)) {
         TVK_LOG_ERROR("Failed to allocate descriptor set for video effects");
+        _pipelineFailed = true;
         return false;
     }
     
-    _initialized = true;
+    _pipelineReady = true;
     TVK_LOG_INFO("Video effects GPU pipeline initialized");
     return true;
 }
 
-void VideoEffects::Cleanup() {
-    if (!_context) return;
+bool VideoEffects::EnsureFilmGrain() {
+    if (!_initialized || _filmGrainFailed) return false;
     
-    VkDevice device = _context->GetDevice();
-    if (!device) return;
-    
-    vkDeviceWaitIdle(device);
-    
-    DestroyStagingImage();
-    
-    if (_computePipeline != VK_NULL_HANDLE) {
-        vkDestroyPipeline(device, _computePipeline, nullptr);
-        _computePipeline = VK_NULL_HANDLE;
-    }
-    
-    if (_pipelineLayout != VK_NULL_HANDLE) {
-        vkDestroyPipelineLayout(device, _pipelineLayout, nullptr);
-        _pipelineLayout = VK_NULL_HANDLE;
-    }
-    
-    if (_shaderModule != VK_NULL_HANDLE) {
-        vkDestroyShaderModule(device, _shaderModule, nullptr);
-        _shaderModule = VK_NULL_HANDLE;
-    }
-    
-    if (_descriptorSetLayout != VK_NULL_HANDLE) {
-        vkDestroyDescriptorSetLayout(device, _descriptorSetLayout, nullptr);
-        _descriptorSetLayout = VK_NULL_HANDLE;
-    }
-    
-    _initialized = false;
-}
-
-bool VideoEffects::CreateDescriptorSetLayout() {
-    VkDescriptorSetLayoutBinding bindings[2]{};
-    
-    bindings[0].binding = 0;
-    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    bindings[0].descriptorCount = 1;
-    bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-    bindings[0].pImmutableSamplers = nullptr;
-    
-    bindings[1].binding = 1;
-    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    bindings[1].descriptorCount = 1;
-    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-    bindings[1].pImmutableSamplers = nullptr;
-    
-    VkDescriptorSetLayoutCreateInfo layoutInfo{};
-    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = 2;
-    layoutInfo.pBindings = bindings;
-    
-    if (vkCreateDescriptorSetLayout(_context->GetDevice(), &layoutInfo, nullptr, &_descriptorSetLayout) != VK_SUCCESS) {
+    if (!_filmGrain.Init(_renderer)) {
+        TVK_LOG_ERROR("Film grain synthesis unavailable");
+        _filmGrainFailed = true;
         return false;
     }
-    
     return true;
 }
 
-bool VideoEffects::CreateComputePipeline() {
-    _shaderModule = tvk::ShaderCompiler::CreateShaderModuleFromGLSL(
-        _renderer, g_effectsComputeShader, tvk::ShaderStage::Compute, "video_effects"
-    );
-    
-    if (_shaderModule == VK_NULL_HANDLE) {
-        TVK_LOG_ERROR("Failed to compile video effects compute shader");
-        return false;
-    }
-    
-    VkPushConstantRange pushConstantRange{};
-    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-    pushConstantRange.offset = 0;
-    pushConstantRange.size = sizeof(EffectsPushConstants);
-    
-    VkPipelineLayoutCreateInfo layoutInfo{};
-    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    layoutInfo.setLayoutCount = 1;
-    layoutInfo.pSetLayouts = &_descriptorSetLayout;
-    layoutInfo.pushConstantRangeCount = 1;
-    layoutInfo.pPushConstantRanges = &pushConstantRange;
-    
-    if (vkCreatePipelineLayout(_context->GetDevice(), &layoutInfo, nullptr, &_pipelineLayout) != VK_SUCCESS) {
-        return false;
-    }
-    
-    VkPipelineShaderStageCreateInfo stageInfo{};
-    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-    stageInfo.module = _shaderModule;
-    stageInfo.pName = "main";
+void VideoEffects::Cleanup() {
+    if (!_context) return;
     
-    VkComputePipelineCreateInfo pipelineInfo{};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-    pipelineInfo.stage = stageInfo;
-    pipelineInfo.layout = _pipelineLayout;
+    VkDevice device = _context->GetDevice();
+    if (!device) return;
     
-    if (vkCreateComputePipelines(_context->GetDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &_computePipeline) != VK_SUCCESS) {
-        return false;
-    }
+    vkDeviceWaitIdle(device);
     
-    return true;
-}
-
-bool VideoEffects::AllocateDescriptorSet() {
-    VkDescriptorSetAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = _context->GetDescriptorPool();
-    allocInfo.descriptorSetCount = 1;
-    allocInfo.pSetLayouts = &_descriptorSetLayout;
-    
-    if (vkAllocateDescriptorSets(_context->GetDevice(), &allocInfo, &_descriptorSet) != VK_SUCCESS) {
-        return false;
-    }
+    _filmGrain.Cleanup();
+    DestroyStorageImage(device, _staging);
+    DestroyComputePipeline(device, _pipeline);
     
-    return true;
+    _pipelineReady = false;
+    _pipelineFailed = false;
+    _filmGrainFailed = false;
+    _initialized = false;
 }
 
 void VideoEffects::UpdateDescriptorSet(VkImageView srcView, VkImageView dstView) {
@@ -499,188 +451,97 @@ void VideoEffects::UpdateDescriptorSet(VkImageView srcView, VkImageView dstView)
     _lastSrcView = srcView;
     _lastDstView = dstView;
     
-    VkDescriptorImageInfo imageInfos[2]{};
-    imageInfos[0].imageView = srcView;
-    imageInfos[0].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-    imageInfos[1].imageView = dstView;
-    imageInfos[1].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-    
-    VkWriteDescriptorSet writes[2]{};
-    writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[0].dstSet = _descriptorSet;
-    writes[0].dstBinding = 0;
-    writes[0].dstArrayElement = 0;
-    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    writes[0].descriptorCount = 1;
-    writes[0].pImageInfo = &imageInfos[0];
-    
-    writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[1].dstSet = _descriptorSet;
-    writes[1].dstBinding = 1;
-    writes[1].dstArrayElement = 0;
-    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    writes[1].descriptorCount = 1;
-    writes[1].pImageInfo = &imageInfos[1];
-    
-    vkUpdateDescriptorSets(_context->GetDevice(), 2, writes, 0, nullptr);
-}
-
-bool VideoEffects::CreateStagingImage(uint32_t width, uint32_t height) {
-    if (_stagingImage != VK_NULL_HANDLE && _stagingWidth == width && _stagingHeight == height) {
-        return true;
-    }
-    
-    DestroyStagingImage();
-    
-    VkDevice device = _context->GetDevice();
-    
-    VkImageCreateInfo imageInfo{};
-    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
-    imageInfo.extent.width = width;
-    imageInfo.extent.height = height;
-    imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
-    imageInfo.arrayLayers = 1;
-    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    
-    if (vkCreateImage(device, &imageInfo, nullptr, &_stagingImage) != VK_SUCCESS) {
-        return false;
-    }
-    
-    VkMemoryRequirements memReqs;
-    vkGetImageMemoryRequirements(device, _stagingImage, &memReqs);
-    
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memReqs.size;
-    allocInfo.memoryTypeIndex = _context->FindMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-    
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &_stagingMemory) != VK_SUCCESS) {
-        vkDestroyImage(device, _stagingImage, nullptr);
-        _stagingImage = VK_NULL_HANDLE;
-        return false;
-    }
-    
-    vkBindImageMemory(device, _stagingImage, _stagingMemory, 0);
-    
-    VkImageViewCreateInfo viewInfo{};
-    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    viewInfo.image = _stagingImage;
-    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
-    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = 1;
-    viewInfo.subresourceRange.baseArrayLayer = 0;
-    viewInfo.subresourceRange.layerCount = 1;
-    
-    if (vkCreateImageView(device, &viewInfo, nullptr, &_stagingImageView) != VK_SUCCESS) {
-        vkFreeMemory(device, _stagingMemory, nullptr);
-        vkDestroyImage(device, _stagingImage, nullptr);
-        _stagingImage = VK_NULL_HANDLE;
-        _stagingMemory = VK_NULL_HANDLE;
-        return false;
-    }
-    
-    _stagingWidth = width;
-    _stagingHeight = height;
-    _lastSrcView = VK_NULL_HANDLE;
-    _lastDstView = VK_NULL_HANDLE;
-    
-    return true;
-}
-
-void VideoEffects::DestroyStagingImage() {
-    VkDevice device = _context->GetDevice();
-    
-    if (_stagingImageView != VK_NULL_HANDLE) {
-        vkDestroyImageView(device, _stagingImageView, nullptr);
-        _stagingImageView = VK_NULL_HANDLE;
-    }
-    
-    if (_stagingImage != VK_NULL_HANDLE) {
-        vkDestroyImage(device, _stagingImage, nullptr);
-        _stagingImage = VK_NULL_HANDLE;
-    }
-    
-    if (_stagingMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(device, _stagingMemory, nullptr);
-        _stagingMemory = VK_NULL_HANDLE;
-    }
-    
-    _stagingWidth = 0;
-    _stagingHeight = 0;
+    VkImageView views[2] = { srcView, dstView };
+    WriteStorageImages(_context->GetDevice(), _descriptorSet, views, 2);
 }
 
 bool VideoEffects::HasActiveEffects() const {
-    return !_colorAdjust.IsDefault() || !_filter.IsDefault() || !_postProcess.IsDefault();
+    return !_colorAdjust.IsDefault() || !_filter.IsDefault() || !_postProcess.IsDefault() ||
+           !_stabilization.IsDefault();
 }
 
 void VideoEffects::ResetAll() {
     _colorAdjust.Reset();
     _filter.Reset();
     _postProcess.Reset();
+    _stabilization.Reset();
+    _stabTransform = StabilizationTransform();
+    _filmGrain.GetSettings().Reset();
+}
+
+void VideoEffects::SetFilmGrain(const FilmGrain& grain, int width, int height) {
+    if (grain.present && _filmGrain.GetSettings().enabled) {
+        EnsureFilmGrain();
+    }
+    _filmGrain.Prepare(grain, width, height);
 }
 
 void VideoEffects::ProcessFrame(tvk::Texture* texture) {
-    if (!_initialized || !texture || !HasActiveEffects()) return;
+    if (!_initialized || !texture) return;
     
-    _frameCounter++;
+    bool effectsActive = HasActiveEffects() && EnsurePipeline();
+    bool grainActive = _filmGrain.IsActive();
+    if (!effectsActive && !grainActive) return;
     
     uint32_t width = texture->GetWidth();
     uint32_t height = texture->GetHeight();
     
-    if (!CreateStagingImage(width, height)) {
+    if (!effectsActive) {
+        VkCommandBuffer cmd = _context->BeginSingleTimeCommands();
+        TransitionImage(cmd, texture->GetImage(),
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL,
+            VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        _filmGrain.Record(cmd, texture);
+        TransitionImage(cmd, texture->GetImage(),
+            VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        _context->EndSingleTimeCommands(cmd);
+        return;
+    }
+    
+    _frameCounter++;
+    
+    VkImage stagingBefore = _staging.image;
+    if (!CreateStorageImage(_context, width, height,
+                            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, _staging)) {
         TVK_LOG_ERROR("Failed to create staging image for video effects");
         return;
     }
+    if (_staging.image != stagingBefore) {
+        _lastSrcView = VK_NULL_HANDLE;
+        _lastDstView = VK_NULL_HANDLE;
+    }
     
-    UpdateDescriptorSet(_stagingImageView, texture->GetImageView());
+    UpdateDescriptorSet(_staging.view, texture->GetImageView());
     
     VkCommandBuffer cmd = _context->BeginSingleTimeCommands();
     
-    VkImageMemoryBarrier barriers[2]{};
-    
-    barriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barriers[0].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    barriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barriers[0].image = texture->GetImage();
-    barriers[0].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barriers[0].subresourceRange.baseMipLevel = 0;
-    barriers[0].subresourceRange.levelCount = 1;
-    barriers[0].subresourceRange.baseArrayLayer = 0;
-    barriers[0].subresourceRange.layerCount = 1;
-    barriers[0].srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-    
-    barriers[1].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barriers[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barriers[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barriers[1].image = _stagingImage;
-    barriers[1].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barriers[1].subresourceRange.baseMipLevel = 0;
-    barriers[1].subresourceRange.levelCount = 1;
-    barriers[1].subresourceRange.baseArrayLayer = 0;
-    barriers[1].subresourceRange.layerCount = 1;
-    barriers[1].srcAccessMask = 0;
-    barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    
-    vkCmdPipelineBarrier(
-        cmd,
+    if (grainActive) {
+        TransitionImage(cmd, texture->GetImage(),
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL,
+            VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        _filmGrain.Record(cmd, texture);
+        TransitionImage(cmd, texture->GetImage(),
+            VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    } else {
+        TransitionImage(cmd, texture->GetImage(),
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT);
+    }
+    TransitionImage(cmd, _staging.image,
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        0, VK_ACCESS_TRANSFER_WRITE_BIT,
         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        0, 0, nullptr, 0, nullptr, 2, barriers
-    );
+        VK_PIPELINE_STAGE_TRANSFER_BIT);
     
     VkImageCopy copyRegion{};
     copyRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -698,29 +559,21 @@ void VideoEffects::ProcessFrame(tvk::Texture* texture) {
     vkCmdCopyImage(
         cmd,
         texture->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-        _stagingImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        _staging.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
         1, &copyRegion
     );
     
-    barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    barriers[0].newLayout = VK_IMAGE_LAYOUT_GENERAL;
-    barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-    barriers[0].dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    TransitionImage(cmd, texture->GetImage(),
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL,
+        VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    TransitionImage(cmd, _staging.image,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL,
+        VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
     
-    barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barriers[1].newLayout = VK_IMAGE_LAYOUT_GENERAL;
-    barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    
-    vkCmdPipelineBarrier(
-        cmd,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        0, 0, nullptr, 0, nullptr, 2, barriers
-    );
-    
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _computePipeline);
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _pipelineLayout, 0, 1, &_descriptorSet, 0, nullptr);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline.pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline.layout, 0, 1, &_descriptorSet, 0, nullptr);
     
     EffectsPushConstants pc{};
     pc.brightness = _colorAdjust.brightness;
@@ -742,35 +595,31 @@ void VideoEffects::ProcessFrame(tvk::Texture* texture) {
     pc.filmGrain = _postProcess.filmGrain;
     pc.chromaticAberration = _postProcess.chromaticAberration;
     pc.scanlines = _postProcess.scanlines;
-    pc.vintageStrength = _postProcess.vintageStrength;
-    pc.vintageEnabled = _postProcess.vintageEnabled ? 1 : 0;
+    pc.vintageStrength = _postProcess.vintageEnabled ? _postProcess.vintageStrength : 0.0f;
+    pc.step = _step;
     pc.width = static_cast<int>(width);
     pc.height = static_cast<int>(height);
     pc.frameCounter = static_cast<int>(_frameCounter);
     pc.bloom = _postProcess.bloom;
     pc.bloomThreshold = _postProcess.bloomThreshold;
     pc.bloomRadius = _postProcess.bloomRadius;
-    pc.pad0 = 0;
+    pc.stabilize = _stabilization.enabled ? 1 : 0;
+    pc.stabDx = _stabTransform.dx;
+    pc.stabDy = _stabTransform.dy;
+    pc.stabAngle = _stabTransform.angle;
+    pc.stabZoom = _stabTransform.zoom;
     
-    vkCmdPushConstants(cmd, _pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(EffectsPushConstants), &pc);
+    vkCmdPushConstants(cmd, _pipeline.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(EffectsPushConstants), &pc);
     
-    uint32_t groupCountX = (width + 15) / 16;
-    uint32_t groupCountY = (height + 15) / 16;
+    uint32_t step = static_cast<uint32_t>(_step);
+    uint32_t groupCountX = ((width + step - 1) / step + 15) / 16;
+    uint32_t groupCountY = ((height + step - 1) / step + 15) / 16;
     vkCmdDispatch(cmd, groupCountX, groupCountY, 1);
     
-    barriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barriers[0].oldLayout = VK_IMAGE_LAYOUT_GENERAL;
-    barriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barriers[0].image = texture->GetImage();
-    barriers[0].srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    
-    vkCmdPipelineBarrier(
-        cmd,
-        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-        0, 0, nullptr, 0, nullptr, 1, barriers
-    );
+    TransitionImage(cmd, texture->GetImage(),
+        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
     
     _context->EndSingleTimeCommands(cmd);
 }
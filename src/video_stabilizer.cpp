@@ -0,0 +1,308 @@
+#include "video_stabilizer.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TVK_MEDIA_STAB_SSE2 1
+#endif
+
+namespace tvk_media {
+
+static constexpr double TIMING_SMOOTHING = 0.1;
+
+static uint32_t BlockSad(const uint8_t* a, const uint8_t* b, int stride) {
+#if defined(TVK_MEDIA_STAB_SSE2)
+    __m128i acc = _mm_setzero_si128();
+    for (int y = 0; y < 16; y++) {
+        __m128i ra = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + y * stride));
+        __m128i rb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + y * stride));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(ra, rb));
+    }
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(acc) + _mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+#else
+    uint32_t sad = 0;
+    for (int y = 0; y < 16; y++) {
+        const uint8_t* ra = a + y * stride;
+        const uint8_t* rb = b + y * stride;
+        for (int x = 0; x < 16; x++) {
+            int d = static_cast<int>(ra[x]) - static_cast<int>(rb[x]);
+            sad += static_cast<uint32_t>(d < 0 ? -d : d);
+        }
+    }
+    return sad;
+#endif
+}
+
+static float SubpixelOffset(uint32_t left, uint32_t center, uint32_t right) {
+    float denom = static_cast<float>(left) - 2.0f * static_cast<float>(center) + static_cast<float>(right);
+    if (denom <= 0.0f) return 0.0f;
+    float offset = (static_cast<float>(left) - static_cast<float>(right)) / (2.0f * denom);
+    if (offset < -0.5f) offset = -0.5f;
+    if (offset > 0.5f) offset = 0.5f;
+    return offset;
+}
+
+struct MotionSample {
+    float x;
+    float y;
+    float mx;
+    float my;
+    bool inlier;
+};
+
+static bool FitSimilarity(const MotionSample* samples, int count, float& a, float& b, float& tx, float& ty) {
+    float px = 0.0f, py = 0.0f, qx = 0.0f, qy = 0.0f;
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        if (!samples[i].inlier) continue;
+        px += samples[i].x;
+        py += samples[i].y;
+        qx += samples[i].x + samples[i].mx;
+        qy += samples[i].y + samples[i].my;
+        n++;
+    }
+    if (n < 6) return false;
+    px /= n; py /= n; qx /= n; qy /= n;
+
+    float norm = 0.0f, sa = 0.0f, sb = 0.0f;
+    for (int i = 0; i < count; i++) {
+        if (!samples[i].inlier) continue;
+        float ux = samples[i].x - px;
+        float uy = samples[i].y - py;
+        float vx = samples[i].x + samples[i].mx - qx;
+        float vy = samples[i].y + samples[i].my - qy;
+        norm += ux * ux + uy * uy;
+        sa += ux * vx + uy * vy;
+        sb += ux * vy - uy * vx;
+    }
+    if (norm <= 0.0f) return false;
+    a = sa / norm;
+    b = sb / norm;
+    tx = qx - (a * px - b * py);
+    ty = qy - (b * px + a * py);
+    return true;
+}
+
+VideoStabilizer::VideoStabilizer()
+    : _current(0)
+    , _lumaWidth(0)
+    , _lumaHeight(0)
+    , _step(1)
+    , _sourceWidth(0)
+    , _sourceHeight(0)
+    , _hasPrevious(false)
+    , _trajectoryHead(0)
+    , _trajectoryCount(0)
+    , _analyzeSeconds(0.0)
+    , _peakAnalyzeSeconds(0.0)
+{
+    memset(_luma, 0, sizeof(_luma));
+}
+
+void VideoStabilizer::Reset() {
+    _hasPrevious = false;
+    _trajectoryHead = 0;
+    _trajectoryCount = 0;
+    _peakAnalyzeSeconds = 0.0;
+}
+
+void VideoStabilizer::DownscaleLuma(const VideoFrame& frame, uint8_t* dst) const {
+    const uint8_t* src = frame.data.data();
+    int stride = frame.width * 4;
+    int half = _step / 2;
+    for (int y = 0; y < _lumaHeight; y++) {
+        const uint8_t* row0 = src + (y * _step) * stride;
+        const uint8_t* row1 = src + (y * _step + half) * stride;
+        uint8_t* out = dst + y * _lumaWidth;
+        for (int x = 0; x < _lumaWidth; x++) {
+            int o0 = (x * _step) * 4;
+            int o1 = (x * _step + half) * 4;
+            uint32_t sum =
+                77u * (row0[o0] + row0[o1] + row1[o0] + row1[o1]) +
+                150u * (row0[o0 + 1] + row0[o1 + 1] + row1[o0 + 1] + row1[o1 + 1]) +
+                29u * (row0[o0 + 2] + row0[o1 + 2] + row1[o0 + 2] + row1[o1 + 2]);
+            out[x] = static_cast<uint8_t>(sum >> 10);
+        }
+    }
+}
+
+bool VideoStabilizer::EstimateMotion(float& dx, float& dy, float& angle) const {
+    const uint8_t* prev = _luma[_current ^ 1];
+    const uint8_t* cur = _luma[_current];
+    int stride = _lumaWidth;
+
+    int usableW = _lumaWidth - 2 * SEARCH - BLOCK;
+    int usableH = _lumaHeight - 2 * SEARCH - BLOCK;
+    if (usableW <= 0 || usableH <= 0) return false;
+
+    MotionSample samples[GRID_X * GRID_Y];
+    int count = 0;
+    uint32_t sads[SEARCH_SIZE * SEARCH_SIZE];
+
+    for (int gy = 0; gy < GRID_Y; gy++) {
+        for (int gx = 0; gx < GRID_X; gx++) {
+            int bx = SEARCH + usableW * gx / (GRID_X - 1);
+            int by = SEARCH + usableH * gy / (GRID_Y - 1);
+            const uint8_t* ref = prev + by * stride + bx;
+
+            uint8_t lo = 255, hi = 0;
+            for (int y = 0; y < BLOCK; y++) {
+                for (int x = 0; x < BLOCK; x++) {
+                    uint8_t v = ref[y * stride + x];
+                    if (v < lo) lo = v;
+                    if (v > hi) hi = v;
+                }
+            }
+            if (hi - lo < 16) continue;
+
+            uint32_t best = 0xFFFFFFFFu;
+            int bestX = 0, bestY = 0;
+            for (int sy = -SEARCH; sy <= SEARCH; sy++) {
+                for (int sx = -SEARCH; sx <= SEARCH; sx++) {
+                    uint32_t sad = BlockSad(ref, cur + (by + sy) * stride + bx + sx, stride);
+                    sads[(sy + SEARCH) * SEARCH_SIZE + sx + SEARCH] = sad;
+                    if (sad < best || (sad == best && sx * sx + sy * sy < bestX * bestX + bestY * bestY)) {
+                        best = sad;
+                        bestX = sx;
+                        bestY = sy;
+                    }
+                }
+            }
+
+            float fx = static_cast<float>(bestX);
+            float fy = static_cast<float>(bestY);
+            int cx = bestX + SEARCH;
+            int cy = bestY + SEARCH;
+            if (cx > 0 && cx < SEARCH_SIZE - 1) {
+                fx += SubpixelOffset(sads[cy * SEARCH_SIZE + cx - 1], best, sads[cy * SEARCH_SIZE + cx + 1]);
+            }
+            if (cy > 0 && cy < SEARCH_SIZE - 1) {
+                fy += SubpixelOffset(sads[(cy - 1) * SEARCH_SIZE + cx], best, sads[(cy + 1) * SEARCH_SIZE + cx]);
+            }
+
+            MotionSample& s = samples[count++];
+            s.x = static_cast<float>(bx + BLOCK / 2) - _lumaWidth * 0.5f;
+            s.y = static_cast<float>(by + BLOCK / 2) - _lumaHeight * 0.5f;
+            s.mx = fx;
+            s.my = fy;
+            s.inlier = true;
+        }
+    }
+
+    float a, b, tx, ty;
+    if (!FitSimilarity(samples, count, a, b, tx, ty)) return false;
+
+    for (int i = 0; i < count; i++) {
+        float ex = a * samples[i].x - b * samples[i].y + tx - samples[i].x - samples[i].mx;
+        float ey = b * samples[i].x + a * samples[i].y + ty - samples[i].y - samples[i].my;
+        samples[i].inlier = ex * ex + ey * ey < 1.0f;
+    }
+    if (!FitSimilarity(samples, count, a, b, tx, ty)) return false;
+
+    dx = tx * _step;
+    dy = ty * _step;
+    angle = atan2f(b, a);
+    return true;
+}
+
+void VideoStabilizer::Analyze(const VideoFrame& frame) {
+    if (frame.width <= 0 || frame.height <= 0 || frame.data.empty()) return;
+    auto start = std::chrono::steady_clock::now();
+
+    if (frame.width != _sourceWidth || frame.height != _sourceHeight) {
+        int stepX = (frame.width + LUMA_MAX_WIDTH - 1) / LUMA_MAX_WIDTH;
+        int stepY = (frame.height + LUMA_MAX_HEIGHT - 1) / LUMA_MAX_HEIGHT;
+        _step = stepX > stepY ? stepX : stepY;
+        if (_step < 1) _step = 1;
+        _lumaWidth = frame.width / _step;
+        _lumaHeight = frame.height / _step;
+        _sourceWidth = frame.width;
+        _sourceHeight = frame.height;
+        Reset();
+    }
+
+    _current ^= 1;
+    DownscaleLuma(frame, _luma[_current]);
+
+    TrajectoryPoint point{ frame.timestamp, 0.0f, 0.0f, 0.0f };
+    if (_hasPrevious && _trajectoryCount > 0) {
+        const TrajectoryPoint& last = PointAt(_trajectoryCount - 1);
+        point.x = last.x;
+        point.y = last.y;
+        point.angle = last.angle;
+        float dx, dy, angle;
+        if (EstimateMotion(dx, dy, angle)) {
+            point.x += dx;
+            point.y += dy;
+            point.angle += angle;
+        }
+    }
+    _hasPrevious = true;
+
+    _trajectory[_trajectoryHead] = point;
+    _trajectoryHead = (_trajectoryHead + 1) % HISTORY;
+    if (_trajectoryCount < HISTORY) _trajectoryCount++;
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    _analyzeSeconds = _analyzeSeconds > 0.0 ? _analyzeSeconds + (seconds - _analyzeSeconds) * TIMING_SMOOTHING : seconds;
+    if (seconds > _peakAnalyzeSeconds) _peakAnalyzeSeconds = seconds;
+}
+
+const VideoStabilizer::TrajectoryPoint& VideoStabilizer::PointAt(int index) const {
+    int start = (_trajectoryHead - _trajectoryCount + HISTORY) % HISTORY;
+    return _trajectory[(start + index) % HISTORY];
+}
+
+StabilizationTransform VideoStabilizer::Resolve(double timestamp, const StabilizationSettings& settings) const {
+    StabilizationTransform result;
+
+    int k = -1;
+    for (int i = _trajectoryCount - 1; i >= 0; i--) {
+        if (fabs(PointAt(i).timestamp - timestamp) < 1e-4) {
+            k = i;
+            break;
+        }
+    }
+    if (k < 0) return result;
+
+    int radius = settings.smoothingRadius;
+    if (radius < 1) radius = 1;
+    if (radius > MAX_RADIUS) radius = MAX_RADIUS;
+    float sigma = radius * 0.5f + 0.5f;
+    float inv2s2 = 1.0f / (2.0f * sigma * sigma);
+
+    float wsum = 0.0f, sx = 0.0f, sy = 0.0f, sa = 0.0f;
+    for (int j = -radius; j <= radius; j++) {
+        int idx = k + j;
+        if (idx < 0 || idx >= _trajectoryCount) continue;
+        const TrajectoryPoint& p = PointAt(idx);
+        float w = expf(-static_cast<float>(j * j) * inv2s2);
+        sx += p.x * w;
+        sy += p.y * w;
+        sa += p.angle * w;
+        wsum += w;
+    }
+
+    const TrajectoryPoint& p = PointAt(k);
+    float limit = settings.maxCorrection;
+    if (limit < 0.0f) limit = 0.0f;
+    if (limit > 0.2f) limit = 0.2f;
+    float maxX = limit * _sourceWidth;
+    float maxY = limit * _sourceHeight;
+
+    result.dx = sx / wsum - p.x;
+    result.dy = sy / wsum - p.y;
+    result.angle = sa / wsum - p.angle;
+    if (result.dx > maxX) result.dx = maxX;
+    if (result.dx < -maxX) result.dx = -maxX;
+    if (result.dy > maxY) result.dy = maxY;
+    if (result.dy < -maxY) result.dy = -maxY;
+    if (result.angle > limit) result.angle = limit;
+    if (result.angle < -limit) result.angle = -limit;
+    result.zoom = 1.0f / (1.0f - 2.0f * limit);
+    return result;
+}
+
+} // namespace tvk_media
@@ -0,0 +1,417 @@
+#include "video_upscaler.h"
+#include <tinyvk/renderer/renderer.h>
+#include <tinyvk/core/log.h>
+#include <algorithm>
+#include <utility>
+
+namespace tvk_media {
+
+static const char* g_easuComputeShader = R"(
+#version 450
+
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+layout(binding = 0, rgba8) readonly uniform image2D sourceImage;
+layout(binding = 1, rgba8) writeonly uniform image2D outputImage;
+
+layout(push_constant) uniform PushConstants {
+    int inputWidth;
+    int inputHeight;
+    int outputWidth;
+    int outputHeight;
+    
+    float sharpness;
+    int pad0;
+    int pad1;
+    int pad2;
+} pc;
+
+vec3 fetch(ivec2 p) {
+    return imageLoad(sourceImage, clamp(p, ivec2(0), ivec2(pc.inputWidth - 1, pc.inputHeight - 1))).rgb;
+}
+
+float luma(vec3 c) {
+    return c.b * 0.5 + (c.r * 0.5 + c.g);
+}
+
+void accumulate_direction(inout vec2 dir, inout float len, float w,
+                          float lA, float lB, float lC, float lD, float lE) {
+    float dc = lD - lC;
+    float cb = lC - lB;
+    float lenX = max(abs(dc), abs(cb));
+    lenX = lenX > 0.0 ? 1.0 / lenX : 0.0;
+    float dirX = lD - lB;
+    dir.x += dirX * w;
+    lenX = clamp(abs(dirX) * lenX, 0.0, 1.0);
+    lenX *= lenX;
+    len += lenX * w;
+    
+    float ec = lE - lC;
+    float ca = lC - lA;
+    float lenY = max(abs(ec), abs(ca));
+    lenY = lenY > 0.0 ? 1.0 / lenY : 0.0;
+    float dirY = lE - lA;
+    dir.y += dirY * w;
+    lenY = clamp(abs(dirY) * lenY, 0.0, 1.0);
+    lenY *= lenY;
+    len += lenY * w;
+}
+
+void accumulate_tap(inout vec3 aC, inout float aW, vec2 off, vec2 dir, vec2 len2,
+                    float lob, float clp, vec3 c) {
+    vec2 v = vec2(off.x * dir.x + off.y * dir.y, off.y * dir.x - off.x * dir.y);
+    v *= len2;
+    float d2 = min(dot(v, v), clp);
+    float wB = 0.4 * d2 - 1.0;
+    float wA = lob * d2 - 1.0;
+    wB *= wB;
+    wA *= wA;
+    wB = 1.5625 * wB - 0.5625;
+    float w = wB * wA;
+    aC += c * w;
+    aW += w;
+}
+
+void main() {
+    ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+    
+    if (coord.x >= pc.outputWidth || coord.y >= pc.outputHeight) {
+        return;
+    }
+    
+    vec2 scale = vec2(pc.inputWidth, pc.inputHeight) / vec2(pc.outputWidth, pc.outputHeight);
+    vec2 pp = (vec2(coord) + 0.5) * scale - 0.5;
+    vec2 fp = floor(pp);
+    pp -= fp;
+    ivec2 o = ivec2(fp);
+    
+    vec3 b = fetch(o + ivec2( 0, -1));
+    vec3 c = fetch(o + ivec2( 1, -1));
+    vec3 e = fetch(o + ivec2(-1,  0));
+    vec3 f = fetch(o + ivec2( 0,  0));
+    vec3 g = fetch(o + ivec2( 1,  0));
+    vec3 h = fetch(o + ivec2( 2,  0));
+    vec3 i = fetch(o + ivec2(-1,  1));
+    vec3 j = fetch(o + ivec2( 0,  1));
+    vec3 k = fetch(o + ivec2( 1,  1));
+    vec3 l = fetch(o + ivec2( 2,  1));
+    vec3 n = fetch(o + ivec2( 0,  2));
+    vec3 q = fetch(o + ivec2( 1,  2));
+    
+    float bL = luma(b), cL = luma(c), eL = luma(e), fL = luma(f);
+    float gL = luma(g), hL = luma(h), iL = luma(i), jL = luma(j);
+    float kL = luma(k), lL = luma(l), nL = luma(n), qL = luma(q);
+    
+    vec2 dir = vec2(0.0);
+    float len = 0.0;
+    accumulate_direction(dir, len, (1.0 - pp.x) * (1.0 - pp.y), bL, eL, fL, gL, jL);
+    accumulate_direction(dir, len, pp.x * (1.0 - pp.y), cL, fL, gL, hL, kL);
+    accumulate_direction(dir, len, (1.0 - pp.x) * pp.y, fL, iL, jL, kL, nL);
+    accumulate_direction(dir, len, pp.x * pp.y, gL, jL, kL, lL, qL);
+    
+    vec2 dir2 = dir * dir;
+    float dirR = dir2.x + dir2.y;
+    bool zro = dirR < 1.0 / 32768.0;
+    dirR = zro ? 1.0 : inversesqrt(dirR);
+    dir.x = zro ? 1.0 : dir.x;
+    dir *= dirR;
+    
+    len = len * 0.5;
+    len *= len;
+    float stretch = dot(dir, dir) / max(abs(dir.x), abs(dir.y));
+    vec2 len2 = vec2(1.0 + (stretch - 1.0) * len, 1.0 - 0.5 * len);
+    float lob = 0.5 + ((1.0 / 4.0 - 0.04) - 0.5) * len;
+    float clp = 1.0 / lob;
+    
+    vec3 aC = vec3(0.0);
+    float aW = 0.0;
+    accumulate_tap(aC, aW, vec2( 0.0, -1.0) - pp, dir, len2, lob, clp, b);
+    accumulate_tap(aC, aW, vec2( 1.0, -1.0) - pp, dir, len2, lob, clp, c);
+    accumulate_tap(aC, aW, vec2(-1.0,  1.0) - pp, dir, len2, lob, clp, i);
+    accumulate_tap(aC, aW, vec2( 0.0,  1.0) - pp, dir, len2, lob, clp, j);
+    accumulate_tap(aC, aW, vec2( 0.0,  0.0) - pp, dir, len2, lob, clp, f);
+    accumulate_tap(aC, aW, vec2(-1.0,  0.0) - pp, dir, len2, lob, clp, e);
+    accumulate_tap(aC, aW, vec2( 1.0,  1.0) - pp, dir, len2, lob, clp, k);
+    accumulate_tap(aC, aW, vec2( 2.0,  1.0) - pp, dir, len2, lob, clp, l);
+    accumulate_tap(aC, aW, vec2( 2.0,  0.0) - pp, dir, len2, lob, clp, h);
+    accumulate_tap(aC, aW, vec2( 1.0,  0.0) - pp, dir, len2, lob, clp, g);
+    accumulate_tap(aC, aW, vec2( 1.0,  2.0) - pp, dir, len2, lob, clp, q);
+    accumulate_tap(aC, aW, vec2( 0.0,  2.0) - pp, dir, len2, lob, clp, n);
+    
+    vec3 mn = min(min(f, g), min(j, k));
+    vec3 mx = max(max(f, g), max(j, k));
+    vec3 color = abs(aW) > 1e-5 ? aC / aW : f;
+    
+    imageStore(outputImage, coord, vec4(clamp(color, mn, mx), 1.0));
+}
+)";
+
+static const char* g_rcasComputeShader = R"(
+#version 450
+
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+layout(binding = 0, rgba8) readonly uniform image2D sourceImage;
+layout(binding = 1, rgba8) writeonly uniform image2D outputImage;
+
+layout(push_constant) uniform PushConstants {
+    int inputWidth;
+    int inputHeight;
+    int outputWidth;
+    int outputHeight;
+    
+    float sharpness;
+    int pad0;
+    int pad1;
+    int pad2;
+} pc;
+
+vec3 fetch(ivec2 p) {
+    return imageLoad(sourceImage, clamp(p, ivec2(0), ivec2(pc.outputWidth - 1, pc.outputHeight - 1))).rgb;
+}
+
+void main() {
+    ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+    
+    if (coord.x >= pc.outputWidth || coord.y >= pc.outputHeight) {
+        return;
+    }
+    
+    vec3 b = fetch(coord + ivec2( 0, -1));
+    vec3 d = fetch(coord + ivec2(-1,  0));
+    vec3 e = fetch(coord);
+    vec3 f = fetch(coord + ivec2( 1,  0));
+    vec3 h = fetch(coord + ivec2( 0,  1));
+    
+    vec3 mn4 = min(min(b, d), min(f, h));
+    vec3 mx4 = max(max(b, d), max(f, h));
+    
+    vec3 hitMin = min(mn4, e) / max(4.0 * mx4, vec3(1e-5));
+    vec3 hitMax = (1.0 - max(mx4, e)) / min(4.0 * mn4 - 4.0, vec3(-1e-5));
+    vec3 lobeRGB = max(-hitMin, hitMax);
+    float lobe = max(-0.1875, min(max(lobeRGB.r, max(lobeRGB.g, lobeRGB.b)), 0.0)) * exp2(-pc.sharpness);
+    
+    vec3 color = (lobe * (b + d + f + h) + e) / (4.0 * lobe + 1.0);
+    
+    imageStore(outputImage, coord, vec4(clamp(color, 0.0, 1.0), 1.0));
+}
+)";
+
+VideoUpscaler::VideoUpscaler()
+    : _renderer(nullptr)
+    , _context(nullptr)
+    , _easuSet(VK_NULL_HANDLE)
+    , _rcasSet(VK_NULL_HANDLE)
+    , _output(nullptr)
+    , _lastSourceView(VK_NULL_HANDLE)
+    , _lastSharpness(-1.0f)
+    , _active(false)
+    , _pipelinesReady(false)
+    , _pipelinesFailed(false)
+    , _initialized(false)
+{
+}
+
+VideoUpscaler::~VideoUpscaler() {
+    Cleanup();
+}
+
+bool VideoUpscaler::Init(tvk::Renderer* renderer) {
+    if (_initialized) return true;
+
+    _renderer = renderer;
+    _context = &renderer->GetContext();
+    _initialized = true;
+    return true;
+}
+
+bool VideoUpscaler::EnsurePipelines() {
+    if (_pipelinesReady) return true;
+    if (!_initialized || _pipelinesFailed) return false;
+
+    if (!CreateComputePipeline(_renderer, g_easuComputeShader, "video_upscale_easu", 2, 0,
+                               sizeof(UpscalePushConstants), _easu) ||
+        !CreateComputePipeline(_renderer, g_rcasComputeShader, "video_upscale_rcas", 2, 0,
+                               sizeof(UpscalePushConstants), _rcas)) {
+        TVK_LOG_ERROR("Failed to create compute pipelines for video upscaler");
+        _pipelinesFailed = true;
+        return false;
+    }
+
+    if (!AllocateDescriptorSet(_context, _easu, _easuSet) ||
+        !AllocateDescriptorSet(_context, _rcas, _rcasSet)) {
+        TVK_LOG_ERROR("Failed to allocate descriptor sets for video upscaler");
+        _pipelinesFailed = true;
+        return false;
+    }
+
+    _pipelinesReady = true;
+    TVK_LOG_INFO("Video upscaler GPU pipeline initialized");
+    return true;
+}
+
+void VideoUpscaler::Cleanup() {
+    if (!_context) return;
+
+    VkDevice device = _context->GetDevice();
+    if (!device) return;
+
+    vkDeviceWaitIdle(device);
+
+    ReleaseRetired(true);
+    _output.reset();
+    DestroyStorageImage(device, _intermediate);
+    DestroyComputePipeline(device, _easu);
+    DestroyComputePipeline(device, _rcas);
+
+    _lastSourceView = VK_NULL_HANDLE;
+    _active = false;
+    _pipelinesReady = false;
+    _pipelinesFailed = false;
+    _initialized = false;
+}
+
+bool VideoUpscaler::CreateOutput(uint32_t width, uint32_t height) {
+    if (_output && _output->GetWidth() == width && _output->GetHeight() == height) {
+        return true;
+    }
+
+    // Frames still in flight may sample the old output, so it is destroyed a few frames later
+    if (_output || _intermediate.image != VK_NULL_HANDLE) {
+        RetiredOutput retired;
+        retired.intermediate = _intermediate;
+        retired.output = std::move(_output);
+        _retired.push_back(std::move(retired));
+        _intermediate = StorageImage{};
+    }
+
+    if (!CreateStorageImage(_context, width, height, VK_IMAGE_USAGE_STORAGE_BIT, _intermediate)) {
+        return false;
+    }
+
+    tvk::TextureSpec spec;
+    spec.width = width;
+    spec.height = height;
+    spec.format = tvk::TextureFormat::RGBA8;
+    spec.generateMipmaps = false;
+    spec.storageUsage = true;
+
+    // No initial data: RCAS writes every pixel before the output is first sampled
+    _output = tvk::Texture::Create(_renderer, nullptr, width, height, spec);
+    if (!_output) return false;
+
+    CountTextureCreated();
+    _output->BindToImGui();
+    _lastSourceView = VK_NULL_HANDLE;
+    return true;
+}
+
+void VideoUpscaler::ReleaseRetired(bool all) {
+    VkDevice device = _context->GetDevice();
+    size_t kept = 0;
+    for (size_t i = 0; i < _retired.size(); i++) {
+        RetiredOutput& retired = _retired[i];
+        if (all || ++retired.frames > RETIRE_FRAMES) {
+            retired.output.reset();
+            DestroyStorageImage(device, retired.intermediate);
+        } else {
+            if (kept != i) _retired[kept] = std::move(retired);
+            kept++;
+        }
+    }
+    _retired.resize(kept);
+}
+
+bool VideoUpscaler::Process(tvk::Texture* source, uint32_t outputWidth, uint32_t outputHeight, bool sourceChanged) {
+    _active = false;
+    if (!_initialized) return false;
+    ReleaseRetired(false);
+    if (!source || !_settings.enabled) return false;
+
+    uint32_t inputWidth = source->GetWidth();
+    uint32_t inputHeight = source->GetHeight();
+    uint32_t largest = std::max(outputWidth, outputHeight);
+    if (largest > MAX_OUTPUT_SIZE) {
+        double scale = static_cast<double>(MAX_OUTPUT_SIZE) / largest;
+        outputWidth = std::max(1u, static_cast<uint32_t>(outputWidth * scale));
+        outputHeight = std::max(1u, static_cast<uint32_t>(outputHeight * scale));
+    }
+    if (outputWidth <= inputWidth && outputHeight <= inputHeight) return false;
+    if (!EnsurePipelines()) return false;
+
+    bool sizeChanged = !_output || _output->GetWidth() != outputWidth || _output->GetHeight() != outputHeight;
+    if (sizeChanged && !CreateOutput(outputWidth, outputHeight)) {
+        TVK_LOG_ERROR("Failed to create output images for video upscaler");
+        return false;
+    }
+
+    _active = true;
+    if (!sourceChanged && !sizeChanged && source->GetImageView() == _lastSourceView &&
+        _settings.sharpness == _lastSharpness) {
+        return true;
+    }
+
+    if (source->GetImageView() != _lastSourceView) {
+        VkImageView easuViews[2] = { source->GetImageView(), _intermediate.view };
+        VkImageView rcasViews[2] = { _intermediate.view, _output->GetImageView() };
+        WriteStorageImages(_context->GetDevice(), _easuSet, easuViews, 2);
+        WriteStorageImages(_context->GetDevice(), _rcasSet, rcasViews, 2);
+        _lastSourceView = source->GetImageView();
+    }
+    _lastSharpness = _settings.sharpness;
+
+    UpscalePushConstants pc{};
+    pc.inputWidth = static_cast<int>(inputWidth);
+    pc.inputHeight = static_cast<int>(inputHeight);
+    pc.outputWidth = static_cast<int>(outputWidth);
+    pc.outputHeight = static_cast<int>(outputHeight);
+    pc.sharpness = _settings.sharpness;
+
+    uint32_t groupCountX = (outputWidth + 15) / 16;
+    uint32_t groupCountY = (outputHeight + 15) / 16;
+
+    VkCommandBuffer cmd = _context->BeginSingleTimeCommands();
+
+    TransitionImage(cmd, source->GetImage(),
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL,
+        VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    TransitionImage(cmd, _intermediate.image,
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+        0, VK_ACCESS_SHADER_WRITE_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _easu.pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _easu.layout, 0, 1, &_easuSet, 0, nullptr);
+    vkCmdPushConstants(cmd, _easu.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(UpscalePushConstants), &pc);
+    vkCmdDispatch(cmd, groupCountX, groupCountY, 1);
+
+    TransitionImage(cmd, _intermediate.image,
+        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL,
+        VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    TransitionImage(cmd, _output->GetImage(),
+        sizeChanged ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL,
+        VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _rcas.pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _rcas.layout, 0, 1, &_rcasSet, 0, nullptr);
+    vkCmdPushConstants(cmd, _rcas.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(UpscalePushConstants), &pc);
+    vkCmdDispatch(cmd, groupCountX, groupCountY, 1);
+
+    TransitionImage(cmd, _output->GetImage(),
+        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+    TransitionImage(cmd, source->GetImage(),
+        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+    _context->EndSingleTimeCommands(cmd);
+    return true;
+}
+
+} // namespace tvk_media
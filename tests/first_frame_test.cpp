@@ -0,0 +1,42 @@
+/**
+ * @file first_frame_test.cpp
+ * @brief Headless check that opening a clip and decoding its first frame fits the first-frame budget
+ */
+
+#include "startup_profiler.h"
+#include "sync_benchmark.h"
+#include "video_decoder.h"
+#include <tinyvk/core/log.h>
+#include <cstdlib>
+#include <filesystem>
+
+using namespace tvk_media;
+
+int main() {
+    std::string path = (std::filesystem::temp_directory_path() / "tvk-first-frame-test.nut").string();
+    if (!SyncBenchmark::GenerateMedia(path, 0.0f, true)) return EXIT_FAILURE;
+
+    StartupProfiler profiler("Time to first frame (headless)", StartupProfiler::FIRST_FRAME_BUDGET);
+    VideoDecoder decoder;
+    VideoFrame frame;
+
+    profiler.Start();
+    bool decoded = decoder.Open(path);
+    profiler.Mark("Open video decoder");
+    if (decoded) {
+        frame.data.reserve(static_cast<size_t>(decoder.GetWidth()) * decoder.GetHeight() * 4);
+        profiler.Mark("Frame pool");
+        decoded = decoder.DecodeNextFrame(frame);
+        profiler.Mark("Decode first frame");
+    }
+    profiler.Finish();
+
+    decoder.Close();
+    std::filesystem::remove(path);
+
+    if (!decoded) {
+        TVK_LOG_ERROR("Could not decode the first frame of {}", path);
+        return EXIT_FAILURE;
+    }
+    return profiler.IsOverBudget() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
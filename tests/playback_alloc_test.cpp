@@ -0,0 +1,87 @@
+/**
+ * @file playback_alloc_test.cpp
+ * @brief Headless check that steady-state decode and frame queueing make no heap allocations
+ */
+
+#include "alloc_tracker.h"
+#include "frame_queue.h"
+#include "sync_benchmark.h"
+#include "video_decoder.h"
+#include <tinyvk/core/log.h>
+#include <cstdlib>
+#include <filesystem>
+
+using namespace tvk_media;
+
+static constexpr int WARMUP_FRAMES = 30;
+static constexpr int PLAY_FRAMES = 300;
+static constexpr int QUEUE_CAPACITY = 4;
+static constexpr size_t CACHE_BUDGET = 64ull << 20;
+
+int main() {
+    if (!AllocTracker::ENABLED) {
+        TVK_LOG_ERROR("Allocation test built without TVK_MEDIA_TRACK_ALLOCATIONS");
+        return EXIT_FAILURE;
+    }
+
+    std::string path = (std::filesystem::temp_directory_path() / "tvk-playback-alloc-test.nut").string();
+    if (!SyncBenchmark::GenerateMedia(path, 0.0f, true)) return EXIT_FAILURE;
+
+    VideoDecoder decoder;
+    decoder.SetCacheBudget(CACHE_BUDGET);
+    if (!decoder.Open(path)) {
+        TVK_LOG_ERROR("Could not open {}", path);
+        return EXIT_FAILURE;
+    }
+
+    FrameQueue queue;
+    queue.SetCapacity(QUEUE_CAPACITY);
+    VideoFrame current;
+    size_t frameBytes = static_cast<size_t>(decoder.GetWidth()) * decoder.GetHeight() * 4;
+    for (int i = 0; i < QUEUE_CAPACITY; i++) {
+        queue.GetSlot(i).data.reserve(frameBytes);
+    }
+    current.data.reserve(frameBytes);
+
+    AllocStats baseline;
+    int presented = 0;
+    int violations = 0;
+    bool eof = false;
+    while (presented < PLAY_FRAMES && !(eof && queue.IsEmpty())) {
+        {
+            ScopedAllocStage stage(AllocStage::Decode);
+            while (!eof && !queue.IsFull() && decoder.HasFrameReady()) {
+                if (!decoder.DecodeNextFrame(queue.Back())) {
+                    eof = true;
+                    break;
+                }
+                queue.Push();
+            }
+        }
+        if (queue.IsEmpty()) continue;
+        queue.PopInto(current);
+        presented++;
+
+        AllocStats stats = AllocTracker::GetPlaybackStats();
+        if (presented > WARMUP_FRAMES && stats.count != baseline.count) {
+            violations++;
+            TVK_LOG_ERROR("Frame at {:.3f}s made {} heap allocation(s), {} bytes", current.timestamp,
+                          stats.count - baseline.count, stats.bytes - baseline.bytes);
+        }
+        baseline = stats;
+    }
+
+    decoder.Close();
+    std::filesystem::remove(path);
+
+    if (presented <= WARMUP_FRAMES) {
+        TVK_LOG_ERROR("Only {} frames decoded", presented);
+        return EXIT_FAILURE;
+    }
+    if (violations > 0) {
+        TVK_LOG_ERROR("{} of {} steady-state frames allocated", violations, presented - WARMUP_FRAMES);
+        return EXIT_FAILURE;
+    }
+    TVK_LOG_INFO("{} frames after {} warmup frames made no heap allocations", presented - WARMUP_FRAMES, WARMUP_FRAMES);
+    return EXIT_SUCCESS;
+}